@@ -0,0 +1,142 @@
+/*******************************************************************************
+** Copyright 2025-present HMS Industrial Networks AB.
+** Licensed under the MIT License.
+********************************************************************************
+** File Description:
+** Per-cycle cost of the multi-axis ramp engine as the number of axes grows.
+**
+** The vectorized and the scalar update are run on identical data. New
+** reference speeds are written every 64 cycles so that the axes keep ramping
+** instead of settling. The results of both implementations are compared and
+** the program fails if they differ.
+**
+** Usage:
+**    axis_engine_benchmark [number of cycles per axis count]
+********************************************************************************
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "abcc_types.h"
+#include "appl_axis_engine.h"
+#include "host_time.h"
+
+#define BENCH_MAX_AXES                             ( 1024 )
+#define BENCH_DEFAULT_CYCLES                       ( 20000 )
+#define BENCH_REF_UPDATE_INTERVAL                  ( 64 )
+
+typedef struct bench_AxisDataType
+{
+   UINT16 aiSpeed[ BENCH_MAX_AXES ];
+   UINT16 aiRefSpeed[ BENCH_MAX_AXES ];
+   UINT16 aiMinSpeed[ BENCH_MAX_AXES ];
+   UINT16 aiMaxSpeed[ BENCH_MAX_AXES ];
+}
+bench_AxisDataType;
+
+static bench_AxisDataType bench_sVector;
+static bench_AxisDataType bench_sScalar;
+
+static void InitData( bench_AxisDataType* psData, APPL_AXIS_EngineType* psEngine, UINT16 iNumAxes )
+{
+   UINT16 i;
+
+   for( i = 0; i < BENCH_MAX_AXES; i++ )
+   {
+      psData->aiSpeed[ i ] = 0;
+      psData->aiRefSpeed[ i ] = 0;
+      psData->aiMinSpeed[ i ] = (UINT16)( ( i % 7 ) * 10 );
+      psData->aiMaxSpeed[ i ] = (UINT16)( 60000 - ( i % 5 ) * 1000 );
+   }
+
+   psEngine->paiSpeed = psData->aiSpeed;
+   psEngine->paiRefSpeed = psData->aiRefSpeed;
+   psEngine->paiMinSpeed = psData->aiMinSpeed;
+   psEngine->paiMaxSpeed = psData->aiMaxSpeed;
+   psEngine->iNumAxes = iNumAxes;
+   psEngine->iRampStep = 25;
+}
+
+static void SetReferences( bench_AxisDataType* psData, UINT16 iNumAxes, UINT32 lCycle )
+{
+   UINT16 i;
+
+   for( i = 0; i < iNumAxes; i++ )
+   {
+      psData->aiRefSpeed[ i ] = (UINT16)( ( ( lCycle + i ) * 40503UL ) & 0xFFFF );
+   }
+}
+
+static UINT64 RunCycles( bench_AxisDataType* psData,
+                         APPL_AXIS_EngineType* psEngine,
+                         void (*pnUpdate)( const APPL_AXIS_EngineType* ),
+                         UINT32 lNumCycles )
+{
+   UINT64 llTotalNs = 0;
+   UINT64 llStartNs;
+   UINT32 lCycle;
+
+   for( lCycle = 0; lCycle < lNumCycles; lCycle++ )
+   {
+      if( ( lCycle % BENCH_REF_UPDATE_INTERVAL ) == 0 )
+      {
+         SetReferences( psData, psEngine->iNumAxes, lCycle );
+      }
+
+      llStartNs = HOST_TIME_GetNs();
+      pnUpdate( psEngine );
+      llTotalNs += HOST_TIME_GetNs() - llStartNs;
+   }
+   return( llTotalNs );
+}
+
+int main( int argc, char* argv[] )
+{
+   APPL_AXIS_EngineType sVectorEngine;
+   APPL_AXIS_EngineType sScalarEngine;
+   UINT32 lNumCycles = BENCH_DEFAULT_CYCLES;
+   UINT64 llVectorNs;
+   UINT64 llScalarNs;
+   UINT16 iNumAxes;
+   int    iResult = 0;
+
+   if( argc > 1 )
+   {
+      lNumCycles = (UINT32)strtoul( argv[ 1 ], NULL, 0 );
+   }
+   if( lNumCycles == 0 )
+   {
+      printf( "Usage: %s [number of cycles per axis count]\n", argv[ 0 ] );
+      return( 1 );
+   }
+
+   HOST_TIME_Init();
+
+   printf( "%lu cycles per axis count\n\n", (unsigned long)lNumCycles );
+   printf( " axes  scalar ns/cycle  vector ns/cycle  vector ns/axis  speedup\n" );
+   for( iNumAxes = 1; iNumAxes <= BENCH_MAX_AXES; iNumAxes *= 2 )
+   {
+      InitData( &bench_sScalar, &sScalarEngine, iNumAxes );
+      InitData( &bench_sVector, &sVectorEngine, iNumAxes );
+
+      llScalarNs = RunCycles( &bench_sScalar, &sScalarEngine, APPL_AXIS_UpdateScalar, lNumCycles );
+      llVectorNs = RunCycles( &bench_sVector, &sVectorEngine, APPL_AXIS_Update, lNumCycles );
+
+      printf( "%5u  %15.1f  %15.1f  %14.2f  %6.1fx\n",
+              iNumAxes,
+              (double)llScalarNs / lNumCycles,
+              (double)llVectorNs / lNumCycles,
+              (double)llVectorNs / lNumCycles / iNumAxes,
+              (double)llScalarNs / (double)( llVectorNs ? llVectorNs : 1 ) );
+
+      if( memcmp( bench_sScalar.aiSpeed, bench_sVector.aiSpeed, iNumAxes * sizeof( UINT16 ) ) != 0 )
+      {
+         printf( "ERROR: vector and scalar results differ for %u axes\n", iNumAxes );
+         iResult = 1;
+      }
+   }
+
+   return( iResult );
+}
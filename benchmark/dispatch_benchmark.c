@@ -0,0 +1,290 @@
+/*******************************************************************************
+** Copyright 2025-present HMS Industrial Networks AB.
+** Licensed under the MIT License.
+********************************************************************************
+** File Description:
+** Explicit message handling latency versus command response list size.
+**
+** Each simulated request looks up its object/instance/attribute and calls the
+** handler, which packs a small response. A linear search over the list, as
+** done for ABCC_API_COMMAND_RESPONSE_LIST, is compared with the perfect hash
+** dispatch table in host_dispatch.c.
+**
+** Every list size is run with a regular key set, laid out like a large host
+** configuration, and with an irregular one of random object/instance/attribute
+** keys. Before timing, the table is built for BENCH_NUM_KEY_SETS further random
+** key sets per size and every key is looked up, to check that the build never
+** fails and that each key finds its own entry.
+**
+** Usage:
+**    dispatch_benchmark [number of requests per list size]
+********************************************************************************
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "abcc_types.h"
+#include "host_dispatch.h"
+#include "host_time.h"
+
+#define BENCH_MAX_ENTRIES                          ( 1024 )
+#define BENCH_DEFAULT_REQUESTS                     ( 1000000 )
+#define BENCH_NUM_KEY_SETS                         ( 100 )
+
+typedef UINT16 (*bench_HandlerType)( UINT8* pbResponse, UINT16 iValue );
+
+static HOST_DISPATCH_EntryType bench_asEntries[ BENCH_MAX_ENTRIES ];
+static UINT16 bench_aiSlots[ HOST_DISPATCH_NUM_SLOTS( BENCH_MAX_ENTRIES ) ];
+static UINT16 bench_aiRequests[ 4096 ];
+static UINT8  bench_abResponse[ 16 ];
+static volatile UINT32 bench_lSink;
+static UINT32 bench_lRandom = 0x12345678UL;
+
+static UINT32 NextRandom( void )
+{
+   bench_lRandom ^= bench_lRandom << 13;
+   bench_lRandom ^= bench_lRandom >> 17;
+   bench_lRandom ^= bench_lRandom << 5;
+   return( bench_lRandom );
+}
+
+static UINT16 PackUint16( UINT8* pbResponse, UINT16 iValue )
+{
+   pbResponse[ 0 ] = (UINT8)iValue;
+   pbResponse[ 1 ] = (UINT8)( iValue >> 8 );
+   return( 2 );
+}
+
+/*------------------------------------------------------------------------------
+** Regular key set: spreads entries over the host object range (0xF0-0xFF) the
+** way a large configuration does, a handful of instances per object and a run
+** of attributes per instance.
+** Irregular key set: random objects, instances and attributes, duplicates
+** drawn again.
+**------------------------------------------------------------------------------
+*/
+static void BuildEntries( UINT16 iNumEntries, BOOL fIrregular )
+{
+   UINT32 lRandom;
+   UINT16 i;
+   UINT16 j;
+
+   for( i = 0; i < iNumEntries; i++ )
+   {
+      if( fIrregular )
+      {
+         lRandom = NextRandom();
+         bench_asEntries[ i ].bObject = (UINT8)( lRandom >> 24 );
+         bench_asEntries[ i ].iInstance = (UINT16)( lRandom >> 8 );
+         bench_asEntries[ i ].bAttribute = (UINT8)lRandom;
+
+         for( j = 0; j < i; j++ )
+         {
+            if( ( bench_asEntries[ j ].bObject == bench_asEntries[ i ].bObject ) &&
+                ( bench_asEntries[ j ].iInstance == bench_asEntries[ i ].iInstance ) &&
+                ( bench_asEntries[ j ].bAttribute == bench_asEntries[ i ].bAttribute ) )
+            {
+               break;
+            }
+         }
+         if( j < i )
+         {
+            i--;
+            continue;
+         }
+      }
+      else
+      {
+         bench_asEntries[ i ].bObject = (UINT8)( 0xFF - ( i / 64 ) );
+         bench_asEntries[ i ].iInstance = (UINT16)( ( i / 16 ) % 4 );
+         bench_asEntries[ i ].bAttribute = (UINT8)( 1 + ( i % 16 ) );
+      }
+      bench_asEntries[ i ].pxContext = NULL;
+      bench_asEntries[ i ].pnHandler = (HOST_DISPATCH_FuncType)PackUint16;
+   }
+}
+
+/*------------------------------------------------------------------------------
+** Builds the table and looks up every key. Returns FALSE if the build fails
+** or a key does not find its own entry.
+**------------------------------------------------------------------------------
+*/
+static BOOL BuildAndVerify( HOST_DISPATCH_Type* psTable, UINT16 iNumEntries )
+{
+   UINT16 i;
+
+   if( !HOST_DISPATCH_Build( psTable, bench_asEntries, iNumEntries,
+                             bench_aiSlots, (UINT16)( sizeof( bench_aiSlots ) / sizeof( bench_aiSlots[ 0 ] ) ) ) )
+   {
+      return( FALSE );
+   }
+
+   for( i = 0; i < iNumEntries; i++ )
+   {
+      if( HOST_DISPATCH_GetIndex( psTable,
+                                  bench_asEntries[ i ].bObject,
+                                  bench_asEntries[ i ].iInstance,
+                                  bench_asEntries[ i ].bAttribute ) != i )
+      {
+         return( FALSE );
+      }
+   }
+
+   return( TRUE );
+}
+
+static const HOST_DISPATCH_EntryType* LinearLookup( UINT16 iNumEntries,
+                                                    UINT8 bObject,
+                                                    UINT16 iInstance,
+                                                    UINT8 bAttribute )
+{
+   UINT16 i;
+
+   for( i = 0; i < iNumEntries; i++ )
+   {
+      if( ( bench_asEntries[ i ].bObject == bObject ) &&
+          ( bench_asEntries[ i ].iInstance == iInstance ) &&
+          ( bench_asEntries[ i ].bAttribute == bAttribute ) )
+      {
+         return( &bench_asEntries[ i ] );
+      }
+   }
+   return( NULL );
+}
+
+static void HandleEntry( const HOST_DISPATCH_EntryType* psEntry, UINT32 lRequest )
+{
+   bench_HandlerType pnHandler;
+
+   if( psEntry != NULL )
+   {
+      pnHandler = (bench_HandlerType)psEntry->pnHandler;
+      bench_lSink += pnHandler( bench_abResponse, (UINT16)lRequest );
+   }
+}
+
+/*------------------------------------------------------------------------------
+** Returns the number of random key sets of this size for which the build or a
+** lookup failed.
+**------------------------------------------------------------------------------
+*/
+static UINT16 CheckKeySets( UINT16 iNumEntries )
+{
+   HOST_DISPATCH_Type sTable;
+   UINT16             iFailures;
+   UINT16             i;
+
+   iFailures = 0;
+   for( i = 0; i < BENCH_NUM_KEY_SETS; i++ )
+   {
+      BuildEntries( iNumEntries, TRUE );
+      if( !BuildAndVerify( &sTable, iNumEntries ) )
+      {
+         iFailures++;
+      }
+   }
+
+   return( iFailures );
+}
+
+/*------------------------------------------------------------------------------
+** Times one list size and key set. Returns FALSE if the table could not be
+** built or verified.
+**------------------------------------------------------------------------------
+*/
+static BOOL RunListSize( UINT16 iNumEntries, BOOL fIrregular, UINT32 lNumRequests )
+{
+   HOST_DISPATCH_Type              sTable;
+   const HOST_DISPATCH_EntryType*  psReq;
+   UINT64                          llStartNs;
+   UINT64                          llLinearNs;
+   UINT64                          llHashNs;
+   UINT32                          i;
+
+   BuildEntries( iNumEntries, fIrregular );
+   if( !BuildAndVerify( &sTable, iNumEntries ) )
+   {
+      printf( "%7u  %-9s  table build failed\n", iNumEntries, fIrregular ? "irregular" : "regular" );
+      return( FALSE );
+   }
+
+   /*
+   ** A fixed pseudo random request pattern over all entries.
+   */
+   for( i = 0; i < sizeof( bench_aiRequests ) / sizeof( bench_aiRequests[ 0 ] ); i++ )
+   {
+      bench_aiRequests[ i ] = (UINT16)( ( i * 2654435761UL >> 7 ) % iNumEntries );
+   }
+
+   llStartNs = HOST_TIME_GetNs();
+   for( i = 0; i < lNumRequests; i++ )
+   {
+      psReq = &bench_asEntries[ bench_aiRequests[ i & 4095 ] ];
+      HandleEntry( LinearLookup( iNumEntries, psReq->bObject, psReq->iInstance, psReq->bAttribute ), i );
+   }
+   llLinearNs = HOST_TIME_GetNs() - llStartNs;
+
+   llStartNs = HOST_TIME_GetNs();
+   for( i = 0; i < lNumRequests; i++ )
+   {
+      psReq = &bench_asEntries[ bench_aiRequests[ i & 4095 ] ];
+      HandleEntry( HOST_DISPATCH_Lookup( &sTable, psReq->bObject, psReq->iInstance, psReq->bAttribute ), i );
+   }
+   llHashNs = HOST_TIME_GetNs() - llStartNs;
+
+   printf( "%7u  %-9s  %10.1f  %10.1f  %8.1fx\n",
+           iNumEntries,
+           fIrregular ? "irregular" : "regular",
+           (double)llLinearNs / lNumRequests,
+           (double)llHashNs / lNumRequests,
+           (double)llLinearNs / (double)( llHashNs ? llHashNs : 1 ) );
+
+   return( TRUE );
+}
+
+int main( int argc, char* argv[] )
+{
+   static const UINT16 aiSizes[] = { 8, 16, 32, 64, 128, 256, 512, 1024 };
+   UINT32 lNumRequests = BENCH_DEFAULT_REQUESTS;
+   UINT16 iFailures;
+   UINT16 i;
+   int    iResult = 0;
+
+   if( argc > 1 )
+   {
+      lNumRequests = (UINT32)strtoul( argv[ 1 ], NULL, 0 );
+   }
+   if( lNumRequests == 0 )
+   {
+      printf( "Usage: %s [number of requests per list size]\n", argv[ 0 ] );
+      return( 1 );
+   }
+
+   HOST_TIME_Init();
+
+   printf( "entries  random key sets failed\n" );
+   for( i = 0; i < sizeof( aiSizes ) / sizeof( aiSizes[ 0 ] ); i++ )
+   {
+      iFailures = CheckKeySets( aiSizes[ i ] );
+      printf( "%7u  %u/%u\n", aiSizes[ i ], iFailures, BENCH_NUM_KEY_SETS );
+      if( iFailures != 0 )
+      {
+         iResult = 1;
+      }
+   }
+
+   printf( "\n%lu requests per list size\n\n", (unsigned long)lNumRequests );
+   printf( "entries  keys        linear ns   table ns   speedup\n" );
+   for( i = 0; i < sizeof( aiSizes ) / sizeof( aiSizes[ 0 ] ); i++ )
+   {
+      if( !RunListSize( aiSizes[ i ], FALSE, lNumRequests ) ||
+          !RunListSize( aiSizes[ i ], TRUE, lNumRequests ) )
+      {
+         iResult = 1;
+      }
+   }
+
+   return( iResult );
+}
@@ -0,0 +1,468 @@
+/*******************************************************************************
+** Copyright 2025-present HMS Industrial Networks AB.
+** Licensed under the MIT License.
+********************************************************************************
+** File Description:
+** Per-call cost of the HAL functions with regression thresholds.
+**
+** The HAL is run unmodified against the stand-in Transport Provider router in
+** hal_stand_in_tp.c, which completes every call immediately. What is measured
+** is therefore the cost of the port layer itself: locking, fault injection
+** wrappers, read verification, process data capture hooks, statistics and
+** the router call, but not the USB round trip to a Starter Kit.
+**
+** Each case is run a number of times and the fastest run is reported, which
+** keeps scheduling noise out of the figures. With --baseline the results are
+** compared with a baseline file and the program exits with 2 if any case is
+** slower than its baseline plus the tolerance. --write-baseline records the
+** results as a new baseline.
+**
+** The baseline file has one "<case> <ns per call>" line per case. Lines
+** starting with '#' are comments. A case without a baseline is reported but
+** never fails.
+**
+** ser_send_receive is reported but never gated. Its response is collected by
+** the serial reader thread, which sleeps between polls, so the figure is
+** mostly that sleep and not the port layer.
+**
+** Usage:
+**    hal_benchmark [--baseline <file>] [--tolerance <percent>]
+**                  [--write-baseline <file>] [--scale <factor>]
+********************************************************************************
+*/
+
+#include <windows.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "abcc_config.h"
+#include "abcc_api.h"
+#include "abcc_software_port.h"
+#include "abcc_hardware_abstraction.h"
+#include "abcc_hardware_abstraction_spi.h"
+#include "abcc_hardware_abstraction_parallel.h"
+#include "abcc_hardware_abstraction_serial.h"
+#include "host_time.h"
+#include "host_pd_buffer.h"
+#include "appl_adi_table.h"
+#include "hal_stand_in_tp.h"
+
+#pragma comment( lib, "Winmm.lib" )
+
+extern void TP_Shutdown( void );
+extern void TP_vSetPathId( UINT32 lValue );
+
+#define BENCH_REPEATS                              ( 7 )
+#define BENCH_DEFAULT_TOLERANCE                    ( 25 )
+#define BENCH_MAX_BASELINES                        ( 32 )
+#define BENCH_FRAME_SIZE                           ( 64 )
+#define BENCH_SERIAL_FRAME_SIZE                    ( 19 )
+
+/*------------------------------------------------------------------------------
+** One benchmark case.
+**
+** pacName     - Name in the printout and the baseline file.
+** lPathId     - Stand-in path the case needs, 0 if it needs no transport.
+** pnRun       - Makes lNumCalls calls of the measured function.
+** lNumCalls   - Calls per run.
+** fGated      - FALSE if the case is only reported. It is then neither
+**               compared with nor written to a baseline.
+**------------------------------------------------------------------------------
+*/
+typedef struct bench_CaseType
+{
+   const char* pacName;
+   UINT32      lPathId;
+   void        (*pnRun)( UINT32 lNumCalls );
+   UINT32      lNumCalls;
+   BOOL8       fGated;
+}
+bench_CaseType;
+
+typedef struct bench_BaselineType
+{
+   char   acName[ 64 ];
+   double rNsPerCall;
+}
+bench_BaselineType;
+
+static UINT8              bench_abTx[ BENCH_FRAME_SIZE ];
+static UINT8              bench_abRx[ BENCH_FRAME_SIZE ];
+static volatile UINT32    bench_lSink;
+
+static bench_BaselineType bench_asBaselines[ BENCH_MAX_BASELINES ];
+static UINT16             bench_iNumBaselines = 0;
+
+#if( ABCC_CFG_DRV_PARALLEL_ENABLED && !ABCC_CFG_MEMORY_MAPPED_ACCESS_ENABLED )
+static void RunParallelRead16( UINT32 lNumCalls )
+{
+   UINT32 i;
+
+   for( i = 0; i < lNumCalls; i++ )
+   {
+      bench_lSink += ABCC_HAL_ParallelRead16( 0x3FFE );
+   }
+}
+
+static void RunParallelWrite( UINT32 lNumCalls )
+{
+   void*  pxPd;
+   UINT32 i;
+
+   /*
+   ** Write the mapped image from the process data buffer so that the capture
+   ** hook is on the measured path, as it is for the real process data writes.
+   */
+   pxPd = ABCC_HAL_ParallelGetWrPdBuffer();
+   for( i = 0; i < lNumCalls; i++ )
+   {
+      ABCC_HAL_ParallelWrite( 0x0000, pxPd, HOST_PD_BUFFER_WriteSize() );
+   }
+}
+#endif
+
+#if( ABCC_CFG_DRV_SPI_ENABLED )
+static void RunSpiSendReceive( UINT32 lNumCalls )
+{
+   UINT32 i;
+
+   for( i = 0; i < lNumCalls; i++ )
+   {
+      ABCC_HAL_SpiSendReceive( bench_abTx, bench_abRx, BENCH_FRAME_SIZE );
+   }
+}
+#endif
+
+#if( ABCC_CFG_DRV_SERIAL_ENABLED )
+static void RunSerSendReceive( UINT32 lNumCalls )
+{
+   UINT32 i;
+
+   /*
+   ** The stand-in loops the frame back, so the response is as long as the
+   ** request.
+   */
+   for( i = 0; i < lNumCalls; i++ )
+   {
+      ABCC_HAL_SerSendReceive( bench_abTx, bench_abRx, BENCH_SERIAL_FRAME_SIZE, BENCH_SERIAL_FRAME_SIZE );
+   }
+}
+#endif
+
+#if( ABCC_CFG_POLL_ABCC_IRQ_PIN_ENABLED )
+static void RunTpCommand( UINT32 lNumCalls )
+{
+   UINT32 i;
+
+   /*
+   ** IRQ pin polling is one provider specific command.
+   */
+   for( i = 0; i < lNumCalls; i++ )
+   {
+      bench_lSink += ABCC_HAL_IsAbccInterruptActive();
+   }
+}
+#endif
+
+static void RunCriticalSection( UINT32 lNumCalls )
+{
+   UINT32 i;
+
+   ABCC_PORT_UseCritical();
+   for( i = 0; i < lNumCalls; i++ )
+   {
+      ABCC_PORT_EnterCritical();
+      bench_lSink++;
+      ABCC_PORT_ExitCritical();
+   }
+}
+
+static const bench_CaseType bench_asCases[] =
+{
+#if( ABCC_CFG_DRV_PARALLEL_ENABLED && !ABCC_CFG_MEMORY_MAPPED_ACCESS_ENABLED )
+   { "parallel_read16",  HAL_STAND_IN_PATH_PARALLEL, RunParallelRead16,  200000, TRUE },
+   { "parallel_write",   HAL_STAND_IN_PATH_PARALLEL, RunParallelWrite,   200000, TRUE },
+#endif
+#if( ABCC_CFG_POLL_ABCC_IRQ_PIN_ENABLED )
+   { "tp_command",       HAL_STAND_IN_PATH_PARALLEL, RunTpCommand,       200000, TRUE },
+#endif
+#if( ABCC_CFG_DRV_SPI_ENABLED )
+   { "spi_send_receive", HAL_STAND_IN_PATH_SPI,      RunSpiSendReceive,  200000, TRUE },
+#endif
+#if( ABCC_CFG_DRV_SERIAL_ENABLED )
+   /*
+   ** The response is collected by the serial reader thread, which sleeps
+   ** between polls, so a call takes in the order of a millisecond. Reported
+   ** only, the figure is mostly that sleep.
+   */
+   { "ser_send_receive", HAL_STAND_IN_PATH_SERIAL,   RunSerSendReceive,  200,    FALSE },
+#endif
+   { "critical_section", 0,                          RunCriticalSection, 200000, TRUE },
+};
+
+#define BENCH_NUM_CASES ( sizeof( bench_asCases ) / sizeof( bench_asCases[ 0 ] ) )
+
+/*------------------------------------------------------------------------------
+** Not used by the benchmark, which never runs the driver, but required by
+** the driver library. The example defines it in main.c.
+**------------------------------------------------------------------------------
+*/
+void ABCC_API_CbfUserInit( ABCC_API_NetworkType iNetworkType, ABCC_API_FwVersionType iFirmwareVersion )
+{
+   (void)iNetworkType;
+   (void)iFirmwareVersion;
+}
+
+static BOOL LoadBaseline( const char* pacFile )
+{
+   FILE*  psFile;
+   char   acLine[ 256 ];
+   char   acName[ 64 ];
+   double rNs;
+
+   psFile = fopen( pacFile, "r" );
+   if( psFile == NULL )
+   {
+      printf( "Could not open baseline file %s\n", pacFile );
+      return( FALSE );
+   }
+
+   while( fgets( acLine, sizeof( acLine ), psFile ) != NULL )
+   {
+      if( ( acLine[ 0 ] == '#' ) || ( sscanf( acLine, "%63s %lf", acName, &rNs ) != 2 ) )
+      {
+         continue;
+      }
+      if( bench_iNumBaselines == BENCH_MAX_BASELINES )
+      {
+         printf( "Too many entries in %s\n", pacFile );
+         break;
+      }
+      strcpy( bench_asBaselines[ bench_iNumBaselines ].acName, acName );
+      bench_asBaselines[ bench_iNumBaselines ].rNsPerCall = rNs;
+      bench_iNumBaselines++;
+   }
+
+   fclose( psFile );
+   return( TRUE );
+}
+
+static const bench_BaselineType* FindBaseline( const char* pacName )
+{
+   UINT16 i;
+
+   for( i = 0; i < bench_iNumBaselines; i++ )
+   {
+      if( strcmp( bench_asBaselines[ i ].acName, pacName ) == 0 )
+      {
+         return( &bench_asBaselines[ i ] );
+      }
+   }
+   return( NULL );
+}
+
+static BOOL WriteBaseline( const char* pacFile, const double* prNsPerCall )
+{
+   FILE*  psFile;
+   UINT16 i;
+
+   psFile = fopen( pacFile, "w" );
+   if( psFile == NULL )
+   {
+      printf( "Could not create baseline file %s\n", pacFile );
+      return( FALSE );
+   }
+
+   fprintf( psFile, "# hal_benchmark baseline, ns per call.\n" );
+   for( i = 0; i < BENCH_NUM_CASES; i++ )
+   {
+      if( bench_asCases[ i ].fGated )
+      {
+         fprintf( psFile, "%-20s %.1f\n", bench_asCases[ i ].pacName, prNsPerCall[ i ] );
+      }
+   }
+
+   fclose( psFile );
+   return( TRUE );
+}
+
+/*------------------------------------------------------------------------------
+** Opens the stand-in path a case needs, closing the previous one if it is a
+** different path.
+**------------------------------------------------------------------------------
+*/
+static BOOL SelectPath( UINT32 lPathId )
+{
+   static UINT32 lOpenPathId = 0;
+
+   if( ( lPathId == 0 ) || ( lPathId == lOpenPathId ) )
+   {
+      return( TRUE );
+   }
+
+   if( lOpenPathId != 0 )
+   {
+      TP_Shutdown();
+      lOpenPathId = 0;
+   }
+
+   TP_vSetPathId( lPathId );
+   if( !ABCC_HAL_HwInit() )
+   {
+      printf( "Could not open stand-in path %lu. Is HMSTPRTR.DLL the stand-in?\n", (unsigned long)lPathId );
+      return( FALSE );
+   }
+   lOpenPathId = lPathId;
+   return( TRUE );
+}
+
+static double RunCase( const bench_CaseType* psCase, UINT32 lScale )
+{
+   UINT64 llStartNs;
+   UINT64 llNs;
+   UINT64 llBestNs = 0;
+   UINT32 lNumCalls;
+   UINT16 i;
+
+   lNumCalls = psCase->lNumCalls * lScale;
+
+   /*
+   ** One untimed run to warm up caches and let the serial reader get going.
+   */
+   psCase->pnRun( lNumCalls / 10 + 1 );
+
+   for( i = 0; i < BENCH_REPEATS; i++ )
+   {
+      llStartNs = HOST_TIME_GetNs();
+      psCase->pnRun( lNumCalls );
+      llNs = HOST_TIME_GetNs() - llStartNs;
+      if( ( i == 0 ) || ( llNs < llBestNs ) )
+      {
+         llBestNs = llNs;
+      }
+   }
+
+   return( (double)llBestNs / lNumCalls );
+}
+
+int main( int argc, char* argv[] )
+{
+   const bench_BaselineType* psBaseline;
+   const char* pacBaselineFile = NULL;
+   const char* pacWriteFile = NULL;
+   double      arNsPerCall[ BENCH_NUM_CASES ];
+   double      rLimit;
+   UINT32      lTolerance = BENCH_DEFAULT_TOLERANCE;
+   UINT32      lScale = 1;
+   UINT16      iNumRegressions = 0;
+   UINT16      i;
+   int         iArg;
+
+   for( iArg = 1; iArg < argc; iArg++ )
+   {
+      if( ( strcmp( argv[ iArg ], "--baseline" ) == 0 ) && ( iArg + 1 < argc ) )
+      {
+         pacBaselineFile = argv[ ++iArg ];
+      }
+      else if( ( strcmp( argv[ iArg ], "--write-baseline" ) == 0 ) && ( iArg + 1 < argc ) )
+      {
+         pacWriteFile = argv[ ++iArg ];
+      }
+      else if( ( strcmp( argv[ iArg ], "--tolerance" ) == 0 ) && ( iArg + 1 < argc ) )
+      {
+         lTolerance = (UINT32)strtoul( argv[ ++iArg ], NULL, 0 );
+      }
+      else if( ( strcmp( argv[ iArg ], "--scale" ) == 0 ) && ( iArg + 1 < argc ) )
+      {
+         lScale = (UINT32)strtoul( argv[ ++iArg ], NULL, 0 );
+      }
+      else
+      {
+         lScale = 0;
+         break;
+      }
+   }
+   if( lScale == 0 )
+   {
+      printf( "Usage: %s [--baseline <file>] [--tolerance <percent>]\n"
+              "       [--write-baseline <file>] [--scale <factor>]\n",
+              argv[ 0 ] );
+      return( 1 );
+   }
+
+   if( ( pacBaselineFile != NULL ) && !LoadBaseline( pacBaselineFile ) )
+   {
+      return( 1 );
+   }
+
+   HOST_TIME_Init();
+
+   /*
+   ** The example's own process data sizes, so that ParallelWrite moves the
+   ** same image as in the example.
+   */
+   if( !HOST_PD_BUFFER_Init( APPL_ADI_iReadPdSize, APPL_ADI_iWritePdSize ) )
+   {
+      return( 1 );
+   }
+
+   /*
+   ** The serial reader thread sleeps between polls, give it the same timer
+   ** resolution as the example has.
+   */
+   timeBeginPeriod( 1 );
+
+   printf( "best of %u runs, tolerance %lu%%\n\n", (unsigned)BENCH_REPEATS, (unsigned long)lTolerance );
+   printf( "case                 ns/call    baseline       limit  result\n" );
+   for( i = 0; i < BENCH_NUM_CASES; i++ )
+   {
+      if( !SelectPath( bench_asCases[ i ].lPathId ) )
+      {
+         timeEndPeriod( 1 );
+         return( 1 );
+      }
+
+      arNsPerCall[ i ] = RunCase( &bench_asCases[ i ], lScale );
+      printf( "%-16s %11.1f", bench_asCases[ i ].pacName, arNsPerCall[ i ] );
+
+      if( !bench_asCases[ i ].fGated )
+      {
+         printf( "           -           -  not gated\n" );
+         continue;
+      }
+
+      psBaseline = FindBaseline( bench_asCases[ i ].pacName );
+      if( psBaseline == NULL )
+      {
+         printf( "           -           -  %s\n", ( pacBaselineFile != NULL ) ? "no baseline" : "" );
+         continue;
+      }
+
+      rLimit = psBaseline->rNsPerCall * ( 100 + lTolerance ) / 100.0;
+      if( arNsPerCall[ i ] > rLimit )
+      {
+         iNumRegressions++;
+      }
+      printf( " %11.1f %11.1f  %s\n",
+              psBaseline->rNsPerCall,
+              rLimit,
+              ( arNsPerCall[ i ] > rLimit ) ? "REGRESSION" : "ok" );
+   }
+
+   TP_Shutdown();
+   timeEndPeriod( 1 );
+
+   if( ( pacWriteFile != NULL ) && !WriteBaseline( pacWriteFile, arNsPerCall ) )
+   {
+      return( 1 );
+   }
+
+   if( iNumRegressions > 0 )
+   {
+      printf( "\n%u case(s) slower than the baseline\n", iNumRegressions );
+      return( 2 );
+   }
+
+   return( 0 );
+}
@@ -0,0 +1,363 @@
+/*******************************************************************************
+** Copyright 2025-present HMS Industrial Networks AB.
+** Licensed under the MIT License.
+********************************************************************************
+** File Description:
+** Stand-in Transport Provider router for hal_benchmark.
+**
+** Built as HMSTPRTR.DLL and placed next to hal_benchmark, so that imp_tp.c
+** loads it exactly like the real router and the HAL runs its production code
+** path. There is no hardware behind it, every call completes immediately:
+**
+**    Parallel - Reads and writes a 16 kB memory window.
+**    SPI      - Returns the MOSI data as MISO data.
+**    Serial   - Loops the written bytes back to the receive side.
+**
+** The path is picked with the path ID: HAL_STAND_IN_PATH_PARALLEL,
+** HAL_STAND_IN_PATH_SPI or HAL_STAND_IN_PATH_SERIAL. Provider specific
+** commands answer as a USB2 board with the IRQ line inactive and a 16-bit
+** parallel module present.
+********************************************************************************
+*/
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <string.h>
+
+#include "tp.h"
+#include "hal_stand_in_tp.h"
+
+#define STAND_IN_MEMORY_SIZE                       ( 16384 )
+#define STAND_IN_SERIAL_BUFFER_SIZE                ( 4096 )
+
+static UINT8            stand_in_abMemory[ STAND_IN_MEMORY_SIZE ];
+static UINT8            stand_in_abSerial[ STAND_IN_SERIAL_BUFFER_SIZE ];
+static UINT16           stand_in_iSerialHead = 0;
+static UINT16           stand_in_iSerialTail = 0;
+static TP_InterfaceType stand_in_eInterface = TP_PARALLEL;
+static BOOL             stand_in_fOpen = FALSE;
+static CRITICAL_SECTION stand_in_sSerialLock;
+
+/*
+** The path handle only has to be non-NULL.
+*/
+static int              stand_in_iPath;
+
+BOOL WINAPI DllMain( HINSTANCE hInstance, DWORD lReason, LPVOID pxReserved )
+{
+   (void)hInstance;
+   (void)pxReserved;
+
+   if( lReason == DLL_PROCESS_ATTACH )
+   {
+      InitializeCriticalSection( &stand_in_sSerialLock );
+   }
+   else if( lReason == DLL_PROCESS_DETACH )
+   {
+      DeleteCriticalSection( &stand_in_sSerialLock );
+   }
+   return( TRUE );
+}
+
+TP_StatusType WINAPI TP_SelectPath( TP_InterfaceType* peInterface, UINT32 lPathId, TP_Path* pxPath )
+{
+   switch( lPathId )
+   {
+   case HAL_STAND_IN_PATH_PARALLEL:
+      stand_in_eInterface = TP_PARALLEL;
+      break;
+
+   case HAL_STAND_IN_PATH_SPI:
+      stand_in_eInterface = TP_SPI;
+      break;
+
+   case HAL_STAND_IN_PATH_SERIAL:
+      stand_in_eInterface = TP_SERIAL;
+      break;
+
+   default:
+      return( TP_ERR_INVALID_PATH_ID );
+   }
+
+   *peInterface = stand_in_eInterface;
+   *pxPath = &stand_in_iPath;
+   return( TP_ERR_NONE );
+}
+
+TP_StatusType WINAPI TP_UserSelectPath( TP_InterfaceType* peInterface, UINT32* plPathId, TP_Path* pxPath )
+{
+   *plPathId = HAL_STAND_IN_PATH_PARALLEL;
+   return( TP_SelectPath( peInterface, *plPathId, pxPath ) );
+}
+
+TP_StatusType WINAPI TP_UserSelectPathExt( TP_InterfaceType* peInterface, UINT32* plPathId, TP_Path* pxPath, const char* pacLabel )
+{
+   (void)pacLabel;
+   return( TP_UserSelectPath( peInterface, plPathId, pxPath ) );
+}
+
+TP_StatusType WINAPI TP_DestroyPath( TP_Path xPath )
+{
+   (void)xPath;
+   return( TP_ERR_NONE );
+}
+
+TP_StatusType WINAPI TP_PathName( TP_Path xPath, const char** ppacName )
+{
+   (void)xPath;
+   *ppacName = "Stand-in";
+   return( TP_ERR_NONE );
+}
+
+TP_StatusType WINAPI TP_PathNameW( TP_Path xPath, const wchar_t** ppacName )
+{
+   (void)xPath;
+   *ppacName = L"Stand-in";
+   return( TP_ERR_NONE );
+}
+
+TP_StatusType WINAPI TP_GetSupportedBaudRates( TP_Path xPath, UINT32* plBaudRates, UINT32* plNumBaudRates )
+{
+   (void)xPath;
+   if( *plNumBaudRates < 1 )
+   {
+      return( TP_ERR_MEM_SIZE );
+   }
+   plBaudRates[ 0 ] = 57600;
+   *plNumBaudRates = 1;
+   return( TP_ERR_NONE );
+}
+
+TP_StatusType WINAPI TP_GetProviderHandleAndPath( TP_Path xPath, HANDLE* phProvider, TP_Path* pxProviderPath )
+{
+   *phProvider = NULL;
+   *pxProviderPath = xPath;
+   return( TP_ERR_NONE );
+}
+
+TP_StatusType WINAPI TP_ProviderSpecificCommand( TP_Path xPath, TP_MessageType* psMsg )
+{
+   UINT8 bCommand;
+
+   (void)xPath;
+
+   bCommand = psMsg->sReq.abData[ 0 ];
+   psMsg->sRsp.eResponse = TP_CMD_ERR_NONE;
+   psMsg->sRsp.bDataSize = 1;
+
+   switch( bCommand )
+   {
+   case 0x04:
+      /*
+      ** Port C: module detected, module ID 0.
+      */
+      psMsg->sRsp.abData[ 0 ] = 0x00;
+      break;
+
+   case 0x06:
+      /*
+      ** Port E: IRQ line high, i.e. inactive.
+      */
+      psMsg->sRsp.abData[ 0 ] = 0x01;
+      break;
+
+   case 0x17:
+      /*
+      ** 16-bit parallel module.
+      */
+      psMsg->sRsp.abData[ 0 ] = 0x01;
+      break;
+
+   default:
+      psMsg->sRsp.abData[ 0 ] = 0x00;
+      break;
+   }
+
+   return( TP_ERR_NONE );
+}
+
+TP_StatusType WINAPI TP_ParallelOpen( TP_Path xPath, UINT16 iSize )
+{
+   (void)xPath;
+   if( iSize > STAND_IN_MEMORY_SIZE )
+   {
+      return( TP_ERR_MEM_SIZE );
+   }
+   stand_in_fOpen = TRUE;
+   return( TP_ERR_NONE );
+}
+
+TP_StatusType WINAPI TP_ParallelClose( TP_Path xPath )
+{
+   (void)xPath;
+   stand_in_fOpen = FALSE;
+   return( TP_ERR_NONE );
+}
+
+TP_StatusType WINAPI TP_ParallelRead( TP_Path xPath, UINT16 iOffset, UINT8* pbData, UINT16 iAmount )
+{
+   (void)xPath;
+   if( (UINT32)iOffset + iAmount > STAND_IN_MEMORY_SIZE )
+   {
+      return( TP_ERR_MEM_SIZE );
+   }
+   memcpy( pbData, &stand_in_abMemory[ iOffset ], iAmount );
+   return( TP_ERR_NONE );
+}
+
+TP_StatusType WINAPI TP_ParallelVerifyRead( TP_Path xPath, UINT16 iOffset, UINT8* pbData, UINT16 iAmount, UINT16 iMaxTries )
+{
+   UINT16 i;
+
+   (void)xPath;
+   (void)iMaxTries;
+
+   if( (UINT32)iOffset + iAmount > STAND_IN_MEMORY_SIZE )
+   {
+      return( TP_ERR_MEM_SIZE );
+   }
+
+   /*
+   ** Read each byte twice like the real router does. Nothing changes the
+   ** memory behind the benchmark's back, so the first retry always matches.
+   */
+   for( i = 0; i < iAmount; i++ )
+   {
+      pbData[ i ] = ( (volatile UINT8*)stand_in_abMemory )[ iOffset + i ];
+      if( pbData[ i ] != ( (volatile UINT8*)stand_in_abMemory )[ iOffset + i ] )
+      {
+         return( TP_ERR_VERIFY );
+      }
+   }
+   return( TP_ERR_NONE );
+}
+
+TP_StatusType WINAPI TP_ParallelWrite( TP_Path xPath, UINT16 iOffset, const UINT8* pbData, UINT16 iAmount )
+{
+   (void)xPath;
+   if( (UINT32)iOffset + iAmount > STAND_IN_MEMORY_SIZE )
+   {
+      return( TP_ERR_MEM_SIZE );
+   }
+   memcpy( &stand_in_abMemory[ iOffset ], pbData, iAmount );
+   return( TP_ERR_NONE );
+}
+
+TP_StatusType WINAPI TP_ParallelVerifyWrite( TP_Path xPath, UINT16 iOffset, const UINT8* pbData, UINT16 iAmount, UINT16 iMaxTries )
+{
+   (void)iMaxTries;
+   return( TP_ParallelWrite( xPath, iOffset, pbData, iAmount ) );
+}
+
+TP_StatusType WINAPI TP_SerialOpen( TP_Path xPath, UINT32 lBaudRate, UINT8 bDataBits, TP_SerialParityType eParity, TP_SerialStopBitType eStopBits )
+{
+   (void)xPath;
+   (void)lBaudRate;
+   (void)bDataBits;
+   (void)eParity;
+   (void)eStopBits;
+
+   stand_in_iSerialHead = 0;
+   stand_in_iSerialTail = 0;
+   stand_in_fOpen = TRUE;
+   return( TP_ERR_NONE );
+}
+
+TP_StatusType WINAPI TP_SerialReopen( TP_Path xPath, UINT32 lBaudRate, UINT8 bDataBits, TP_SerialParityType eParity, TP_SerialStopBitType eStopBits )
+{
+   return( TP_SerialOpen( xPath, lBaudRate, bDataBits, eParity, eStopBits ) );
+}
+
+TP_StatusType WINAPI TP_SerialClose( TP_Path xPath )
+{
+   (void)xPath;
+   stand_in_fOpen = FALSE;
+   return( TP_ERR_NONE );
+}
+
+TP_StatusType WINAPI TP_SerialGetInAmount( TP_Path xPath, UINT16* piAmount )
+{
+   (void)xPath;
+   EnterCriticalSection( &stand_in_sSerialLock );
+   *piAmount = (UINT16)( ( stand_in_iSerialHead - stand_in_iSerialTail ) % STAND_IN_SERIAL_BUFFER_SIZE );
+   LeaveCriticalSection( &stand_in_sSerialLock );
+   return( TP_ERR_NONE );
+}
+
+TP_StatusType WINAPI TP_SerialGetOutAmount( TP_Path xPath, UINT16* piAmount )
+{
+   (void)xPath;
+   *piAmount = 0;
+   return( TP_ERR_NONE );
+}
+
+TP_StatusType WINAPI TP_SerialRead( TP_Path xPath, UINT8* pbData, UINT16* piAmount, UINT16 iMaxWaitTime )
+{
+   UINT16 i;
+
+   (void)xPath;
+   (void)iMaxWaitTime;
+
+   EnterCriticalSection( &stand_in_sSerialLock );
+   for( i = 0; ( i < *piAmount ) && ( stand_in_iSerialTail != stand_in_iSerialHead ); i++ )
+   {
+      pbData[ i ] = stand_in_abSerial[ stand_in_iSerialTail ];
+      stand_in_iSerialTail = ( stand_in_iSerialTail + 1 ) % STAND_IN_SERIAL_BUFFER_SIZE;
+   }
+   LeaveCriticalSection( &stand_in_sSerialLock );
+
+   *piAmount = i;
+   return( TP_ERR_NONE );
+}
+
+TP_StatusType WINAPI TP_SerialWrite( TP_Path xPath, const UINT8* pbData, UINT16* piAmount, UINT16 iMaxWaitTime )
+{
+   UINT16 iNext;
+   UINT16 i;
+
+   (void)xPath;
+   (void)iMaxWaitTime;
+
+   EnterCriticalSection( &stand_in_sSerialLock );
+   for( i = 0; i < *piAmount; i++ )
+   {
+      iNext = ( stand_in_iSerialHead + 1 ) % STAND_IN_SERIAL_BUFFER_SIZE;
+      if( iNext == stand_in_iSerialTail )
+      {
+         break;
+      }
+      stand_in_abSerial[ stand_in_iSerialHead ] = pbData[ i ];
+      stand_in_iSerialHead = iNext;
+   }
+   LeaveCriticalSection( &stand_in_sSerialLock );
+
+   *piAmount = i;
+   return( TP_ERR_NONE );
+}
+
+TP_StatusType WINAPI TP_SpiOpen( TP_Path xPath, UINT32 lBaudRate, TP_SpiWireModeType eWireMode )
+{
+   (void)xPath;
+   (void)lBaudRate;
+   (void)eWireMode;
+   stand_in_fOpen = TRUE;
+   return( TP_ERR_NONE );
+}
+
+TP_StatusType WINAPI TP_SpiClose( TP_Path xPath )
+{
+   (void)xPath;
+   stand_in_fOpen = FALSE;
+   return( TP_ERR_NONE );
+}
+
+TP_StatusType WINAPI TP_SpiTransaction( TP_Path xPath, const UINT8* pbMosi, UINT8* pbMiso, UINT16 iAmount )
+{
+   (void)xPath;
+   if( !stand_in_fOpen )
+   {
+      return( TP_ERR_NOT_OPEN );
+   }
+   memcpy( pbMiso, pbMosi, iAmount );
+   return( TP_ERR_NONE );
+}
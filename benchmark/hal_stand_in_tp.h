@@ -0,0 +1,17 @@
+/*******************************************************************************
+** Copyright 2025-present HMS Industrial Networks AB.
+** Licensed under the MIT License.
+********************************************************************************
+** File Description:
+** Path IDs of the stand-in Transport Provider router used by hal_benchmark.
+********************************************************************************
+*/
+
+#ifndef HAL_STAND_IN_TP_H_
+#define HAL_STAND_IN_TP_H_
+
+#define HAL_STAND_IN_PATH_PARALLEL                 ( 1 )
+#define HAL_STAND_IN_PATH_SPI                      ( 2 )
+#define HAL_STAND_IN_PATH_SERIAL                   ( 3 )
+
+#endif  /* inclusion lock */
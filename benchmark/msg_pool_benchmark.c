@@ -0,0 +1,188 @@
+/*******************************************************************************
+** Copyright 2025-present HMS Industrial Networks AB.
+** Licensed under the MIT License.
+********************************************************************************
+** File Description:
+** Burst benchmark for the host side command queue.
+**
+** A burst of commands is pushed through the real APPL_CMDQ path: pooled
+** buffer, APPL_CMDQ_SendCmdMsg() and APPL_CMDQ_Run(). The driver is a
+** stand-in with a given number of command buffers. Each simulated
+** communication cycle it answers every command it holds, as the ABCC does
+** when it has room for the whole queue.
+**
+** Per number of driver buffers the benchmark reports:
+**    - cycles     Simulated communication cycles the burst took. The cycles
+**                 are not timed, the stand-in answers as soon as it is run.
+**    - drv full   Times queued commands had to wait for a driver buffer.
+**    - pushbacks  Commands the producer could not queue (host pool full).
+**    - queued hw  Highest number of commands waiting in the queue.
+**    - host ns    Measured host CPU time per message for queueing, handing
+**                 over and answering.
+**
+** Usage:
+**    msg_pool_benchmark [burst size]
+********************************************************************************
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "abcc.h"
+#include "host_time.h"
+#include "appl_command_queue.h"
+
+#define BENCH_MAX_DRIVER_BUFFERS                   ( 64 )
+#define BENCH_DEFAULT_BURST                        ( 1024 )
+#define BENCH_MSG_DATA_SIZE                        ( 64 )
+
+/*------------------------------------------------------------------------------
+** Stand-in driver. Buffers are handed out until iNumBuffers are in use, and
+** sent commands are held until the next simulated cycle answers them.
+**------------------------------------------------------------------------------
+*/
+static ABP_MsgType             bench_asDrvMsg[ BENCH_MAX_DRIVER_BUFFERS ];
+static ABCC_MsgHandlerFuncType bench_apnHandler[ BENCH_MAX_DRIVER_BUFFERS ];
+static BOOL8                   bench_afInUse[ BENCH_MAX_DRIVER_BUFFERS ];
+static BOOL8                   bench_afSent[ BENCH_MAX_DRIVER_BUFFERS ];
+static UINT16                  bench_iNumBuffers;
+static UINT32                  bench_lNumAnswered;
+
+ABP_MsgType* ABCC_GetCmdMsgBuffer( void )
+{
+   UINT16 i;
+
+   for( i = 0; i < bench_iNumBuffers; i++ )
+   {
+      if( !bench_afInUse[ i ] )
+      {
+         bench_afInUse[ i ] = TRUE;
+         return( &bench_asDrvMsg[ i ] );
+      }
+   }
+   return( NULL );
+}
+
+ABCC_ErrorCodeType ABCC_SendCmdMsg( ABP_MsgType* psCmdMsg, ABCC_MsgHandlerFuncType pnMsgHandler )
+{
+   UINT16 i = (UINT16)( psCmdMsg - bench_asDrvMsg );
+
+   bench_apnHandler[ i ] = pnMsgHandler;
+   bench_afSent[ i ] = TRUE;
+   return( ABCC_EC_NO_ERROR );
+}
+
+static void HandleResponse( ABP_MsgType* psMsg )
+{
+   (void)psMsg;
+   bench_lNumAnswered++;
+}
+
+/*------------------------------------------------------------------------------
+** One communication cycle: every command the driver holds is answered and
+** its buffer returned.
+**------------------------------------------------------------------------------
+*/
+static void AnswerAll( void )
+{
+   UINT16 i;
+
+   for( i = 0; i < bench_iNumBuffers; i++ )
+   {
+      if( bench_afSent[ i ] )
+      {
+         bench_afSent[ i ] = FALSE;
+         bench_apnHandler[ i ]( &bench_asDrvMsg[ i ] );
+         bench_afInUse[ i ] = FALSE;
+      }
+   }
+}
+
+static void RunBurst( UINT16 iNumBuffers, UINT32 lBurst )
+{
+   APPL_CMDQ_StatsType sStats;
+   ABP_MsgType*        psMsg;
+   UINT32              lProduced = 0;
+   UINT32              lCycles = 0;
+   UINT64              llStartNs;
+   UINT64              llHostNs;
+
+   memset( bench_afInUse, 0, sizeof( bench_afInUse ) );
+   memset( bench_afSent, 0, sizeof( bench_afSent ) );
+   bench_iNumBuffers = iNumBuffers;
+   bench_lNumAnswered = 0;
+   APPL_CMDQ_Init();
+
+   llStartNs = HOST_TIME_GetNs();
+   while( bench_lNumAnswered < lBurst )
+   {
+      /*
+      ** Producer: queue commands until the host pool pushes back.
+      */
+      while( lProduced < lBurst )
+      {
+         psMsg = APPL_CMDQ_GetCmdMsgBuffer();
+         if( psMsg == NULL )
+         {
+            break;
+         }
+         memset( psMsg, 0, sizeof( psMsg->sHeader ) );
+         psMsg->sHeader.iDataSize = BENCH_MSG_DATA_SIZE;
+         memset( psMsg->abData, (int)lProduced, BENCH_MSG_DATA_SIZE );
+         APPL_CMDQ_SendCmdMsg( psMsg, HandleResponse, NULL );
+         lProduced++;
+      }
+
+      /*
+      ** The main loop hands queued commands over, one cycle later the
+      ** ABCC has answered them.
+      */
+      APPL_CMDQ_Run();
+      AnswerAll();
+      lCycles++;
+   }
+   llHostNs = HOST_TIME_GetNs() - llStartNs;
+
+   APPL_CMDQ_GetStats( &sStats );
+
+   printf( "%7u  %8lu  %8lu  %9lu  %9u  %7.1f\n",
+           iNumBuffers,
+           (unsigned long)lCycles,
+           (unsigned long)sStats.lNumDriverFull,
+           (unsigned long)sStats.sPool.lNumExhausted,
+           sStats.iQueuedHighWater,
+           (double)llHostNs / lBurst );
+}
+
+int main( int argc, char* argv[] )
+{
+   static const UINT16 aiNumBuffers[] = { 1, 2, 4, ABCC_CFG_MAX_NUM_APPL_CMDS, 16, 32, 64 };
+   UINT32 lBurst = BENCH_DEFAULT_BURST;
+   UINT16 i;
+
+   if( argc > 1 )
+   {
+      lBurst = (UINT32)strtoul( argv[ 1 ], NULL, 0 );
+   }
+   if( lBurst == 0 )
+   {
+      printf( "Usage: %s [burst size]\n", argv[ 0 ] );
+      return( 1 );
+   }
+
+   HOST_TIME_Init();
+
+   printf( "Burst of %lu messages, host queue depth %u\n\n",
+           (unsigned long)lBurst, (UINT16)APPL_CFG_CMD_QUEUE_DEPTH );
+   printf( "drv buf    cycles  drv full  pushbacks  queued hw  host ns\n" );
+   for( i = 0; i < sizeof( aiNumBuffers ) / sizeof( aiNumBuffers[ 0 ] ); i++ )
+   {
+      if( aiNumBuffers[ i ] <= BENCH_MAX_DRIVER_BUFFERS )
+      {
+         RunBurst( aiNumBuffers[ i ], lBurst );
+      }
+   }
+
+   return( 0 );
+}
@@ -53,12 +53,42 @@
 
 /*------------------------------------------------------------------------------
 ** Configuration of message handling
+**
+** The command queue depths limit how many commands can be outstanding in each
+** direction. Bursts of explicit messages, such as parameter downloads from the
+** PLC, stall once a queue is full. The depths can be overridden from the build
+** system, e.g. -DABCC_CFG_MAX_NUM_ABCC_CMDS=16.
 **------------------------------------------------------------------------------
 */
-#define ABCC_CFG_MAX_NUM_APPL_CMDS                 ( 4 )
-#define ABCC_CFG_MAX_NUM_ABCC_CMDS                 ( 4 )
+#ifndef ABCC_CFG_MAX_NUM_APPL_CMDS
+   #define ABCC_CFG_MAX_NUM_APPL_CMDS              ( 8 )
+#endif
+#ifndef ABCC_CFG_MAX_NUM_ABCC_CMDS
+   #define ABCC_CFG_MAX_NUM_ABCC_CMDS              ( 8 )
+#endif
 #define ABCC_CFG_MAX_PROCESS_DATA_SIZE             ( 4096 )
 
+/*------------------------------------------------------------------------------
+** Host application command queue
+**
+** Number of pooled message buffers in which application originated commands
+** wait for a free driver command buffer. See appl_command_queue.h.
+**------------------------------------------------------------------------------
+*/
+#ifndef APPL_CFG_CMD_QUEUE_DEPTH
+   #define APPL_CFG_CMD_QUEUE_DEPTH                ( 16 )
+#endif
+
+/*------------------------------------------------------------------------------
+** Application tasks
+**
+** Number of task frames, i.e. tasks that can be running at once, and the
+** response buffer of each frame. See appl_task.h.
+**------------------------------------------------------------------------------
+*/
+#define APPL_CFG_TASK_POOL_SIZE                    ( 4 )
+#define APPL_CFG_TASK_RESPONSE_SIZE                ( 64 )
+
 /*------------------------------------------------------------------------------
 ** Interrupt configuration excluding sync
 **------------------------------------------------------------------------------
@@ -115,6 +145,10 @@
 **
 ** Note: the associated object must be enabled via its _OBJ_ENABLE macro for a
 ** command response entry to take effect.
+**
+** Note: the list is expanded and searched inside the driver API. Host side
+** handler tables that grow large should be indexed with host_dispatch.h,
+** which gives constant-time lookup on object/instance/attribute.
 **------------------------------------------------------------------------------
 */
 #define ABCC_API_COMMAND_RESPONSE_LIST \
@@ -133,6 +167,187 @@
    /*ABCC_PROFINET_OBJ_DEVICE_ID_GET_CBFUNC,*/ \
    /*ABCC_PROFINET_OBJ_ORDER_ID_GET_CBFUNC,*/
 
+/*------------------------------------------------------------------------------
+** Main loop pacing
+**
+** Default period of the main loop, can be changed with --period, and the time
+** before each deadline that is spent spinning instead of sleeping, can be
+** changed with --spin. See host_wait.h. The default only sleeps, which keeps
+** the CPU free at the cost of wake-ups up to a timer tick late. Short periods
+** that need tight timing should spin for about 1000-1500 us.
+**------------------------------------------------------------------------------
+*/
+#define HOST_CFG_CYCLE_PERIOD_US                   ( 10000 )
+#define HOST_CFG_CYCLE_SPIN_US                     ( 0 )
+
+/*------------------------------------------------------------------------------
+** Cycle budget
+**
+** Default time budget for ABCC_API_Run() per cycle, in percent of the main
+** loop period, can be changed with --budget. Load shedding ends after
+** HOST_CFG_BUDGET_RECOVER_CYCLES consecutive cycles below
+** HOST_CFG_BUDGET_RECOVER_PERCENT of the budget. See host_budget.h.
+**------------------------------------------------------------------------------
+*/
+#define HOST_CFG_BUDGET_PERCENT                    ( 50 )
+#define HOST_CFG_BUDGET_RECOVER_PERCENT            ( 75 )
+#define HOST_CFG_BUDGET_RECOVER_CYCLES             ( 100 )
+
+/*------------------------------------------------------------------------------
+** Headless mode
+**
+** Name of the local named pipe that accepts control commands when the
+** application is started with --headless. See host_control.h.
+**
+** On console close, logoff and system shutdown, Windows ends the process
+** shortly after the console control handler returns, about 5 s after the
+** event by default. The handler holds the process for at most this many
+** milliseconds while the main loop shuts down the driver.
+**------------------------------------------------------------------------------
+*/
+#define HOST_CFG_CONTROL_PIPE_NAME                 "\\\\.\\pipe\\abcc_starterkit"
+#define HOST_CFG_CONTROL_SHUTDOWN_TIMEOUT_MS       ( 4000 )
+
+/*------------------------------------------------------------------------------
+** Process data capture
+**
+** Number of records in the ring file written when the application is started
+** with --pd-capture. Each record holds one read or one write process data
+** image. See host_pd_capture.h.
+**------------------------------------------------------------------------------
+*/
+#define HOST_CFG_PD_CAPTURE_NUM_RECORDS            ( 4096 )
+
+/*------------------------------------------------------------------------------
+** Process data buffers
+**
+** Alignment of the parallel interface process data buffers, one cache line.
+** See host_pd_buffer.h.
+**------------------------------------------------------------------------------
+*/
+#define HOST_CFG_PD_BUFFER_ALIGN                   ( 64 )
+
+/*------------------------------------------------------------------------------
+** Shared memory process image
+**
+** Name of the shared memory section holding the ADI values and process data
+** for other processes, and the largest number of copies per update (one per
+** ADI plus one per default map entry). See host_image.h.
+**------------------------------------------------------------------------------
+*/
+#define HOST_CFG_IMAGE_NAME                        "Local\\abcc_process_image"
+#define HOST_CFG_IMAGE_MAX_COPIES                  ( 64 )
+
+/*------------------------------------------------------------------------------
+** Fault injection
+**
+** Time in PROCESS_ACTIVE required before each injection, and the longest
+** time to wait for recovery before an injection is counted as failed. See
+** host_fault.h.
+**------------------------------------------------------------------------------
+*/
+#define HOST_CFG_FAULT_SETTLE_MS                   ( 2000 )
+#define HOST_CFG_FAULT_RECOVERY_TIMEOUT_MS         ( 30000 )
+#define HOST_CFG_FAULT_MAX_REPETITIONS             ( 1000 )
+
+/*------------------------------------------------------------------------------
+** Verified parallel reads
+**
+** Which parallel reads use TP_ParallelVerifyRead(), which re-reads every byte
+** until two reads agree. SELECTIVE verifies only reads that can tear: the
+** 16-bit register reads and the read process data buffer. ALL verifies every
+** read, roughly doubling the bus cost. The mode can be changed with
+** --verify-reads. MAX_TRIES is the retry budget per byte.
+**------------------------------------------------------------------------------
+*/
+#define HOST_CFG_PAR_VERIFY_OFF                    ( 0 )
+#define HOST_CFG_PAR_VERIFY_SELECTIVE              ( 1 )
+#define HOST_CFG_PAR_VERIFY_ALL                    ( 2 )
+#define HOST_CFG_PAR_VERIFY_MODE                   HOST_CFG_PAR_VERIFY_OFF
+#define HOST_CFG_PAR_VERIFY_MAX_TRIES              ( 3 )
+
+/*------------------------------------------------------------------------------
+** Serial receiver
+**
+** Size of the ring buffer the serial reader thread fills, a power of two, and
+** how long the thread sleeps when no data is waiting. See host_serial_rx.h.
+**------------------------------------------------------------------------------
+*/
+#define HOST_CFG_SERIAL_RX_RING_SIZE               ( 4096 )
+#define HOST_CFG_SERIAL_RX_POLL_MS                 ( 1 )
+
+/*------------------------------------------------------------------------------
+** HAL locking
+**
+** 1 gives the Transport Provider data channel and the control pins (reset,
+** IRQ, module detect) separate locks. 0 serialises both on one lock. The
+** contention figures in the statistics printout show the difference.
+**------------------------------------------------------------------------------
+*/
+#define HOST_CFG_HAL_SPLIT_LOCKS                   1
+
+/*------------------------------------------------------------------------------
+** Trace export
+**
+** 1 builds in the trace points for --trace. The buffer holds the most recent
+** HOST_CFG_TRACE_BUFFER_EVENTS events, a power of two, 32 bytes each. With
+** HOST_CFG_TRACE_OVERRUN_FACTOR set, the first main loop interval longer than
+** that many periods dumps the buffer to HOST_CFG_TRACE_OVERRUN_FILE. See
+** host_trace.h.
+**------------------------------------------------------------------------------
+*/
+#define HOST_CFG_TRACE_ENABLED                     1
+#define HOST_CFG_TRACE_BUFFER_EVENTS               ( 65536 )
+#define HOST_CFG_TRACE_OVERRUN_FACTOR              ( 3 )
+#define HOST_CFG_TRACE_OVERRUN_FILE                "abcc_overrun_trace.json"
+
+/*------------------------------------------------------------------------------
+** Memory hardening
+**
+** 1 locks the executable image, the process data buffers and the stacks of
+** the cyclic threads into the working set at startup, so that the cyclic
+** path does not take page faults on first touch. The top
+** HOST_CFG_MEMORY_STACK_BYTES of each cyclic thread's stack are locked.
+** Page faults in PROCESS_ACTIVE are counted per
+** HOST_CFG_MEMORY_FAULT_SAMPLE_US interval. See host_memory.h.
+**------------------------------------------------------------------------------
+*/
+#define HOST_CFG_MEMORY_LOCK_ENABLED               1
+#define HOST_CFG_MEMORY_STACK_BYTES                ( 64 * 1024 )
+#define HOST_CFG_MEMORY_FAULT_SAMPLE_US            ( 100000 )
+
+/*------------------------------------------------------------------------------
+** Task scheduler
+**
+** Maximum number of tasks and the periods of the example control loop tasks.
+** See host_scheduler.h.
+**------------------------------------------------------------------------------
+*/
+#define HOST_CFG_SCHED_MAX_TASKS                   ( 8 )
+#define APPL_CFG_MOTOR_RAMP_PERIOD_US              ( 10000 )
+#define APPL_CFG_DIAGNOSTICS_PERIOD_US             ( 100000 )
+
+/*------------------------------------------------------------------------------
+** Example motor axes
+**
+** Number of axes (1-255, each quantity is one ADI array) and the largest
+** speed change per ramp cycle. See appl_axis_engine.h.
+**------------------------------------------------------------------------------
+*/
+#define APPL_CFG_NUM_AXES                          ( 4 )
+#define APPL_CFG_MOTOR_RAMP_STEP                   ( 1 )
+
+/*------------------------------------------------------------------------------
+** Host performance ADIs
+**
+** 1 appends ADIs 0x100-0x105 with host performance figures to the ADI list,
+** so that they can be read or mapped from the network. They are refreshed
+** every APPL_CFG_HOST_PERF_PERIOD_US. See abcc_network_data_parameters.h.
+**------------------------------------------------------------------------------
+*/
+#define APPL_CFG_HOST_PERF_ADIS_ENABLED            1
+#define APPL_CFG_HOST_PERF_PERIOD_US               ( 100000 )
+
 /*------------------------------------------------------------------------------
 ** Debug and error macro configuration
 **------------------------------------------------------------------------------
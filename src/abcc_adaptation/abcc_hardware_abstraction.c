@@ -7,6 +7,7 @@
 */
 #include "windows.h"
 #include "process.h"
+#include "stdio.h"
 #include "tp.h"
 #include "imp_tp.h"
 
@@ -18,6 +19,15 @@
 #include "abcc_hardware_abstraction_spi.h"
 #include "abcc_hardware_abstraction_parallel.h"
 #include "abcc_hardware_abstraction_serial.h"
+#include "host_time.h"
+#include "host_lock.h"
+#include "host_pd_capture.h"
+#include "host_fault.h"
+#include "host_serial_rx.h"
+#include "host_trace.h"
+#include "host_boot.h"
+#include "host_pd_buffer.h"
+#include "host_memory.h"
 
 
 BOOL ABCC_StartTransportProvider( void );
@@ -44,8 +54,6 @@ unsigned runISR = 0;
 static ABCC_HAL_SpiDataReceivedCbfType pnDataReadyCbf;
 static ABCC_HAL_SerDataReceivedCbfType pnSerDataReadyCbf;
 
-static UINT8    sys_abReadProcessData[ ABCC_CFG_MAX_PROCESS_DATA_SIZE ];  /* Process data byte array. */
-static UINT8    sys_abWriteProcessData[ ABCC_CFG_MAX_PROCESS_DATA_SIZE ]; /* Process data byte array. */
 
 static    TP_Path xPathHandle = NULL;
 static    UINT32 lPathId = 0;
@@ -57,6 +65,41 @@ static    TP_InterfaceType eInterface = TP_ANY;
 /* Global to ease debugging: This is the last received status code from the TP. */
 static    TP_StatusType eLastReceivedTpPariStatus;
 
+/*
+** Transport Provider access is serialised per resource instead of on the
+** driver's critical section. Data transfers take sys_sDataLock. Reset and
+** control pin commands take the control lock, so IRQ pin polling and module
+** detection do not wait behind a long transfer. With
+** HOST_CFG_HAL_SPLIT_LOCKS set to 0 both share the data lock, for comparing
+** the contention figures.
+*/
+static HOST_LOCK_Type  sys_sDataLock;
+static HOST_LOCK_Type  sys_sControlLock;
+static HOST_LOCK_Type* sys_psControlLock = &sys_sDataLock;
+static BOOL8           sys_fLocksInitialised = FALSE;
+
+/*
+** Data channel round trips, counted under the data lock, and failed
+** Transport Provider calls, counted from any thread.
+*/
+static UINT32          sys_lNumTpTransfers = 0;
+static volatile LONG   sys_lNumTpErrors = 0;
+
+/*
+** Verified parallel reads, see HOST_CFG_PAR_VERIFY_MODE. The times include
+** the Transport Provider round trip and are used to show the extra cost of
+** verification. A verified read goes to sys_abParVerifyBuffer first, so that
+** a read that fails verification leaves the destination untouched. The
+** buffer is used under sys_sDataLock only.
+*/
+static UINT8  sys_abParVerifyBuffer[ ACI_MEMORY_MAP_SIZE ];
+static UINT8  sys_bParVerifyMode = HOST_CFG_PAR_VERIFY_MODE;
+static UINT32 sys_lNumParReads = 0;
+static UINT64 sys_llParReadUs = 0;
+static UINT32 sys_lNumParVerifiedReads = 0;
+static UINT64 sys_llParVerifiedReadUs = 0;
+static UINT32 sys_lNumParVerifyFailures = 0;
+
 void TP_Shutdown( void )
 {
    ABCC_CloseTransportProvider();
@@ -77,16 +120,20 @@ static UINT8 TP_Command( UINT8 bCommand )
 {
    TP_StatusType eStatus;
    TP_MessageType  sMsg;
+   UINT64          llTraceNs;
    sMsg.sReq.eCommand = TP_CMD_USB2_SPECIFIC;
    sMsg.sReq.bDataSize = 1;
    sMsg.sReq.abData[0] = bCommand;
 
-   ABCC_PORT_EnterCritical();
+   HOST_LOCK_Enter( sys_psControlLock );
+   llTraceNs = HOST_TRACE_Begin();
    eStatus = TP_ProviderSpecificCommand( xPathHandle, &sMsg );
-   ABCC_PORT_ExitCritical();
+   HOST_TRACE_End( HOST_TRACE_CAT_HAL, "TP_Command", llTraceNs, bCommand );
+   HOST_LOCK_Exit( sys_psControlLock );
 
    if ( eStatus != TP_ERR_NONE )
    {
+      InterlockedIncrement( &sys_lNumTpErrors );
       ABCC_LOG_WARNING( ABCC_EC_HAL_ERR, (UINT32)eStatus, "Transport provider error %d\n", eStatus );
    }
    return( sMsg.sRsp.abData[0] );
@@ -99,6 +146,8 @@ unsigned __stdcall ISR( void *pMyID )
    UINT8 bTpPortE;
    (void) pMyID;
 
+   HOST_TRACE_NameThread( "isr" );
+   HOST_MEMORY_LockStack( "isr stack" );
    while( runISR )
    {
       Sleep(1);
@@ -144,12 +193,14 @@ void ABCC_HAL_SpiRegDataReceived( ABCC_HAL_SpiDataReceivedCbfType pnDataReceived
 void ABCC_HAL_SpiSendReceive( void* pxSendDataBuffer, void* pxReceiveDataBuffer, UINT16 iLength )
 {
    TP_StatusType eStatus;
-   ABCC_PORT_UseCritical();
+   UINT64        llTraceNs;
 
-   ABCC_PORT_EnterCritical();
+   HOST_LOCK_Enter( &sys_sDataLock );
+   llTraceNs = HOST_TRACE_Begin();
    eStatus = TP_SpiTransaction( xPathHandle, pxSendDataBuffer, pxReceiveDataBuffer, iLength );
-
-   ABCC_PORT_ExitCritical();
+   HOST_TRACE_End( HOST_TRACE_CAT_HAL, "TP_SpiTransaction", llTraceNs, iLength );
+   sys_lNumTpTransfers++;
+   HOST_LOCK_Exit( &sys_sDataLock );
 
    if (eStatus == TP_ERR_NONE )
    {
@@ -160,6 +211,7 @@ void ABCC_HAL_SpiSendReceive( void* pxSendDataBuffer, void* pxReceiveDataBuffer,
    }
    else
    {
+      InterlockedIncrement( &sys_lNumTpErrors );
       ABCC_LOG_WARNING( ABCC_EC_HAL_ERR,
          (UINT32)eStatus,
          "ERROR in SPI transaction: ERR: 0x%x\n",
@@ -170,21 +222,83 @@ void ABCC_HAL_SpiSendReceive( void* pxSendDataBuffer, void* pxReceiveDataBuffer,
 
 
 #if( ABCC_CFG_DRV_PARALLEL_ENABLED && !ABCC_CFG_MEMORY_MAPPED_ACCESS_ENABLED )
-void ABCC_HAL_ParallelRead( UINT16 iMemOffset, void* pxData, UINT16 iLength )
+/*
+** fTearProne is set for reads whose value can change between the bytes of
+** the transfer, so that a plain read may return a mix of old and new.
+*/
+static void ParallelRead( UINT16 iMemOffset, void* pxData, UINT16 iLength, BOOL8 fTearProne )
 {
+   BOOL8  fVerify;
+   UINT64 llStartUs;
+   UINT64 llTraceNs;
+
    if( iLength == 0 )
    {
       return;
    }
 
-   ABCC_PORT_EnterCritical();
-   eLastReceivedTpPariStatus = TP_ParallelRead( xPathHandle, iMemOffset, pxData, iLength );
-   ABCC_PORT_ExitCritical();
+   /*
+   ** The process data buffers are sized from the default map. A longer
+   ** transfer, e.g. after the network remapped the process data, would
+   ** overrun the buffer.
+   */
+   if( ( pxData == HOST_PD_BUFFER_Read() ) && ( iLength > HOST_PD_BUFFER_ReadSize() ) )
+   {
+      InterlockedIncrement( &sys_lNumTpErrors );
+      ABCC_LOG_ERROR( ABCC_EC_HAL_ERR, iLength, "Read PD of %u bytes exceeds the buffer\n", iLength );
+      return;
+   }
+
+   fVerify = ( TP_ParallelVerifyRead != NULL ) &&
+             ( iLength <= sizeof( sys_abParVerifyBuffer ) ) &&
+             ( ( sys_bParVerifyMode == HOST_CFG_PAR_VERIFY_ALL ) ||
+               ( ( sys_bParVerifyMode == HOST_CFG_PAR_VERIFY_SELECTIVE ) &&
+                 ( fTearProne || ( pxData == HOST_PD_BUFFER_Read() ) ) ) );
+
+   HOST_LOCK_Enter( &sys_sDataLock );
+   llTraceNs = HOST_TRACE_Begin();
+   llStartUs = HOST_TIME_GetUs();
+   if( fVerify )
+   {
+      eLastReceivedTpPariStatus = TP_ParallelVerifyRead( xPathHandle, iMemOffset, sys_abParVerifyBuffer,
+                                                         iLength, HOST_CFG_PAR_VERIFY_MAX_TRIES );
+      if( eLastReceivedTpPariStatus == TP_ERR_NONE )
+      {
+         memcpy( pxData, sys_abParVerifyBuffer, iLength );
+      }
+      else if( eLastReceivedTpPariStatus == TP_ERR_VERIFY )
+      {
+         /*
+         ** The value kept changing for the whole retry budget. The previous
+         ** contents are kept and the read is reported as failed below, an
+         ** unverified read could return exactly the torn value the
+         ** verification is there to catch.
+         */
+         sys_lNumParVerifyFailures++;
+      }
+      sys_lNumParVerifiedReads++;
+      sys_llParVerifiedReadUs += HOST_TIME_GetUs() - llStartUs;
+      HOST_TRACE_End( HOST_TRACE_CAT_HAL, "TP_ParallelVerifyRead", llTraceNs, iLength );
+   }
+   else
+   {
+      eLastReceivedTpPariStatus = TP_ParallelRead( xPathHandle, iMemOffset, pxData, iLength );
+      sys_lNumParReads++;
+      sys_llParReadUs += HOST_TIME_GetUs() - llStartUs;
+      HOST_TRACE_End( HOST_TRACE_CAT_HAL, "TP_ParallelRead", llTraceNs, iLength );
+   }
+   if( ( pxData == HOST_PD_BUFFER_Read() ) && ( eLastReceivedTpPariStatus == TP_ERR_NONE ) )
+   {
+      HOST_PD_CAPTURE_Record( HOST_PD_CAPTURE_READ, pxData, iLength );
+   }
+   sys_lNumTpTransfers++;
+   HOST_LOCK_Exit( &sys_sDataLock );
    if( eLastReceivedTpPariStatus == TP_ERR_NONE )
    {
    }
    else
    {
+      InterlockedIncrement( &sys_lNumTpErrors );
       ABCC_LOG_WARNING( ABCC_EC_HAL_ERR,
          (UINT32)eLastReceivedTpPariStatus,
          "Read failed with error code %x\n",
@@ -192,11 +306,21 @@ void ABCC_HAL_ParallelRead( UINT16 iMemOffset, void* pxData, UINT16 iLength )
    }
 }
 
+void ABCC_HAL_ParallelRead( UINT16 iMemOffset, void* pxData, UINT16 iLength )
+{
+   ParallelRead( iMemOffset, pxData, iLength, FALSE );
+}
+
 #if( ABCC_CFG_DRV_PARALLEL_ENABLED )
 UINT16 ABCC_HAL_ParallelRead16( UINT16 iMemOffset )
 {
-   UINT16 iData;
-   ABCC_HAL_ParallelRead( iMemOffset, (UINT8*)&iData, sizeof( UINT16 ) );
+   UINT16 iData = 0;
+
+   /*
+   ** 16-bit reads are used for the status and handshake registers. A failed
+   ** read returns 0.
+   */
+   ParallelRead( iMemOffset, (UINT8*)&iData, sizeof( UINT16 ), TRUE );
    return( iData );
 }
 #endif
@@ -204,13 +328,29 @@ UINT16 ABCC_HAL_ParallelRead16( UINT16 iMemOffset )
 
 void ABCC_HAL_ParallelWrite( UINT16 iMemOffset, void* pxData, UINT16 iLength )
 {
+   UINT64 llTraceNs;
 
-   ABCC_PORT_EnterCritical();
+   if( ( pxData == HOST_PD_BUFFER_Write() ) && ( iLength > HOST_PD_BUFFER_WriteSize() ) )
+   {
+      InterlockedIncrement( &sys_lNumTpErrors );
+      ABCC_LOG_ERROR( ABCC_EC_HAL_ERR, iLength, "Write PD of %u bytes exceeds the buffer\n", iLength );
+      return;
+   }
+
+   HOST_LOCK_Enter( &sys_sDataLock );
+   llTraceNs = HOST_TRACE_Begin();
    eLastReceivedTpPariStatus = TP_ParallelWrite( xPathHandle, iMemOffset, pxData, iLength );
-   ABCC_PORT_ExitCritical();
+   HOST_TRACE_End( HOST_TRACE_CAT_HAL, "TP_ParallelWrite", llTraceNs, iLength );
+   if( ( pxData == HOST_PD_BUFFER_Write() ) && ( eLastReceivedTpPariStatus == TP_ERR_NONE ) )
+   {
+      HOST_PD_CAPTURE_Record( HOST_PD_CAPTURE_WRITE, pxData, iLength );
+   }
+   sys_lNumTpTransfers++;
+   HOST_LOCK_Exit( &sys_sDataLock );
 
    if( eLastReceivedTpPariStatus != TP_ERR_NONE )
    {
+      InterlockedIncrement( &sys_lNumTpErrors );
       ABCC_LOG_WARNING( ABCC_EC_HAL_ERR,
          (UINT32)eLastReceivedTpPariStatus,
          "Write failed with error code %x\n",
@@ -226,6 +366,53 @@ void ABCC_HAL_ParallelWrite16( UINT16 iMemOffset, UINT16 piData )
 #endif
 #endif
 
+/*
+** Number of data channel round trips and failed Transport Provider calls
+** since start.
+*/
+void TP_GetTransferCounts( UINT32* plTransfers, UINT32* plErrors )
+{
+   *plTransfers = sys_lNumTpTransfers;
+   *plErrors = (UINT32)sys_lNumTpErrors;
+}
+
+void TP_PrintLockStats( void )
+{
+   if( !sys_fLocksInitialised )
+   {
+      return;
+   }
+
+   printf( "HAL locks:\n" );
+   HOST_LOCK_PrintStats( &sys_sDataLock );
+   if( sys_psControlLock != &sys_sDataLock )
+   {
+      HOST_LOCK_PrintStats( &sys_sControlLock );
+   }
+}
+
+/*
+** Selects which parallel reads are verified, one of the HOST_CFG_PAR_VERIFY_
+** modes.
+*/
+void TP_vSetParallelVerifyMode( UINT8 bMode )
+{
+   sys_bParVerifyMode = bMode;
+}
+
+void TP_PrintParallelReadStats( void )
+{
+   printf( "Parallel reads:\n" );
+   printf( " %lu plain, mean %.1fus\n",
+           (unsigned long)sys_lNumParReads,
+           sys_lNumParReads ? (double)sys_llParReadUs / sys_lNumParReads : 0.0 );
+   printf( " %lu verified, mean %.1fus, %lu failed verification and kept the old data (max %u tries)\n",
+           (unsigned long)sys_lNumParVerifiedReads,
+           sys_lNumParVerifiedReads ? (double)sys_llParVerifiedReadUs / sys_lNumParVerifiedReads : 0.0,
+           (unsigned long)sys_lNumParVerifyFailures,
+           (unsigned)HOST_CFG_PAR_VERIFY_MAX_TRIES );
+}
+
 #if( ABCC_CFG_OP_MODE_SETTABLE )
 void ABCC_HAL_SetOpmode( UINT8 bOpmode )
 {
@@ -255,9 +442,11 @@ void ABCC_HAL_HWReset( void )
    sMsg.sReq.bDataSize = 1;
    sMsg.sReq.abData[0] = 0;
 
-   ABCC_PORT_EnterCritical();
+   HOST_BOOT_Begin( HOST_BOOT_HW_RESET );
+   HOST_LOCK_Enter( sys_psControlLock );
    eStatus = TP_ProviderSpecificCommand( xPathHandle, &sMsg );
-   ABCC_PORT_ExitCritical();
+   HOST_LOCK_Exit( sys_psControlLock );
+   HOST_BOOT_End( HOST_BOOT_HW_RESET );
 }
 
 
@@ -269,9 +458,11 @@ void ABCC_HAL_HWReleaseReset( void )
    sMsg.sReq.bDataSize = 1;
    sMsg.sReq.abData[0] = 1;
 
-   ABCC_PORT_EnterCritical();
+   HOST_BOOT_Begin( HOST_BOOT_RELEASE_RESET );
+   HOST_LOCK_Enter( sys_psControlLock );
    eStatus = TP_ProviderSpecificCommand( xPathHandle, &sMsg );
-   ABCC_PORT_ExitCritical();
+   HOST_LOCK_Exit( sys_psControlLock );
+   HOST_BOOT_End( HOST_BOOT_RELEASE_RESET );
 
 }
 
@@ -299,13 +490,13 @@ BOOL ABCC_HAL_ModuleDetect( void )
 #if( !ABCC_CFG_MEMORY_MAPPED_ACCESS_ENABLED )
 void* ABCC_HAL_ParallelGetRdPdBuffer( void )
 {
-   return( sys_abReadProcessData );
+   return( HOST_PD_BUFFER_Read() );
 }
 
 
 void* ABCC_HAL_ParallelGetWrPdBuffer( void )
 {
-   return( sys_abWriteProcessData );
+   return( HOST_PD_BUFFER_Write() );
 }
 #endif
 
@@ -321,54 +512,40 @@ void ABCC_HAL_SerSendReceive( void* pxTxDataBuffer, void* pxRxDataBuffer, UINT16
 
    TP_StatusType  eStatus;
    UINT16         iRdOffset;
-   UINT16         iTemp;
+   UINT64         llTraceNs;
 
-   ABCC_PORT_UseCritical();
-
-   ABCC_PORT_EnterCritical();
+   HOST_LOCK_Enter( &sys_sDataLock );
+   llTraceNs = HOST_TRACE_Begin();
    eStatus = TP_SerialWriteBlocking( xPathHandle, pxTxDataBuffer, iTxSize );
-   ABCC_PORT_ExitCritical();
+   HOST_TRACE_End( HOST_TRACE_CAT_HAL, "TP_SerialWrite", llTraceNs, iTxSize );
+   sys_lNumTpTransfers++;
+   HOST_LOCK_Exit( &sys_sDataLock );
 
    if (eStatus != TP_ERR_NONE )
    {
+      InterlockedIncrement( &sys_lNumTpErrors );
       ABCC_LOG_WARNING( ABCC_EC_HAL_ERR,
          (UINT32)eStatus,
          "Serial TX error: ERR: 0x%x", eStatus );
       return;
    }
 
-   iRdOffset = 0;
-   ABCC_PORT_EnterCritical();
-   while( iRdOffset < iRxSize )
+   /*
+   ** The reader thread collects the response. Wait for it without the data
+   ** lock. The timeout is the longest listed "Tsend" (175ms) plus some
+   ** arbitrary margin.
+   */
+   llTraceNs = HOST_TRACE_Begin();
+   eStatus = HOST_SERIAL_RX_Receive( (UINT8*)pxRxDataBuffer, iRxSize, 200, &iRdOffset );
+   HOST_TRACE_End( HOST_TRACE_CAT_HAL, "serial receive", llTraceNs, iRdOffset );
+   if( ( eStatus == TP_ERR_NONE ) && ( iRdOffset < iRxSize ) )
    {
-      iTemp = iRxSize - iRdOffset;
-      /*
-      ** The timeout is only used in the RX direction, so the longest
-      ** listed "Tsend" (175ms) plus some arbitrary margin ought to be
-      ** enough for the TP_SerialRead() call.
-      */
-      eStatus = TP_SerialRead( xPathHandle, (UINT8*)pxRxDataBuffer + iRdOffset, &iTemp, 200 );
-      if( eStatus == TP_ERR_NONE )
-      {
-         if( iTemp > 0 )
-         {
-            iRdOffset += iTemp;
-         }
-         else
-         {
-            ABCC_LOG_WARNING( ABCC_EC_HAL_ERR, 0, "Serial RX timeout!\n" );
-            break;
-         }
-      }
-      else
-      {
-         break;
-      }
+      ABCC_LOG_WARNING( ABCC_EC_HAL_ERR, 0, "Serial RX timeout!\n" );
    }
-   ABCC_PORT_ExitCritical();
 
    if ( eStatus != TP_ERR_NONE )
    {
+      InterlockedIncrement( &sys_lNumTpErrors );
       ABCC_LOG_WARNING( ABCC_EC_HAL_ERR,
          (UINT32)eStatus,
          "Serial RX error: ERR: 0x%x\n", eStatus );
@@ -384,19 +561,11 @@ void ABCC_HAL_SerSendReceive( void* pxTxDataBuffer, void* pxRxDataBuffer, UINT16
 
 void ABCC_HAL_SerRestart( void )
 {
-   UINT8          bTemp;
-   TP_StatusType  eStatus;
-   UINT16         iSize;
-
    /*
-   ** Empty the RX buffer in the TP system.
+   ** The reader thread keeps the RX buffer in the TP system empty. Throw
+   ** away what it has collected.
    */
-   do
-   {
-      iSize = 1;
-      eStatus = TP_SerialRead( xPathHandle, &bTemp, &iSize, 0 );
-   }
-   while( ( eStatus == TP_ERR_NONE ) && ( iSize > 0 ) );
+   HOST_SERIAL_RX_Flush();
 }
 #endif
 
@@ -453,7 +622,19 @@ BOOL ABCC_StartTransportProvider( void )
       return( TRUE );
    }
 
+   if( !sys_fLocksInitialised )
+   {
+      HOST_LOCK_Init( &sys_sDataLock, "data" );
+      HOST_LOCK_Init( &sys_sControlLock, "control" );
+#if( HOST_CFG_HAL_SPLIT_LOCKS )
+      sys_psControlLock = &sys_sControlLock;
+#endif
+      sys_fLocksInitialised = TRUE;
+   }
+
+   HOST_BOOT_Begin( HOST_BOOT_TP_INITIALISE );
    eStatus = TP_Initialise( "HMSTPRTR.DLL", 0x200 );
+   HOST_BOOT_End( HOST_BOOT_TP_INITIALISE );
 
    if ( eStatus != TP_ERR_NONE )
    {
@@ -461,6 +642,13 @@ BOOL ABCC_StartTransportProvider( void )
       return( FALSE );
    }
 
+   /*
+   ** Route the transfer functions through the fault injection layer. Nothing
+   ** is injected unless a fault is armed.
+   */
+   HOST_FAULT_Install();
+
+   HOST_BOOT_Begin( HOST_BOOT_PATH_SELECT );
    if( lPathId == 0 )
    {
       /*
@@ -477,6 +665,7 @@ BOOL ABCC_StartTransportProvider( void )
       */
       eStatus = TP_SelectPath( &eInterface, lPathId, &xPathHandle );
    }
+   HOST_BOOT_End( HOST_BOOT_PATH_SELECT );
 
    if( eStatus != TP_ERR_NONE )
    {
@@ -485,6 +674,7 @@ BOOL ABCC_StartTransportProvider( void )
    }
 
 
+   HOST_BOOT_Begin( HOST_BOOT_TP_OPEN );
    switch( eInterface )
    {
    case TP_SPI:
@@ -529,6 +719,12 @@ BOOL ABCC_StartTransportProvider( void )
        {
           ABCC_LOG_ERROR( ABCC_EC_HAL_ERR, (UINT32)eStatus, "TP_SerialOpen failed: %d\n", eStatus );
           return( FALSE );
+       }
+       if( !HOST_SERIAL_RX_Start( xPathHandle, &sys_sDataLock ) )
+       {
+          ABCC_LOG_ERROR( ABCC_EC_HAL_ERR, 0, "Could not start the serial receiver\n" );
+          TP_SerialClose( xPathHandle );
+          return( FALSE );
        }
         sys_bOpmode = ABP_OP_MODE_SERIAL_57_6;
        break;
@@ -540,6 +736,7 @@ BOOL ABCC_StartTransportProvider( void )
       return( FALSE );
       break;
    }
+   HOST_BOOT_End( HOST_BOOT_TP_OPEN );
 
    ABCC_HAL_HWReset();
 
@@ -566,6 +763,7 @@ void ABCC_CloseTransportProvider( void )
          TP_ParallelClose( xPathHandle );
          break;
       case TP_SERIAL:
+         HOST_SERIAL_RX_Stop();
          TP_SerialClose( xPathHandle );
 
       default:
@@ -11,9 +11,12 @@
 #include "abcc_software_port.h"
 #include "process.h"
 #include "windows.h"
+#include "host_trace.h"
 
 static HANDLE ghMutex = NULL;
 
+UINT8 ABCC_PORT_bLogLevel = 1;
+
 
 void ABCC_PORT_UseCriticalImpl( void )
 {
@@ -27,9 +30,21 @@ void ABCC_PORT_UseCriticalImpl( void )
 
 void ABCC_PORT_EnterCriticalImpl( void )
 {
+   UINT64 llTraceNs;
+
+   /*
+   ** Only a wait for another thread is traced.
+   */
+   if( WaitForSingleObject( ghMutex, 0 ) == WAIT_OBJECT_0 )
+   {
+      return;
+   }
+
+   llTraceNs = HOST_TRACE_Begin();
    WaitForSingleObject(
             ghMutex,    /* Handle to the mutex. */
             INFINITE);  /* No time-out interval. */
+   HOST_TRACE_End( HOST_TRACE_CAT_LOCK, "driver critical", llTraceNs, 0 );
 }
 
 void ABCC_PORT_ExitCriticalImpl( void )
@@ -19,9 +19,15 @@
 #include "abcc_types.h"
 #include "abcc_config.h"
 
-#define ABCC_PORT_printf( ... )          printf( __VA_ARGS__ )
+/*
+** Runtime log switch. 0 mutes all log output, any other value lets through
+** what ABCC_CFG_LOG_SEVERITY enables at compile time.
+*/
+EXTVAR UINT8 ABCC_PORT_bLogLevel;
+
+#define ABCC_PORT_printf( ... )          ( ABCC_PORT_bLogLevel ? printf( __VA_ARGS__ ) : 0 )
 
-#define ABCC_PORT_vprintf( ... )         vprintf( __VA_ARGS__ )
+#define ABCC_PORT_vprintf( ... )         ( ABCC_PORT_bLogLevel ? vprintf( __VA_ARGS__ ) : 0 )
 
 #define ABCC_PORT_UseCritical() ABCC_PORT_UseCriticalImpl()
 EXTFUNC void ABCC_PORT_UseCriticalImpl( void );
@@ -0,0 +1,251 @@
+/*******************************************************************************
+** Copyright 2025-present HMS Industrial Networks AB.
+** Licensed under the MIT License.
+********************************************************************************
+** File Description:
+** Boot path timing, from the Transport Provider start to PROCESS_ACTIVE.
+********************************************************************************
+*/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "host_time.h"
+#include "host_boot.h"
+
+/*------------------------------------------------------------------------------
+** Step names in the printout and the report file.
+**------------------------------------------------------------------------------
+*/
+static const char* const host_apacStepNames[ HOST_BOOT_NUM_STEPS ] =
+{
+   "tp_initialise",
+   "path_select",
+   "tp_open",
+   "hw_reset",
+   "release_reset",
+   "setup",
+   "user_init",
+   "nw_init",
+   "wait_process",
+   "process_active"
+};
+
+static UINT64 host_llBootStartUs;
+static UINT64 host_allStartUs[ HOST_BOOT_NUM_STEPS ];
+static UINT64 host_allEndUs[ HOST_BOOT_NUM_STEPS ];
+static BOOL8  host_afStarted[ HOST_BOOT_NUM_STEPS ];
+static BOOL8  host_afEnded[ HOST_BOOT_NUM_STEPS ];
+static UINT32 host_lBootNumber = 0;
+static BOOL8  host_fReported = FALSE;
+static FILE*  host_psReportFile = NULL;
+
+static UINT32 host_lNumCompleted = 0;
+static UINT64 host_llTotalActiveUs = 0;
+static UINT32 host_lMinActiveUs = 0;
+static UINT32 host_lMaxActiveUs = 0;
+
+static void Report( BOOL8 fComplete )
+{
+   UINT32 lActiveUs;
+   BOOL8  fFirst = TRUE;
+   UINT8  i;
+
+   lActiveUs = (UINT32)( host_allStartUs[ HOST_BOOT_PROCESS_ACTIVE ] - host_llBootStartUs );
+   if( fComplete )
+   {
+      printf( "Boot %lu reached PROCESS_ACTIVE after %.3fms:\n",
+              (unsigned long)host_lBootNumber, lActiveUs / 1000.0 );
+   }
+   else
+   {
+      printf( "Boot %lu did not reach PROCESS_ACTIVE:\n", (unsigned long)host_lBootNumber );
+   }
+   printf( " step                start ms      end ms\n" );
+   for( i = 0; i < HOST_BOOT_NUM_STEPS; i++ )
+   {
+      if( !host_afStarted[ i ] )
+      {
+         continue;
+      }
+      printf( " %-14s %11.3f", host_apacStepNames[ i ], ( host_allStartUs[ i ] - host_llBootStartUs ) / 1000.0 );
+      if( host_afEnded[ i ] && ( host_allEndUs[ i ] != host_allStartUs[ i ] ) )
+      {
+         printf( " %11.3f", ( host_allEndUs[ i ] - host_llBootStartUs ) / 1000.0 );
+      }
+      printf( "\n" );
+   }
+
+   if( host_psReportFile != NULL )
+   {
+      fprintf( host_psReportFile, "{\"boot\":%lu,\"complete\":%s,",
+               (unsigned long)host_lBootNumber, fComplete ? "true" : "false" );
+      if( fComplete )
+      {
+         fprintf( host_psReportFile, "\"process_active_us\":%lu,", (unsigned long)lActiveUs );
+      }
+      fprintf( host_psReportFile, "\"steps\":{" );
+      for( i = 0; i < HOST_BOOT_NUM_STEPS; i++ )
+      {
+         if( !host_afStarted[ i ] )
+         {
+            continue;
+         }
+         fprintf( host_psReportFile, "%s\"%s\":{\"start_us\":%llu",
+                  fFirst ? "" : ",",
+                  host_apacStepNames[ i ],
+                  (unsigned long long)( host_allStartUs[ i ] - host_llBootStartUs ) );
+         if( host_afEnded[ i ] )
+         {
+            fprintf( host_psReportFile, ",\"end_us\":%llu",
+                     (unsigned long long)( host_allEndUs[ i ] - host_llBootStartUs ) );
+         }
+         fprintf( host_psReportFile, "}" );
+         fFirst = FALSE;
+      }
+      fprintf( host_psReportFile, "}}\n" );
+      fflush( host_psReportFile );
+   }
+
+   if( fComplete )
+   {
+      if( ( host_lNumCompleted == 0 ) || ( lActiveUs < host_lMinActiveUs ) )
+      {
+         host_lMinActiveUs = lActiveUs;
+      }
+      if( lActiveUs > host_lMaxActiveUs )
+      {
+         host_lMaxActiveUs = lActiveUs;
+      }
+      host_llTotalActiveUs += lActiveUs;
+      host_lNumCompleted++;
+   }
+   host_fReported = TRUE;
+}
+
+static void NewBoot( void )
+{
+   host_llBootStartUs = HOST_TIME_GetUs();
+   memset( host_afStarted, 0, sizeof( host_afStarted ) );
+   memset( host_afEnded, 0, sizeof( host_afEnded ) );
+   host_lBootNumber++;
+   host_fReported = FALSE;
+}
+
+BOOL HOST_BOOT_Init( const char* pacReportFile )
+{
+   if( pacReportFile != NULL )
+   {
+      host_psReportFile = fopen( pacReportFile, "a" );
+      if( host_psReportFile == NULL )
+      {
+         printf( "Could not open boot report file %s\n", pacReportFile );
+         return( FALSE );
+      }
+   }
+
+   host_lBootNumber = 0;
+   NewBoot();
+   return( TRUE );
+}
+
+void HOST_BOOT_Close( void )
+{
+   UINT8 i;
+
+   /*
+   ** Report the current boot if anything of it was marked.
+   */
+   for( i = 0; ( i < HOST_BOOT_NUM_STEPS ) && !host_fReported; i++ )
+   {
+      if( host_afStarted[ i ] )
+      {
+         Report( FALSE );
+      }
+   }
+   if( host_psReportFile != NULL )
+   {
+      fclose( host_psReportFile );
+      host_psReportFile = NULL;
+   }
+}
+
+void HOST_BOOT_Begin( HOST_BOOT_StepType eStep )
+{
+   /*
+   ** A reset after the previous one was released is a restart.
+   */
+   if( ( eStep == HOST_BOOT_HW_RESET ) && host_afEnded[ HOST_BOOT_RELEASE_RESET ] )
+   {
+      if( !host_fReported )
+      {
+         Report( FALSE );
+      }
+      NewBoot();
+   }
+
+   if( !host_afStarted[ eStep ] )
+   {
+      host_allStartUs[ eStep ] = HOST_TIME_GetUs();
+      host_afStarted[ eStep ] = TRUE;
+   }
+}
+
+void HOST_BOOT_End( HOST_BOOT_StepType eStep )
+{
+   if( host_afStarted[ eStep ] && !host_afEnded[ eStep ] )
+   {
+      host_allEndUs[ eStep ] = HOST_TIME_GetUs();
+      host_afEnded[ eStep ] = TRUE;
+   }
+}
+
+void HOST_BOOT_Mark( HOST_BOOT_StepType eStep )
+{
+   HOST_BOOT_Begin( eStep );
+   HOST_BOOT_End( eStep );
+}
+
+void HOST_BOOT_AnbState( ABP_AnbStateType eState )
+{
+   switch( eState )
+   {
+   case ABP_ANB_STATE_SETUP:
+      HOST_BOOT_Mark( HOST_BOOT_SETUP );
+      break;
+
+   case ABP_ANB_STATE_NW_INIT:
+      HOST_BOOT_Mark( HOST_BOOT_NW_INIT );
+      break;
+
+   case ABP_ANB_STATE_WAIT_PROCESS:
+      HOST_BOOT_Mark( HOST_BOOT_WAIT_PROCESS );
+      break;
+
+   case ABP_ANB_STATE_PROCESS_ACTIVE:
+      HOST_BOOT_Mark( HOST_BOOT_PROCESS_ACTIVE );
+      if( !host_fReported )
+      {
+         Report( TRUE );
+      }
+      break;
+
+   default:
+      break;
+   }
+}
+
+void HOST_BOOT_PrintStats( void )
+{
+   printf( "Boots:\n" );
+   printf( " %lu started, %lu reached PROCESS_ACTIVE",
+           (unsigned long)host_lBootNumber, (unsigned long)host_lNumCompleted );
+   if( host_lNumCompleted > 0 )
+   {
+      printf( ", time to PROCESS_ACTIVE min %.3fms, mean %.3fms, max %.3fms",
+              host_lMinActiveUs / 1000.0,
+              (double)host_llTotalActiveUs / host_lNumCompleted / 1000.0,
+              host_lMaxActiveUs / 1000.0 );
+   }
+   printf( "\n" );
+}
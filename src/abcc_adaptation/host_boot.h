@@ -0,0 +1,101 @@
+/*******************************************************************************
+** Copyright 2025-present HMS Industrial Networks AB.
+** Licensed under the MIT License.
+********************************************************************************
+** File Description:
+** Boot path timing, from the Transport Provider start to PROCESS_ACTIVE.
+**
+** The HAL and the main loop mark each step of a boot. Times are taken with
+** HOST_TIME_GetUs() and reported relative to the start of the boot. A step
+** that occurs several times during one boot keeps its first start and its
+** first end.
+**
+** The first boot starts with HOST_BOOT_Init(). A hardware reset after the
+** previous reset has been released starts a new boot, which is how a driver
+** restart shows up, so every restart gets its own report. When the ABCC
+** reaches PROCESS_ACTIVE the boot report is printed and, if a report file is
+** open, appended to it as one JSON object per line:
+**
+**    {"boot":1,"complete":true,"process_active_us":812345,"steps":{
+**     "tp_initialise":{"start_us":12,"end_us":3410},...}}
+**
+** A boot that is superseded by a new reset before PROCESS_ACTIVE is reported
+** with "complete":false.
+********************************************************************************
+*/
+
+#ifndef HOST_BOOT_H_
+#define HOST_BOOT_H_
+
+#include "abcc_types.h"
+#include "abp.h"
+
+/*------------------------------------------------------------------------------
+** Boot steps, in the order they normally occur.
+**------------------------------------------------------------------------------
+*/
+typedef enum HOST_BOOT_StepType
+{
+   HOST_BOOT_TP_INITIALISE,
+   HOST_BOOT_PATH_SELECT,
+   HOST_BOOT_TP_OPEN,
+   HOST_BOOT_HW_RESET,
+   HOST_BOOT_RELEASE_RESET,
+   HOST_BOOT_SETUP,
+   HOST_BOOT_USER_INIT,
+   HOST_BOOT_NW_INIT,
+   HOST_BOOT_WAIT_PROCESS,
+   HOST_BOOT_PROCESS_ACTIVE,
+   HOST_BOOT_NUM_STEPS
+}
+HOST_BOOT_StepType;
+
+/*------------------------------------------------------------------------------
+** HOST_BOOT_Init()
+** Starts the first boot. HOST_TIME_Init() must have been called.
+**------------------------------------------------------------------------------
+** Inputs:
+**    pacReportFile  - File the boot reports are appended to, NULL for
+**                     console output only.
+**
+** Outputs:
+**    Returns:       - FALSE if the report file could not be opened.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC BOOL HOST_BOOT_Init( const char* pacReportFile );
+
+/*------------------------------------------------------------------------------
+** HOST_BOOT_Close()
+** Reports an unfinished boot and closes the report file.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void HOST_BOOT_Close( void );
+
+/*------------------------------------------------------------------------------
+** HOST_BOOT_Begin()
+** HOST_BOOT_End()
+** Mark the start and end of a step. HOST_BOOT_Mark() marks a step without
+** duration.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void HOST_BOOT_Begin( HOST_BOOT_StepType eStep );
+EXTFUNC void HOST_BOOT_End( HOST_BOOT_StepType eStep );
+EXTFUNC void HOST_BOOT_Mark( HOST_BOOT_StepType eStep );
+
+/*------------------------------------------------------------------------------
+** HOST_BOOT_AnbState()
+** Marks the step of a newly entered ANB state. Reaching PROCESS_ACTIVE
+** completes the boot and writes its report.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void HOST_BOOT_AnbState( ABP_AnbStateType eState );
+
+/*------------------------------------------------------------------------------
+** HOST_BOOT_PrintStats()
+** Prints the number of boots and the time to PROCESS_ACTIVE over all
+** completed boots.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void HOST_BOOT_PrintStats( void );
+
+#endif  /* inclusion lock */
@@ -0,0 +1,111 @@
+/*******************************************************************************
+** Copyright 2025-present HMS Industrial Networks AB.
+** Licensed under the MIT License.
+********************************************************************************
+** File Description:
+** Per cycle time budget with load shedding.
+********************************************************************************
+*/
+
+#include "stdio.h"
+#include "string.h"
+
+#include "host_trace.h"
+#include "host_budget.h"
+
+static HOST_BUDGET_StatsType host_sStats;
+static volatile BOOL8        host_fShedding = FALSE;
+static UINT32                host_lRecoverUs;
+static UINT32                host_lQuietCycles;
+static UINT32                host_lShedCycles;
+
+void HOST_BUDGET_Init( UINT32 lBudgetUs )
+{
+   memset( &host_sStats, 0, sizeof( host_sStats ) );
+   host_sStats.lBudgetUs = lBudgetUs;
+   host_lRecoverUs = (UINT32)( (UINT64)lBudgetUs * HOST_CFG_BUDGET_RECOVER_PERCENT / 100 );
+   host_fShedding = FALSE;
+   host_lQuietCycles = 0;
+   host_lShedCycles = 0;
+}
+
+BOOL8 HOST_BUDGET_EndCycle( UINT32 lWorkUs )
+{
+   host_sStats.lNumCycles++;
+   if( lWorkUs > host_sStats.lMaxWorkUs )
+   {
+      host_sStats.lMaxWorkUs = lWorkUs;
+   }
+
+   if( lWorkUs > host_sStats.lBudgetUs )
+   {
+      host_sStats.lNumOverruns++;
+      HOST_TRACE_Instant( HOST_TRACE_CAT_HOST, "budget overrun", lWorkUs );
+   }
+
+   if( !host_fShedding )
+   {
+      if( lWorkUs <= host_sStats.lBudgetUs )
+      {
+         return( FALSE );
+      }
+      host_fShedding = TRUE;
+      host_sStats.lNumShedEvents++;
+      host_lQuietCycles = 0;
+      host_lShedCycles = 0;
+      HOST_TRACE_Instant( HOST_TRACE_CAT_HOST, "shedding started", lWorkUs );
+      return( TRUE );
+   }
+
+   host_sStats.lNumShedCycles++;
+   host_lShedCycles++;
+   host_lQuietCycles = ( lWorkUs < host_lRecoverUs ) ? host_lQuietCycles + 1 : 0;
+   if( host_lQuietCycles < HOST_CFG_BUDGET_RECOVER_CYCLES )
+   {
+      return( FALSE );
+   }
+
+   host_fShedding = FALSE;
+   if( host_lShedCycles > host_sStats.lLongestShedCycles )
+   {
+      host_sStats.lLongestShedCycles = host_lShedCycles;
+   }
+   HOST_TRACE_Instant( HOST_TRACE_CAT_HOST, "shedding ended", host_lShedCycles );
+   return( TRUE );
+}
+
+BOOL8 HOST_BUDGET_IsShedding( void )
+{
+   return( host_fShedding );
+}
+
+void HOST_BUDGET_GetStats( HOST_BUDGET_StatsType* psStats )
+{
+   *psStats = host_sStats;
+
+   /*
+   ** Count a shedding period that is still going on.
+   */
+   if( host_fShedding && ( host_lShedCycles > psStats->lLongestShedCycles ) )
+   {
+      psStats->lLongestShedCycles = host_lShedCycles;
+   }
+}
+
+void HOST_BUDGET_PrintStats( void )
+{
+   HOST_BUDGET_StatsType sStats;
+
+   HOST_BUDGET_GetStats( &sStats );
+   printf( "Cycle budget:\n" );
+   printf( " %luus budget, %lu of %lu cycles over, longest %luus\n",
+           (unsigned long)sStats.lBudgetUs,
+           (unsigned long)sStats.lNumOverruns,
+           (unsigned long)sStats.lNumCycles,
+           (unsigned long)sStats.lMaxWorkUs );
+   printf( " shedding started %lu times, %lu cycles shed, longest %lu cycles%s\n",
+           (unsigned long)sStats.lNumShedEvents,
+           (unsigned long)sStats.lNumShedCycles,
+           (unsigned long)sStats.lLongestShedCycles,
+           host_fShedding ? ", shedding now" : "" );
+}
@@ -0,0 +1,90 @@
+/*******************************************************************************
+** Copyright 2025-present HMS Industrial Networks AB.
+** Licensed under the MIT License.
+********************************************************************************
+** File Description:
+** Per cycle time budget with load shedding.
+**
+** The main loop reports the time spent in ABCC_API_Run() every cycle. With
+** the IRQ pin polled, ABCC_API_CbfCyclicalProcessing() is called from within
+** ABCC_API_Run(), so its time is included. A cycle that takes longer than
+** the budget is an overrun.
+**
+** An overrun starts load shedding. While shedding, the application defers
+** work that the communication does not depend on: statistics aggregation,
+** the statistics and trace printouts, verbose logging and recording to the
+** jitter CSV and the PD capture file. A quit request is still handled. Shedding ends after HOST_CFG_BUDGET_RECOVER_CYCLES
+** consecutive cycles below HOST_CFG_BUDGET_RECOVER_PERCENT of the budget.
+**
+** The overrun and shedding figures show how much headroom the host has, and
+** are the basis for sizing it.
+********************************************************************************
+*/
+
+#ifndef HOST_BUDGET_H_
+#define HOST_BUDGET_H_
+
+#include "abcc_types.h"
+#include "abcc_config.h"
+
+/*------------------------------------------------------------------------------
+** Statistics.
+**
+** lBudgetUs          - Budget per cycle.
+** lNumCycles         - Number of cycles reported.
+** lNumOverruns       - Number of cycles over the budget.
+** lMaxWorkUs         - Longest cycle.
+** lNumShedEvents     - Number of times shedding started.
+** lNumShedCycles     - Number of cycles spent shedding.
+** lLongestShedCycles - Longest shedding period in cycles.
+**------------------------------------------------------------------------------
+*/
+typedef struct HOST_BUDGET_StatsType
+{
+   UINT32 lBudgetUs;
+   UINT32 lNumCycles;
+   UINT32 lNumOverruns;
+   UINT32 lMaxWorkUs;
+   UINT32 lNumShedEvents;
+   UINT32 lNumShedCycles;
+   UINT32 lLongestShedCycles;
+}
+HOST_BUDGET_StatsType;
+
+/*------------------------------------------------------------------------------
+** HOST_BUDGET_Init()
+** Sets the budget and clears the statistics.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void HOST_BUDGET_Init( UINT32 lBudgetUs );
+
+/*------------------------------------------------------------------------------
+** HOST_BUDGET_EndCycle()
+** Reports the time spent in one cycle.
+**------------------------------------------------------------------------------
+** Inputs:
+**    lWorkUs     - Time spent in ABCC_API_Run() this cycle.
+**
+** Outputs:
+**    Returns:    - TRUE if shedding started or ended with this cycle.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC BOOL8 HOST_BUDGET_EndCycle( UINT32 lWorkUs );
+
+/*------------------------------------------------------------------------------
+** HOST_BUDGET_IsShedding()
+** TRUE while non-critical work is to be deferred.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC BOOL8 HOST_BUDGET_IsShedding( void );
+
+/*------------------------------------------------------------------------------
+** HOST_BUDGET_GetStats()
+** HOST_BUDGET_PrintStats()
+** Read or print the statistics.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void HOST_BUDGET_GetStats( HOST_BUDGET_StatsType* psStats );
+EXTFUNC void HOST_BUDGET_PrintStats( void );
+
+#endif  /* inclusion lock */
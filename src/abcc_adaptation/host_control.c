@@ -0,0 +1,235 @@
+/*******************************************************************************
+** Copyright 2025-present HMS Industrial Networks AB.
+** Licensed under the MIT License.
+********************************************************************************
+** File Description:
+** Out-of-band control of the host application, used in headless mode.
+********************************************************************************
+*/
+
+#include "windows.h"
+#include "process.h"
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+
+#include "abcc_driver_config.h"
+#include "abcc_software_port.h"
+#include "host_control.h"
+
+#define HOST_CONTROL_BUFFER_SIZE                   ( 256 )
+
+static volatile LONG host_lRequests = 0;
+static volatile LONG host_lStopThread = FALSE;
+static HANDLE        host_hControlThread = NULL;
+static const char*   host_pacPipeName = NULL;
+static HANDLE        host_hShutdownDone = NULL;
+
+static BOOL WINAPI ConsoleCtrlHandler( DWORD lCtrlType )
+{
+   /*
+   ** Every control event means "stop": Ctrl+C, Ctrl+Break, console close,
+   ** logoff and shutdown.
+   */
+   InterlockedOr( &host_lRequests, HOST_CONTROL_REQ_QUIT );
+
+   /*
+   ** For Ctrl+C and Ctrl+Break the process lives on after the handler
+   ** returns. For the other events Windows ends it as soon as the handler
+   ** returns, so hold this thread until HOST_CONTROL_Stop() reports that
+   ** the main loop has shut down the driver, or the timeout expires.
+   */
+   if( ( ( lCtrlType == CTRL_CLOSE_EVENT ) ||
+         ( lCtrlType == CTRL_LOGOFF_EVENT ) ||
+         ( lCtrlType == CTRL_SHUTDOWN_EVENT ) ) &&
+       ( host_hShutdownDone != NULL ) )
+   {
+      WaitForSingleObject( host_hShutdownDone, HOST_CFG_CONTROL_SHUTDOWN_TIMEOUT_MS );
+   }
+
+   return( TRUE );
+}
+
+/*------------------------------------------------------------------------------
+** Executes one command line and writes the reply to pacReply.
+**------------------------------------------------------------------------------
+*/
+static void HandleCommand( char* pacCommand, char* pacReply, size_t iReplySize )
+{
+   char* pacArgument;
+   long  lLevel;
+
+   /*
+   ** Strip trailing line endings and split off the argument.
+   */
+   pacCommand[ strcspn( pacCommand, "\r\n" ) ] = '\0';
+   pacArgument = strchr( pacCommand, ' ' );
+   if( pacArgument != NULL )
+   {
+      *pacArgument++ = '\0';
+   }
+
+   if( strcmp( pacCommand, "quit" ) == 0 )
+   {
+      InterlockedOr( &host_lRequests, HOST_CONTROL_REQ_QUIT );
+      _snprintf_s( pacReply, iReplySize, _TRUNCATE, "OK shutting down\n" );
+   }
+   else if( strcmp( pacCommand, "stats" ) == 0 )
+   {
+      InterlockedOr( &host_lRequests, HOST_CONTROL_REQ_STATS );
+      _snprintf_s( pacReply, iReplySize, _TRUNCATE, "OK statistics written to the log\n" );
+   }
+   else if( strcmp( pacCommand, "trace" ) == 0 )
+   {
+      InterlockedOr( &host_lRequests, HOST_CONTROL_REQ_TRACE );
+      _snprintf_s( pacReply, iReplySize, _TRUNCATE, "OK trace requested\n" );
+   }
+   else if( ( strcmp( pacCommand, "loglevel" ) == 0 ) && ( pacArgument != NULL ) )
+   {
+      lLevel = strtol( pacArgument, NULL, 0 );
+      ABCC_PORT_bLogLevel = (UINT8)( lLevel > 0 ? lLevel : 0 );
+      _snprintf_s( pacReply, iReplySize, _TRUNCATE, "OK log level %u\n", ABCC_PORT_bLogLevel );
+   }
+   else if( strcmp( pacCommand, "help" ) == 0 )
+   {
+      _snprintf_s( pacReply, iReplySize, _TRUNCATE,
+                   "OK commands: quit, stats, trace, loglevel <n>, help\n" );
+   }
+   else
+   {
+      _snprintf_s( pacReply, iReplySize, _TRUNCATE, "ERROR unknown command '%s'\n", pacCommand );
+   }
+}
+
+/*------------------------------------------------------------------------------
+** Serves one client at a time: one command per message, one reply per
+** command.
+**------------------------------------------------------------------------------
+*/
+static unsigned __stdcall ControlThread( void* pxArg )
+{
+   char   acCommand[ HOST_CONTROL_BUFFER_SIZE ];
+   char   acReply[ HOST_CONTROL_BUFFER_SIZE ];
+   HANDLE hPipe = (HANDLE)pxArg;
+   DWORD  lRead;
+   DWORD  lWritten;
+
+   while( !host_lStopThread )
+   {
+      if( !ConnectNamedPipe( hPipe, NULL ) &&
+          ( GetLastError() != ERROR_PIPE_CONNECTED ) )
+      {
+         Sleep( 100 );
+         continue;
+      }
+
+      while( !host_lStopThread &&
+             ReadFile( hPipe, acCommand, sizeof( acCommand ) - 1, &lRead, NULL ) &&
+             ( lRead > 0 ) )
+      {
+         acCommand[ lRead ] = '\0';
+         HandleCommand( acCommand, acReply, sizeof( acReply ) );
+         WriteFile( hPipe, acReply, (DWORD)strlen( acReply ), &lWritten, NULL );
+      }
+
+      DisconnectNamedPipe( hPipe );
+   }
+
+   CloseHandle( hPipe );
+   _endthreadex( 0 );
+   return( 0 );
+}
+
+BOOL HOST_CONTROL_Start( const char* pacPipeName )
+{
+   HANDLE hPipe;
+
+   /*
+   ** Manual reset, so every waiting handler call is released. If it can not
+   ** be created the handler only requests the shutdown.
+   */
+   host_hShutdownDone = CreateEvent( NULL, TRUE, FALSE, NULL );
+   SetConsoleCtrlHandler( ConsoleCtrlHandler, TRUE );
+
+   if( pacPipeName == NULL )
+   {
+      return( TRUE );
+   }
+
+   hPipe = CreateNamedPipeA( pacPipeName,
+                             PIPE_ACCESS_DUPLEX,
+                             PIPE_TYPE_MESSAGE | PIPE_READMODE_MESSAGE | PIPE_WAIT | PIPE_REJECT_REMOTE_CLIENTS,
+                             1,                            /* One client at a time. */
+                             HOST_CONTROL_BUFFER_SIZE,
+                             HOST_CONTROL_BUFFER_SIZE,
+                             0,
+                             NULL );
+   if( hPipe == INVALID_HANDLE_VALUE )
+   {
+      printf( "Could not create control pipe %s (error %lu)\n", pacPipeName, GetLastError() );
+      return( FALSE );
+   }
+
+   host_pacPipeName = pacPipeName;
+   host_lStopThread = FALSE;
+   host_hControlThread = (HANDLE)_beginthreadex( NULL, 0, &ControlThread, hPipe, 0, NULL );
+   if( host_hControlThread == NULL )
+   {
+      CloseHandle( hPipe );
+      return( FALSE );
+   }
+
+   return( TRUE );
+}
+
+void HOST_CONTROL_Stop( void )
+{
+   HANDLE hWakeUp;
+
+   if( host_hControlThread != NULL )
+   {
+      host_lStopThread = TRUE;
+
+      /*
+      ** Connect once to release the thread from ConnectNamedPipe(). If a
+      ** client is already connected, cancel its pending read instead.
+      */
+      hWakeUp = CreateFileA( host_pacPipeName, GENERIC_READ | GENERIC_WRITE, 0, NULL, OPEN_EXISTING, 0, NULL );
+      if( hWakeUp != INVALID_HANDLE_VALUE )
+      {
+         CloseHandle( hWakeUp );
+      }
+      else
+      {
+         CancelSynchronousIo( host_hControlThread );
+      }
+
+      WaitForSingleObject( host_hControlThread, INFINITE );
+      CloseHandle( host_hControlThread );
+      host_hControlThread = NULL;
+   }
+
+   SetConsoleCtrlHandler( ConsoleCtrlHandler, FALSE );
+
+   /*
+   ** Release a handler waiting for the shutdown. The event is not closed, the
+   ** handler may still be waiting on it, it is freed at process exit.
+   */
+   if( host_hShutdownDone != NULL )
+   {
+      SetEvent( host_hShutdownDone );
+   }
+}
+
+UINT32 HOST_CONTROL_TakeRequests( void )
+{
+   /*
+   ** Plain read first, the interlocked exchange is only needed when something
+   ** is pending.
+   */
+   if( host_lRequests == 0 )
+   {
+      return( 0 );
+   }
+   return( (UINT32)InterlockedExchange( &host_lRequests, 0 ) );
+}
@@ -0,0 +1,68 @@
+/*******************************************************************************
+** Copyright 2025-present HMS Industrial Networks AB.
+** Licensed under the MIT License.
+********************************************************************************
+** File Description:
+** Out-of-band control of the host application, used in headless mode.
+**
+** Shutdown is requested through the console control handler (Ctrl+C,
+** Ctrl+Break, console close, logoff and system shutdown) and a local named
+** pipe accepts text commands:
+**    quit           - Shut down the application.
+**    stats          - Print the statistics.
+**    loglevel <n>   - 0 mutes all log output, any other value restores it.
+**    trace          - Write the trace file, when started with --trace.
+**    help           - List the commands.
+**
+** All I/O runs in a separate thread. The main loop only reads a flag word per
+** iteration through HOST_CONTROL_TakeRequests().
+********************************************************************************
+*/
+
+#ifndef HOST_CONTROL_H_
+#define HOST_CONTROL_H_
+
+#include "abcc_types.h"
+
+/*------------------------------------------------------------------------------
+** Request flags returned by HOST_CONTROL_TakeRequests().
+**------------------------------------------------------------------------------
+*/
+#define HOST_CONTROL_REQ_QUIT                      ( 0x01 )
+#define HOST_CONTROL_REQ_STATS                     ( 0x02 )
+#define HOST_CONTROL_REQ_TRACE                     ( 0x04 )
+
+/*------------------------------------------------------------------------------
+** HOST_CONTROL_Start()
+** Installs the console control handler and, if a pipe name is given, starts
+** the control channel thread.
+**------------------------------------------------------------------------------
+** Inputs:
+**    pacPipeName - Name of the control pipe, e.g. "\\\\.\\pipe\\abcc". NULL
+**                  disables the control channel.
+**
+** Outputs:
+**    Returns:    - FALSE if the control channel could not be started.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC BOOL HOST_CONTROL_Start( const char* pacPipeName );
+
+/*------------------------------------------------------------------------------
+** HOST_CONTROL_Stop()
+** Stops the control channel thread and removes the console control handler.
+** Call it last, after the driver has been shut down: a console close, logoff
+** or system shutdown event holds the process until this call, for at most
+** HOST_CFG_CONTROL_SHUTDOWN_TIMEOUT_MS.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void HOST_CONTROL_Stop( void );
+
+/*------------------------------------------------------------------------------
+** HOST_CONTROL_TakeRequests()
+** Returns and clears the pending HOST_CONTROL_REQ_ flags. Cheap enough to be
+** called every main loop iteration.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC UINT32 HOST_CONTROL_TakeRequests( void );
+
+#endif  /* inclusion lock */
@@ -0,0 +1,253 @@
+/*******************************************************************************
+** Copyright 2025-present HMS Industrial Networks AB.
+** Licensed under the MIT License.
+********************************************************************************
+** File Description:
+** Constant-time dispatch table keyed on object/instance/attribute.
+********************************************************************************
+*/
+
+#include "host_dispatch.h"
+
+/*------------------------------------------------------------------------------
+** Displacements are searched up to this value. Bit 15 of a displacement word
+** marks a bucket that has not been placed yet during the build.
+**------------------------------------------------------------------------------
+*/
+#define HOST_DISPATCH_MAX_DISPLACEMENT             ( 0x7FFF )
+#define HOST_DISPATCH_UNPLACED                     ( 0x8000 )
+
+#define GetEntryKey( psEntry )                                                  \
+   HOST_DISPATCH_KEY( ( psEntry )->bObject, ( psEntry )->iInstance, ( psEntry )->bAttribute )
+
+/*------------------------------------------------------------------------------
+** 32-bit integer finaliser. Every key bit affects every result bit, so
+** structured keys such as consecutive attributes spread evenly.
+**------------------------------------------------------------------------------
+*/
+static UINT32 Mix( UINT32 lValue )
+{
+   lValue ^= lValue >> 16;
+   lValue *= 0x7FEB352DUL;
+   lValue ^= lValue >> 15;
+   lValue *= 0x846CA68BUL;
+   lValue ^= lValue >> 16;
+   return( lValue );
+}
+
+#define GetBucket( psTable, lKey )                                              \
+   ( (UINT16)( Mix( lKey ) & ( psTable )->iBucketMask ) )
+
+#define GetSlot( psTable, lKey, iDisplacement )                                 \
+   ( (UINT16)( Mix( ( lKey ) ^ ( 0x9E3779B9UL * ( (UINT32)( iDisplacement ) + 1 ) ) ) & \
+               ( psTable )->iSlotMask ) )
+
+/*------------------------------------------------------------------------------
+** Tries to place every entry of a bucket with one displacement. Returns FALSE,
+** with the slots of this attempt cleared again, if two keys collide.
+**------------------------------------------------------------------------------
+*/
+static BOOL PlaceBucket( HOST_DISPATCH_Type* psTable, UINT16 iBucket, UINT16 iDisplacement )
+{
+   UINT32 lKey;
+   UINT16 iSlot;
+   UINT16 i;
+   UINT16 j;
+
+   for( i = 0; i < psTable->iNumEntries; i++ )
+   {
+      lKey = GetEntryKey( &psTable->pasEntries[ i ] );
+      if( GetBucket( psTable, lKey ) != iBucket )
+      {
+         continue;
+      }
+
+      iSlot = GetSlot( psTable, lKey, iDisplacement );
+      if( psTable->paiSlots[ iSlot ] != HOST_DISPATCH_EMPTY_SLOT )
+      {
+         /*
+         ** Undo the entries placed so far in this attempt, they are the ones
+         ** before i in the same bucket.
+         */
+         for( j = 0; j < i; j++ )
+         {
+            lKey = GetEntryKey( &psTable->pasEntries[ j ] );
+            if( GetBucket( psTable, lKey ) == iBucket )
+            {
+               psTable->paiSlots[ GetSlot( psTable, lKey, iDisplacement ) ] = HOST_DISPATCH_EMPTY_SLOT;
+            }
+         }
+         return( FALSE );
+      }
+      psTable->paiSlots[ iSlot ] = i;
+   }
+
+   return( TRUE );
+}
+
+BOOL HOST_DISPATCH_Build( HOST_DISPATCH_Type* psTable,
+                          const HOST_DISPATCH_EntryType* pasEntries,
+                          UINT16 iNumEntries,
+                          UINT16* paiSlots,
+                          UINT16 iNumSlots )
+{
+   UINT32 lNumBuckets;
+   UINT32 lNumSlots;
+   UINT16 iMaxSize;
+   UINT16 iSize;
+   UINT16 iDisplacement;
+   UINT16 i;
+   UINT16 j;
+
+   psTable->pasEntries = pasEntries;
+   psTable->iNumEntries = 0;
+
+   if( iNumEntries >= HOST_DISPATCH_EMPTY_SLOT )
+   {
+      return( FALSE );
+   }
+
+   /*
+   ** A perfect hash can not separate duplicates, reject them up front.
+   */
+   for( i = 0; i < iNumEntries; i++ )
+   {
+      for( j = (UINT16)( i + 1 ); j < iNumEntries; j++ )
+      {
+         if( GetEntryKey( &pasEntries[ i ] ) == GetEntryKey( &pasEntries[ j ] ) )
+         {
+            return( FALSE );
+         }
+      }
+   }
+
+   /*
+   ** About four keys per bucket, and at least twice as many slots as keys.
+   ** Both are powers of two so that a lookup masks instead of dividing.
+   */
+   lNumBuckets = 1;
+   while( lNumBuckets * 4 < iNumEntries )
+   {
+      lNumBuckets <<= 1;
+   }
+   lNumSlots = 2;
+   while( lNumSlots < 2UL * iNumEntries )
+   {
+      lNumSlots <<= 1;
+   }
+   if( lNumBuckets + lNumSlots > iNumSlots )
+   {
+      return( FALSE );
+   }
+
+   psTable->paiDisplacements = paiSlots;
+   psTable->paiSlots = paiSlots + lNumBuckets;
+   psTable->iBucketMask = (UINT16)( lNumBuckets - 1 );
+   psTable->iSlotMask = (UINT16)( lNumSlots - 1 );
+   psTable->iNumEntries = iNumEntries;
+
+   /*
+   ** Count the keys per bucket in the displacement words.
+   */
+   for( i = 0; i < lNumBuckets; i++ )
+   {
+      psTable->paiDisplacements[ i ] = HOST_DISPATCH_UNPLACED;
+   }
+   for( i = 0; i < lNumSlots; i++ )
+   {
+      psTable->paiSlots[ i ] = HOST_DISPATCH_EMPTY_SLOT;
+   }
+   iMaxSize = 0;
+   for( i = 0; i < iNumEntries; i++ )
+   {
+      iSize = (UINT16)( ++psTable->paiDisplacements[ GetBucket( psTable, GetEntryKey( &pasEntries[ i ] ) ) ] &
+                        ~HOST_DISPATCH_UNPLACED );
+      if( iSize > iMaxSize )
+      {
+         iMaxSize = iSize;
+      }
+   }
+
+   /*
+   ** Hash and displace: the largest buckets are placed first, while the
+   ** table is still empty. Each bucket gets the first displacement that puts
+   ** all of its keys in free slots. With half of the slots free at the end,
+   ** a displacement is found after a few attempts.
+   */
+   for( iSize = iMaxSize; iSize > 0; iSize-- )
+   {
+      for( i = 0; i < lNumBuckets; i++ )
+      {
+         if( psTable->paiDisplacements[ i ] != ( HOST_DISPATCH_UNPLACED | iSize ) )
+         {
+            continue;
+         }
+
+         for( iDisplacement = 0; iDisplacement <= HOST_DISPATCH_MAX_DISPLACEMENT; iDisplacement++ )
+         {
+            if( PlaceBucket( psTable, i, iDisplacement ) )
+            {
+               break;
+            }
+         }
+         if( iDisplacement > HOST_DISPATCH_MAX_DISPLACEMENT )
+         {
+            psTable->iNumEntries = 0;
+            return( FALSE );
+         }
+         psTable->paiDisplacements[ i ] = iDisplacement;
+      }
+   }
+
+   /*
+   ** Empty buckets still hold the unplaced mark, any displacement will do.
+   */
+   for( i = 0; i < lNumBuckets; i++ )
+   {
+      psTable->paiDisplacements[ i ] &= HOST_DISPATCH_MAX_DISPLACEMENT;
+   }
+
+   return( TRUE );
+}
+
+UINT16 HOST_DISPATCH_GetIndex( const HOST_DISPATCH_Type* psTable,
+                               UINT8 bObject,
+                               UINT16 iInstance,
+                               UINT8 bAttribute )
+{
+   UINT32 lKey;
+   UINT16 iIndex;
+
+   if( psTable->iNumEntries == 0 )
+   {
+      return( HOST_DISPATCH_EMPTY_SLOT );
+   }
+
+   lKey = HOST_DISPATCH_KEY( bObject, iInstance, bAttribute );
+   iIndex = psTable->paiSlots[ GetSlot( psTable, lKey,
+                                        psTable->paiDisplacements[ GetBucket( psTable, lKey ) ] ) ];
+
+   if( ( iIndex == HOST_DISPATCH_EMPTY_SLOT ) ||
+       ( GetEntryKey( &psTable->pasEntries[ iIndex ] ) != lKey ) )
+   {
+      return( HOST_DISPATCH_EMPTY_SLOT );
+   }
+
+   return( iIndex );
+}
+
+const HOST_DISPATCH_EntryType* HOST_DISPATCH_Lookup( const HOST_DISPATCH_Type* psTable,
+                                                    UINT8 bObject,
+                                                    UINT16 iInstance,
+                                                    UINT8 bAttribute )
+{
+   UINT16 iIndex;
+
+   iIndex = HOST_DISPATCH_GetIndex( psTable, bObject, iInstance, bAttribute );
+   if( iIndex == HOST_DISPATCH_EMPTY_SLOT )
+   {
+      return( NULL );
+   }
+
+   return( &psTable->pasEntries[ iIndex ] );
+}
@@ -0,0 +1,140 @@
+/*******************************************************************************
+** Copyright 2025-present HMS Industrial Networks AB.
+** Licensed under the MIT License.
+********************************************************************************
+** File Description:
+** Constant-time dispatch table keyed on object/instance/attribute.
+**
+** The table is built once from a constant entry list. The build step uses
+** hash and displace: keys are hashed into small buckets, and each bucket is
+** given a displacement that moves all of its keys to free slots. The result
+** maps every key to its own slot (a perfect hash), so a lookup is always two
+** hashes, two table reads and one key compare, regardless of how many entries
+** the list holds or how irregular the keys are.
+**
+** The driver's own command response list, ABCC_API_COMMAND_RESPONSE_LIST, is
+** expanded and searched inside the driver API and does not use this table.
+** It is meant for large handler and value lists kept by the host
+** application. dispatch_benchmark compares it with a linear search.
+********************************************************************************
+*/
+
+#ifndef HOST_DISPATCH_H_
+#define HOST_DISPATCH_H_
+
+#include "abcc_types.h"
+
+/*------------------------------------------------------------------------------
+** Marks an unused slot.
+**------------------------------------------------------------------------------
+*/
+#define HOST_DISPATCH_EMPTY_SLOT                   ( 0xFFFF )
+
+/*------------------------------------------------------------------------------
+** Number of slots required for a table of iNumEntries entries. The slot array
+** passed to HOST_DISPATCH_Build() should have at least this many elements. It
+** holds one displacement per bucket followed by the slots themselves.
+**------------------------------------------------------------------------------
+*/
+#define HOST_DISPATCH_NUM_SLOTS( iNumEntries )     ( 5 * ( iNumEntries ) + 8 )
+
+/*------------------------------------------------------------------------------
+** Packs object, instance and attribute into one 32-bit key.
+**------------------------------------------------------------------------------
+*/
+#define HOST_DISPATCH_KEY( bObject, iInstance, bAttribute )                     \
+   ( ( (UINT32)(UINT8)( bObject ) << 24 ) |                                     \
+     ( (UINT32)(UINT16)( iInstance ) << 8 ) |                                   \
+     ( (UINT32)(UINT8)( bAttribute ) ) )
+
+/*------------------------------------------------------------------------------
+** Generic handler function pointer. Cast it back to the handler's real type
+** before the call, function pointers cannot be stored in a void*.
+**------------------------------------------------------------------------------
+*/
+typedef void (*HOST_DISPATCH_FuncType)( void );
+
+/*------------------------------------------------------------------------------
+** Dispatch entry.
+**
+** bObject, iInstance, bAttribute - Key of the entry.
+** pxContext                      - User data returned by a lookup, e.g. a
+**                                  value. May be NULL.
+** pnHandler                      - Handler returned by a lookup. May be
+**                                  NULL.
+**------------------------------------------------------------------------------
+*/
+typedef struct HOST_DISPATCH_EntryType
+{
+   UINT8                  bObject;
+   UINT16                 iInstance;
+   UINT8                  bAttribute;
+   void*                  pxContext;
+   HOST_DISPATCH_FuncType pnHandler;
+}
+HOST_DISPATCH_EntryType;
+
+/*------------------------------------------------------------------------------
+** Dispatch table instance. Treat as opaque, use the functions below.
+**------------------------------------------------------------------------------
+*/
+typedef struct HOST_DISPATCH_Type
+{
+   const HOST_DISPATCH_EntryType* pasEntries;
+   UINT16*                        paiDisplacements;
+   UINT16*                        paiSlots;
+   UINT16                         iBucketMask;
+   UINT16                         iSlotMask;
+   UINT16                         iNumEntries;
+}
+HOST_DISPATCH_Type;
+
+/*------------------------------------------------------------------------------
+** HOST_DISPATCH_Build()
+** Builds the perfect hash over an entry list. The list is referenced, not
+** copied, and must stay valid for as long as the table is used.
+**------------------------------------------------------------------------------
+** Inputs:
+**    psTable     - Table instance to build.
+**    pasEntries  - Entry list, keys must be unique.
+**    iNumEntries - Number of entries in the list.
+**    paiSlots    - Slot storage, see HOST_DISPATCH_NUM_SLOTS().
+**    iNumSlots   - Number of elements in paiSlots.
+**
+** Outputs:
+**    Returns:    - TRUE on success. FALSE if the list holds duplicate keys or
+**                  the slot storage is smaller than
+**                  HOST_DISPATCH_NUM_SLOTS( iNumEntries ).
+**------------------------------------------------------------------------------
+*/
+EXTFUNC BOOL HOST_DISPATCH_Build( HOST_DISPATCH_Type* psTable,
+                                  const HOST_DISPATCH_EntryType* pasEntries,
+                                  UINT16 iNumEntries,
+                                  UINT16* paiSlots,
+                                  UINT16 iNumSlots );
+
+/*------------------------------------------------------------------------------
+** HOST_DISPATCH_Lookup()
+** Finds the entry for an object/instance/attribute triplet.
+**------------------------------------------------------------------------------
+** Outputs:
+**    Returns:    - Pointer to the matching entry, or NULL if there is none.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC const HOST_DISPATCH_EntryType* HOST_DISPATCH_Lookup( const HOST_DISPATCH_Type* psTable,
+                                                            UINT8 bObject,
+                                                            UINT16 iInstance,
+                                                            UINT8 bAttribute );
+
+/*------------------------------------------------------------------------------
+** HOST_DISPATCH_GetIndex()
+** As HOST_DISPATCH_Lookup() but returns the position of the entry in the list,
+** or HOST_DISPATCH_EMPTY_SLOT. Useful for indexing per-entry side tables.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC UINT16 HOST_DISPATCH_GetIndex( const HOST_DISPATCH_Type* psTable,
+                                       UINT8 bObject,
+                                       UINT16 iInstance,
+                                       UINT8 bAttribute );
+
+#endif  /* inclusion lock */
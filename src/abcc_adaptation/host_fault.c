@@ -0,0 +1,490 @@
+/*******************************************************************************
+** Copyright 2025-present HMS Industrial Networks AB.
+** Licensed under the MIT License.
+********************************************************************************
+** File Description:
+** Fault and latency injection in the Transport Provider, and a scenario
+** runner that measures how long the driver takes to recover.
+********************************************************************************
+*/
+
+#include "windows.h"
+#include "stdio.h"
+#include "string.h"
+
+#include "tp.h"
+#include "imp_tp.h"
+#include "abcc_api.h"
+#include "abcc_driver_config.h"
+#include "host_fault.h"
+
+/*------------------------------------------------------------------------------
+** Built-in scenarios.
+**------------------------------------------------------------------------------
+*/
+static const HOST_FAULT_ScenarioType host_asScenarios[] =
+{
+   { "tp-error",       HOST_FAULT_TP_ERROR,     HOST_FAULT_CALL_ALL,         1,  TP_ERR_OTHER,    0 },
+   { "tp-error-burst", HOST_FAULT_TP_ERROR,     HOST_FAULT_CALL_ALL,         20, TP_ERR_WIN_FAIL, 0 },
+   { "spi-crc",        HOST_FAULT_SPI_CORRUPT,  HOST_FAULT_CALL_SPI,         1,  TP_ERR_NONE,     0 },
+   { "serial-drop",    HOST_FAULT_SERIAL_DROP,  HOST_FAULT_CALL_SERIAL_READ, 1,  TP_ERR_NONE,     0 },
+   { "serial-short",   HOST_FAULT_SERIAL_SHORT, HOST_FAULT_CALL_SERIAL_READ, 1,  TP_ERR_NONE,     0 },
+   { "latency",        HOST_FAULT_LATENCY,      HOST_FAULT_CALL_ALL,         1,  TP_ERR_NONE,     50 },
+   { "latency-burst",  HOST_FAULT_LATENCY,      HOST_FAULT_CALL_ALL,         10, TP_ERR_NONE,     200 }
+};
+
+#define HOST_FAULT_NUM_SCENARIOS ( sizeof( host_asScenarios ) / sizeof( host_asScenarios[ 0 ] ) )
+
+/*------------------------------------------------------------------------------
+** Scenario runner states.
+**------------------------------------------------------------------------------
+*/
+typedef enum host_RunnerStateType
+{
+   HOST_FAULT_RUNNER_IDLE,
+   HOST_FAULT_RUNNER_SETTLING,
+   HOST_FAULT_RUNNER_OBSERVING,
+   HOST_FAULT_RUNNER_DONE
+}
+host_RunnerStateType;
+
+/*------------------------------------------------------------------------------
+** Original Transport Provider functions.
+**------------------------------------------------------------------------------
+*/
+static TP_ParallelReadType       host_pnParallelRead = NULL;
+static TP_ParallelVerifyReadType host_pnParallelVerifyRead = NULL;
+static TP_ParallelWriteType      host_pnParallelWrite = NULL;
+static TP_SpiTransactionType     host_pnSpiTransaction = NULL;
+static TP_SerialReadType         host_pnSerialRead = NULL;
+static TP_SerialWriteType        host_pnSerialWrite = NULL;
+
+/*------------------------------------------------------------------------------
+** Armed fault. host_psArmed is set before host_lRemaining is made non-zero,
+** and the wrappers only read it after taking one of the remaining calls.
+**------------------------------------------------------------------------------
+*/
+static const HOST_FAULT_ScenarioType* volatile host_psArmed = NULL;
+static volatile LONG                           host_lRemaining = 0;
+static volatile LONG                           host_lNumInjected = 0;
+
+/*------------------------------------------------------------------------------
+** Scenario runner.
+**------------------------------------------------------------------------------
+*/
+static const HOST_FAULT_ScenarioType* host_psRunScenario = NULL;
+static host_RunnerStateType           host_eRunnerState = HOST_FAULT_RUNNER_IDLE;
+static UINT32                         host_lRepetitions = 0;
+static UINT32                         host_lNumRuns = 0;
+static UINT64                         host_llActiveSinceUs = 0;
+static UINT64                         host_llInjectedAtUs = 0;
+static BOOL8                          host_fLeftActive = FALSE;
+static UINT32                         host_lNumRecovered = 0;
+static UINT32                         host_lNumAbsorbed = 0;
+static UINT32                         host_lNumFailed = 0;
+static UINT32                         host_lNumRestarts = 0;
+static UINT64                         host_llTotalRecoveryUs = 0;
+static UINT32                         host_lMinRecoveryUs = 0;
+static UINT32                         host_lMaxRecoveryUs = 0;
+
+/*------------------------------------------------------------------------------
+** Takes one of the remaining faulted calls if the armed fault applies to
+** bCall.
+**------------------------------------------------------------------------------
+** Outputs:
+**    Returns:  - The armed scenario, or NULL if this call is not faulted.
+**------------------------------------------------------------------------------
+*/
+static const HOST_FAULT_ScenarioType* TakeFault( UINT8 bCall )
+{
+   const HOST_FAULT_ScenarioType* psArmed;
+   LONG                           lRemaining;
+
+   do
+   {
+      lRemaining = host_lRemaining;
+      if( lRemaining <= 0 )
+      {
+         return( NULL );
+      }
+      psArmed = host_psArmed;
+      if( ( psArmed == NULL ) || !( psArmed->bCalls & bCall ) )
+      {
+         return( NULL );
+      }
+   }
+   while( InterlockedCompareExchange( &host_lRemaining, lRemaining - 1, lRemaining ) != lRemaining );
+
+   InterlockedIncrement( &host_lNumInjected );
+   return( psArmed );
+}
+
+/*------------------------------------------------------------------------------
+** Applies the part of a fault that happens before the call. Returns TRUE if
+** the call is to be skipped and the armed status returned instead.
+**------------------------------------------------------------------------------
+*/
+static BOOL BeforeCall( const HOST_FAULT_ScenarioType* psFault )
+{
+   if( psFault == NULL )
+   {
+      return( FALSE );
+   }
+
+   switch( psFault->eKind )
+   {
+   case HOST_FAULT_TP_ERROR:
+      return( TRUE );
+
+   case HOST_FAULT_LATENCY:
+      Sleep( psFault->lLatencyMs );
+      return( FALSE );
+
+   default:
+      return( FALSE );
+   }
+}
+
+static TP_StatusType WINAPI FaultParallelRead( TP_Path xPath, UINT16 iOffset, UINT8* pbData, UINT16 iAmount )
+{
+   const HOST_FAULT_ScenarioType* psFault;
+
+   psFault = TakeFault( HOST_FAULT_CALL_PARALLEL_READ );
+   if( BeforeCall( psFault ) )
+   {
+      return( psFault->eStatus );
+   }
+   return( host_pnParallelRead( xPath, iOffset, pbData, iAmount ) );
+}
+
+static TP_StatusType WINAPI FaultParallelVerifyRead( TP_Path xPath, UINT16 iOffset, UINT8* pbData, UINT16 iAmount, UINT16 iMaxTries )
+{
+   const HOST_FAULT_ScenarioType* psFault;
+
+   psFault = TakeFault( HOST_FAULT_CALL_PARALLEL_READ );
+   if( BeforeCall( psFault ) )
+   {
+      return( psFault->eStatus );
+   }
+   return( host_pnParallelVerifyRead( xPath, iOffset, pbData, iAmount, iMaxTries ) );
+}
+
+static TP_StatusType WINAPI FaultParallelWrite( TP_Path xPath, UINT16 iOffset, const UINT8* pbData, UINT16 iAmount )
+{
+   const HOST_FAULT_ScenarioType* psFault;
+
+   psFault = TakeFault( HOST_FAULT_CALL_PARALLEL_WRITE );
+   if( BeforeCall( psFault ) )
+   {
+      return( psFault->eStatus );
+   }
+   return( host_pnParallelWrite( xPath, iOffset, pbData, iAmount ) );
+}
+
+static TP_StatusType WINAPI FaultSpiTransaction( TP_Path xPath, const UINT8* pbMosi, UINT8* pbMiso, UINT16 iAmount )
+{
+   const HOST_FAULT_ScenarioType* psFault;
+   TP_StatusType                  eStatus;
+
+   psFault = TakeFault( HOST_FAULT_CALL_SPI );
+   if( BeforeCall( psFault ) )
+   {
+      return( psFault->eStatus );
+   }
+
+   eStatus = host_pnSpiTransaction( xPath, pbMosi, pbMiso, iAmount );
+
+   /*
+   ** Flip a bit in the middle of the received frame. The driver finds the
+   ** error through the frame CRC and retransmits.
+   */
+   if( ( psFault != NULL ) && ( psFault->eKind == HOST_FAULT_SPI_CORRUPT ) &&
+       ( eStatus == TP_ERR_NONE ) && ( iAmount > 0 ) )
+   {
+      pbMiso[ iAmount / 2 ] ^= 0x01;
+   }
+   return( eStatus );
+}
+
+static TP_StatusType WINAPI FaultSerialRead( TP_Path xPath, UINT8* pbData, UINT16* piAmount, UINT16 iMaxWaitTime )
+{
+   const HOST_FAULT_ScenarioType* psFault;
+   TP_StatusType                  eStatus;
+
+   /*
+   ** Faults that act before the call take it as any other call does.
+   */
+   psFault = host_psArmed;
+   if( ( psFault == NULL ) ||
+       ( ( psFault->eKind != HOST_FAULT_SERIAL_DROP ) &&
+         ( psFault->eKind != HOST_FAULT_SERIAL_SHORT ) ) )
+   {
+      psFault = TakeFault( HOST_FAULT_CALL_SERIAL_READ );
+      if( BeforeCall( psFault ) )
+      {
+         *piAmount = 0;
+         return( psFault->eStatus );
+      }
+      return( host_pnSerialRead( xPath, pbData, piAmount, iMaxWaitTime ) );
+   }
+
+   /*
+   ** Data loss is only taken by a read that returned data. The reader thread
+   ** polls far more often than frames arrive, so most reads return nothing
+   ** and would otherwise use up the faulted calls without losing anything.
+   */
+   eStatus = host_pnSerialRead( xPath, pbData, piAmount, iMaxWaitTime );
+   if( ( eStatus != TP_ERR_NONE ) || ( *piAmount == 0 ) )
+   {
+      return( eStatus );
+   }
+
+   psFault = TakeFault( HOST_FAULT_CALL_SERIAL_READ );
+   if( psFault != NULL )
+   {
+      if( psFault->eKind == HOST_FAULT_SERIAL_DROP )
+      {
+         *piAmount = 0;
+      }
+      else if( psFault->eKind == HOST_FAULT_SERIAL_SHORT )
+      {
+         *piAmount /= 2;
+      }
+   }
+   return( eStatus );
+}
+
+static TP_StatusType WINAPI FaultSerialWrite( TP_Path xPath, const UINT8* pbData, UINT16* piAmount, UINT16 iMaxWaitTime )
+{
+   const HOST_FAULT_ScenarioType* psFault;
+
+   psFault = TakeFault( HOST_FAULT_CALL_SERIAL_WRITE );
+   if( BeforeCall( psFault ) )
+   {
+      *piAmount = 0;
+      return( psFault->eStatus );
+   }
+   return( host_pnSerialWrite( xPath, pbData, piAmount, iMaxWaitTime ) );
+}
+
+void HOST_FAULT_Install( void )
+{
+   if( host_pnParallelRead != NULL )
+   {
+      return;
+   }
+
+   host_pnParallelRead = TP_ParallelRead;
+   host_pnParallelVerifyRead = TP_ParallelVerifyRead;
+   host_pnParallelWrite = TP_ParallelWrite;
+   host_pnSpiTransaction = TP_SpiTransaction;
+   host_pnSerialRead = TP_SerialRead;
+   host_pnSerialWrite = TP_SerialWrite;
+
+   /*
+   ** Functions the loaded provider does not have stay NULL, the HAL checks
+   ** for that itself.
+   */
+   if( host_pnParallelRead != NULL )
+   {
+      TP_ParallelRead = FaultParallelRead;
+   }
+   if( host_pnParallelVerifyRead != NULL )
+   {
+      TP_ParallelVerifyRead = FaultParallelVerifyRead;
+   }
+   if( host_pnParallelWrite != NULL )
+   {
+      TP_ParallelWrite = FaultParallelWrite;
+   }
+   if( host_pnSpiTransaction != NULL )
+   {
+      TP_SpiTransaction = FaultSpiTransaction;
+   }
+   if( host_pnSerialRead != NULL )
+   {
+      TP_SerialRead = FaultSerialRead;
+   }
+   if( host_pnSerialWrite != NULL )
+   {
+      TP_SerialWrite = FaultSerialWrite;
+   }
+}
+
+void HOST_FAULT_Arm( const HOST_FAULT_ScenarioType* psScenario )
+{
+   InterlockedExchange( &host_lRemaining, 0 );
+   host_psArmed = psScenario;
+   MemoryBarrier();
+   InterlockedExchange( &host_lRemaining, (LONG)psScenario->lNumCalls );
+}
+
+const HOST_FAULT_ScenarioType* HOST_FAULT_FindScenario( const char* pacName )
+{
+   UINT16 i;
+
+   for( i = 0; i < HOST_FAULT_NUM_SCENARIOS; i++ )
+   {
+      if( strcmp( host_asScenarios[ i ].pacName, pacName ) == 0 )
+      {
+         return( &host_asScenarios[ i ] );
+      }
+   }
+   return( NULL );
+}
+
+void HOST_FAULT_PrintScenarios( void )
+{
+   UINT16 i;
+
+   printf( "Fault scenarios:" );
+   for( i = 0; i < HOST_FAULT_NUM_SCENARIOS; i++ )
+   {
+      printf( " %s", host_asScenarios[ i ].pacName );
+   }
+   printf( "\n" );
+}
+
+void HOST_FAULT_RunnerStart( const HOST_FAULT_ScenarioType* psScenario, UINT32 lRepetitions )
+{
+   host_psRunScenario = psScenario;
+   host_lRepetitions = lRepetitions;
+   host_lNumRuns = 0;
+   host_lNumRecovered = 0;
+   host_lNumAbsorbed = 0;
+   host_lNumFailed = 0;
+   host_lNumRestarts = 0;
+   host_llTotalRecoveryUs = 0;
+   host_lMinRecoveryUs = 0;
+   host_lMaxRecoveryUs = 0;
+   host_llActiveSinceUs = 0;
+   host_eRunnerState = HOST_FAULT_RUNNER_SETTLING;
+}
+
+BOOL HOST_FAULT_RunnerRun( UINT64 llNowUs )
+{
+   BOOL8  fActive;
+   UINT32 lRecoveryUs;
+
+   fActive = ( ABCC_API_AnbState() == ABP_ANB_STATE_PROCESS_ACTIVE );
+
+   switch( host_eRunnerState )
+   {
+   case HOST_FAULT_RUNNER_SETTLING:
+      if( !fActive )
+      {
+         host_llActiveSinceUs = 0;
+      }
+      else if( host_llActiveSinceUs == 0 )
+      {
+         host_llActiveSinceUs = llNowUs;
+      }
+      else if( llNowUs - host_llActiveSinceUs >= HOST_CFG_FAULT_SETTLE_MS * 1000ULL )
+      {
+         host_fLeftActive = FALSE;
+         host_llInjectedAtUs = llNowUs;
+         HOST_FAULT_Arm( host_psRunScenario );
+         host_eRunnerState = HOST_FAULT_RUNNER_OBSERVING;
+      }
+      break;
+
+   case HOST_FAULT_RUNNER_OBSERVING:
+      if( !fActive )
+      {
+         host_fLeftActive = TRUE;
+      }
+      else if( host_fLeftActive )
+      {
+         lRecoveryUs = (UINT32)( llNowUs - host_llInjectedAtUs );
+         if( ( host_lNumRecovered == 0 ) || ( lRecoveryUs < host_lMinRecoveryUs ) )
+         {
+            host_lMinRecoveryUs = lRecoveryUs;
+         }
+         if( lRecoveryUs > host_lMaxRecoveryUs )
+         {
+            host_lMaxRecoveryUs = lRecoveryUs;
+         }
+         host_llTotalRecoveryUs += lRecoveryUs;
+         host_lNumRecovered++;
+         host_lNumRuns++;
+         host_llActiveSinceUs = llNowUs;
+         host_eRunnerState = HOST_FAULT_RUNNER_SETTLING;
+         break;
+      }
+      else if( ( host_lRemaining <= 0 ) &&
+               ( llNowUs - host_llInjectedAtUs >= HOST_CFG_FAULT_SETTLE_MS * 1000ULL ) )
+      {
+         /*
+         ** All faulted calls are done and the ABCC stayed in PROCESS_ACTIVE
+         ** for a settle time after the injection.
+         */
+         host_lNumAbsorbed++;
+         host_lNumRuns++;
+         host_llActiveSinceUs = llNowUs;
+         host_eRunnerState = HOST_FAULT_RUNNER_SETTLING;
+         break;
+      }
+
+      if( llNowUs - host_llInjectedAtUs >= HOST_CFG_FAULT_RECOVERY_TIMEOUT_MS * 1000ULL )
+      {
+         InterlockedExchange( &host_lRemaining, 0 );
+         host_lNumFailed++;
+         host_lNumRuns++;
+         host_llActiveSinceUs = 0;
+         host_eRunnerState = HOST_FAULT_RUNNER_SETTLING;
+      }
+      break;
+
+   default:
+      return( FALSE );
+   }
+
+   if( host_lNumRuns >= host_lRepetitions )
+   {
+      host_eRunnerState = HOST_FAULT_RUNNER_DONE;
+      HOST_FAULT_PrintStats();
+      return( FALSE );
+   }
+   return( TRUE );
+}
+
+BOOL HOST_FAULT_RunnerHandleError( void )
+{
+   if( ( host_eRunnerState != HOST_FAULT_RUNNER_SETTLING ) &&
+       ( host_eRunnerState != HOST_FAULT_RUNNER_OBSERVING ) )
+   {
+      return( FALSE );
+   }
+
+   host_lNumRestarts++;
+   ABCC_API_Restart();
+   return( TRUE );
+}
+
+void HOST_FAULT_PrintStats( void )
+{
+   if( host_psRunScenario == NULL )
+   {
+      printf( "Fault injection: %ld calls faulted\n", host_lNumInjected );
+      return;
+   }
+
+   printf( "Fault scenario '%s':\n", host_psRunScenario->pacName );
+   printf( " %lu of %lu injections, %ld calls faulted, %lu driver restarts\n",
+           (unsigned long)host_lNumRuns,
+           (unsigned long)host_lRepetitions,
+           host_lNumInjected,
+           (unsigned long)host_lNumRestarts );
+   printf( " %lu recovered, %lu absorbed, %lu not recovered within %lums\n",
+           (unsigned long)host_lNumRecovered,
+           (unsigned long)host_lNumAbsorbed,
+           (unsigned long)host_lNumFailed,
+           (unsigned long)HOST_CFG_FAULT_RECOVERY_TIMEOUT_MS );
+   if( host_lNumRecovered > 0 )
+   {
+      printf( " Time to PROCESS_ACTIVE: min %.1fms, mean %.1fms, max %.1fms\n",
+              host_lMinRecoveryUs / 1000.0,
+              (double)host_llTotalRecoveryUs / host_lNumRecovered / 1000.0,
+              host_lMaxRecoveryUs / 1000.0 );
+   }
+}
@@ -0,0 +1,163 @@
+/*******************************************************************************
+** Copyright 2025-present HMS Industrial Networks AB.
+** Licensed under the MIT License.
+********************************************************************************
+** File Description:
+** Fault and latency injection in the Transport Provider, and a scenario
+** runner that measures how long the driver takes to recover.
+**
+** HOST_FAULT_Install() puts wrappers in front of the data transfer functions
+** of the loaded Transport Provider. While no fault is armed the wrappers only
+** forward the calls. An armed fault affects the next N matching calls:
+**    HOST_FAULT_TP_ERROR      - The call is not made, eStatus is returned.
+**    HOST_FAULT_LATENCY       - The call is delayed by lLatencyMs.
+**    HOST_FAULT_SPI_CORRUPT   - One bit of the received SPI frame is flipped,
+**                               so the frame fails its CRC check.
+**    HOST_FAULT_SERIAL_DROP   - All bytes of a serial read are lost.
+**    HOST_FAULT_SERIAL_SHORT  - The second half of a serial read is lost.
+** The SERIAL_ kinds only count serial reads that returned data, a poll that
+** returns nothing has nothing to lose.
+**
+** The scenario runner waits until the ABCC has been in PROCESS_ACTIVE for a
+** settle time, then arms the scenario's fault. It measures the time from
+** arming until PROCESS_ACTIVE is reached again, and repeats this a number of
+** times. A fault that never takes the ABCC out of PROCESS_ACTIVE is counted
+** as absorbed. Errors reported by ABCC_API_Run() while a scenario runs are
+** handled with ABCC_API_Restart() instead of stopping the application, so
+** recovery through a restart is included in the measurement.
+********************************************************************************
+*/
+
+#ifndef HOST_FAULT_H_
+#define HOST_FAULT_H_
+
+#include "abcc_types.h"
+#include "tp.h"
+
+/*------------------------------------------------------------------------------
+** Fault kinds.
+**------------------------------------------------------------------------------
+*/
+typedef enum HOST_FAULT_KindType
+{
+   HOST_FAULT_TP_ERROR,
+   HOST_FAULT_LATENCY,
+   HOST_FAULT_SPI_CORRUPT,
+   HOST_FAULT_SERIAL_DROP,
+   HOST_FAULT_SERIAL_SHORT
+}
+HOST_FAULT_KindType;
+
+/*------------------------------------------------------------------------------
+** Transport Provider calls a fault can be applied to. PARALLEL_READ covers
+** both plain and verified reads.
+**------------------------------------------------------------------------------
+*/
+#define HOST_FAULT_CALL_PARALLEL_READ              ( 0x01 )
+#define HOST_FAULT_CALL_PARALLEL_WRITE             ( 0x02 )
+#define HOST_FAULT_CALL_SPI                        ( 0x04 )
+#define HOST_FAULT_CALL_SERIAL_READ                ( 0x08 )
+#define HOST_FAULT_CALL_SERIAL_WRITE               ( 0x10 )
+#define HOST_FAULT_CALL_ALL                        ( 0x1F )
+
+/*------------------------------------------------------------------------------
+** Fault scenario.
+**
+** pacName     - Name used on the command line and in the report.
+** eKind       - What to inject.
+** bCalls      - HOST_FAULT_CALL_ mask of the affected calls. SPI_CORRUPT and
+**               the SERIAL_ kinds only apply to their own call.
+** lNumCalls   - Number of matching calls to affect per injection. For the
+**               SERIAL_ kinds, number of reads that returned data.
+** eStatus     - Status returned by HOST_FAULT_TP_ERROR.
+** lLatencyMs  - Delay added by HOST_FAULT_LATENCY.
+**------------------------------------------------------------------------------
+*/
+typedef struct HOST_FAULT_ScenarioType
+{
+   const char*         pacName;
+   HOST_FAULT_KindType eKind;
+   UINT8               bCalls;
+   UINT32              lNumCalls;
+   TP_StatusType       eStatus;
+   UINT32              lLatencyMs;
+}
+HOST_FAULT_ScenarioType;
+
+/*------------------------------------------------------------------------------
+** HOST_FAULT_Install()
+** Wraps the Transport Provider transfer functions. Call after a successful
+** TP_Initialise(). Calling it again is harmless.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void HOST_FAULT_Install( void );
+
+/*------------------------------------------------------------------------------
+** HOST_FAULT_Arm()
+** Applies a scenario's fault to the next matching calls.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void HOST_FAULT_Arm( const HOST_FAULT_ScenarioType* psScenario );
+
+/*------------------------------------------------------------------------------
+** HOST_FAULT_FindScenario()
+** Looks up one of the built-in scenarios by name.
+**------------------------------------------------------------------------------
+** Outputs:
+**    Returns: - The scenario, or NULL if there is none with that name.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC const HOST_FAULT_ScenarioType* HOST_FAULT_FindScenario( const char* pacName );
+
+/*------------------------------------------------------------------------------
+** HOST_FAULT_PrintScenarios()
+** Lists the built-in scenarios.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void HOST_FAULT_PrintScenarios( void );
+
+/*------------------------------------------------------------------------------
+** HOST_FAULT_RunnerStart()
+** Starts the scenario runner.
+**------------------------------------------------------------------------------
+** Inputs:
+**    psScenario     - Scenario to run.
+**    lRepetitions   - Number of injections.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void HOST_FAULT_RunnerStart( const HOST_FAULT_ScenarioType* psScenario, UINT32 lRepetitions );
+
+/*------------------------------------------------------------------------------
+** HOST_FAULT_RunnerRun()
+** Advances the scenario runner. Call once per main loop iteration.
+**------------------------------------------------------------------------------
+** Inputs:
+**    llNowUs - Current time from HOST_TIME_GetUs().
+**
+** Outputs:
+**    Returns:  - TRUE while the runner is busy, FALSE when all repetitions
+**                are done or no runner was started.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC BOOL HOST_FAULT_RunnerRun( UINT64 llNowUs );
+
+/*------------------------------------------------------------------------------
+** HOST_FAULT_RunnerHandleError()
+** Lets the runner handle an error from ABCC_API_Run() by restarting the
+** driver.
+**------------------------------------------------------------------------------
+** Outputs:
+**    Returns:  - TRUE if the error was handled, FALSE if no runner is busy
+**                and the caller should treat the error as usual.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC BOOL HOST_FAULT_RunnerHandleError( void );
+
+/*------------------------------------------------------------------------------
+** HOST_FAULT_PrintStats()
+** Prints the injection counters and the recovery times measured so far.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void HOST_FAULT_PrintStats( void );
+
+#endif  /* inclusion lock */
@@ -0,0 +1,332 @@
+/*******************************************************************************
+** Copyright 2025-present HMS Industrial Networks AB.
+** Licensed under the MIT License.
+********************************************************************************
+** File Description:
+** Process image in shared memory for external consumers.
+********************************************************************************
+*/
+
+#include "windows.h"
+#include "string.h"
+
+#include "abcc_api.h"
+#include "abcc_software_port.h"
+#include "host_time.h"
+#include "host_image.h"
+
+#define HOST_IMAGE_ALIGN( x )                      ( ( (x) + 7 ) & ~7UL )
+
+/*------------------------------------------------------------------------------
+** One copy done per publish: an ADI value or a slice of an ADI into one of
+** the process data images. The table is private so that consumers cannot
+** influence what is copied.
+**------------------------------------------------------------------------------
+*/
+typedef struct host_CopyType
+{
+   const UINT8* pbSource;
+   UINT32       lOffset;
+   UINT16       iSize;
+}
+host_CopyType;
+
+static host_CopyType          host_asCopies[ HOST_CFG_IMAGE_MAX_COPIES ];
+static UINT16                 host_iNumCopies = 0;
+static HANDLE                 host_hSection = NULL;
+static UINT8*                 host_pbView = NULL;
+static HOST_IMAGE_HeaderType* host_psHeader = NULL;
+
+static INT16 FindAdi( UINT16 iInstance, UINT16 iNumAdis )
+{
+   UINT16 i;
+
+   for( i = 0; i < iNumAdis; i++ )
+   {
+      if( ABCC_API_asAdiEntryList[ i ].iInstance == iInstance )
+      {
+         return( (INT16)i );
+      }
+   }
+   return( -1 );
+}
+
+static BOOL AddCopy( const void* pxSource, UINT32 lOffset, UINT16 iSize )
+{
+   if( host_iNumCopies >= HOST_CFG_IMAGE_MAX_COPIES )
+   {
+      return( FALSE );
+   }
+   host_asCopies[ host_iNumCopies ].pbSource = (const UINT8*)pxSource;
+   host_asCopies[ host_iNumCopies ].lOffset = lOffset;
+   host_asCopies[ host_iNumCopies ].iSize = iSize;
+   host_iNumCopies++;
+   return( TRUE );
+}
+
+/*------------------------------------------------------------------------------
+** Lays out the section and fills in the header and descriptors. With
+** pbSection NULL only the size is calculated and the copy table is not
+** touched.
+**------------------------------------------------------------------------------
+*/
+static BOOL BuildLayout( UINT8* pbSection, UINT32* plSectionSize )
+{
+   HOST_IMAGE_HeaderType   sHeader;
+   HOST_IMAGE_AdiDescType* psAdiDesc;
+   HOST_IMAGE_MapDescType* psMapDesc;
+   const AD_AdiEntryType*  psAdi;
+   const AD_MapType*       psMap;
+   UINT32                  lOffset;
+   UINT16                  iNumMapEntries = 0;
+   UINT16                  iPdOffset[ 2 ] = { 0, 0 };
+   UINT16                  iSize;
+   UINT8                   bNumElements;
+   UINT8                   bStart;
+   INT16                   iAdi;
+   UINT16                  i;
+
+   while( ABCC_API_asAdObjDefaultMap[ iNumMapEntries ].iInstance != AD_MAP_END_ENTRY )
+   {
+      iNumMapEntries++;
+   }
+
+   memset( &sHeader, 0, sizeof( sHeader ) );
+   sHeader.lMagic = HOST_IMAGE_MAGIC;
+   sHeader.iVersion = HOST_IMAGE_VERSION;
+   sHeader.iNumAdis = ABCC_API_CbfGetNumAdi();
+   sHeader.iNumMapEntries = iNumMapEntries;
+   sHeader.lAdiDirOffset = HOST_IMAGE_ALIGN( sizeof( HOST_IMAGE_HeaderType ) );
+   sHeader.lMapDirOffset = HOST_IMAGE_ALIGN( sHeader.lAdiDirOffset +
+                                             sHeader.iNumAdis * sizeof( HOST_IMAGE_AdiDescType ) );
+   lOffset = HOST_IMAGE_ALIGN( sHeader.lMapDirOffset +
+                               iNumMapEntries * sizeof( HOST_IMAGE_MapDescType ) );
+
+   if( pbSection != NULL )
+   {
+      host_iNumCopies = 0;
+   }
+
+   /*
+   ** ADI values.
+   */
+   for( i = 0; i < sHeader.iNumAdis; i++ )
+   {
+      psAdi = &ABCC_API_asAdiEntryList[ i ];
+
+      /*
+      ** Bit field types have no element size and their values are not
+      ** exported.
+      */
+      iSize = (UINT16)( HOST_IMAGE_ElementSize( psAdi->bDataType ) * psAdi->bNumOfElements );
+
+      if( pbSection != NULL )
+      {
+         psAdiDesc = (HOST_IMAGE_AdiDescType*)( pbSection + sHeader.lAdiDirOffset ) + i;
+         psAdiDesc->iInstance = psAdi->iInstance;
+         psAdiDesc->bDataType = psAdi->bDataType;
+         psAdiDesc->bNumElements = psAdi->bNumOfElements;
+         psAdiDesc->bElementSize = HOST_IMAGE_ElementSize( psAdi->bDataType );
+         psAdiDesc->bDesc = psAdi->bDesc;
+         psAdiDesc->lValueOffset = lOffset;
+         if( psAdi->pacName != NULL )
+         {
+            strncpy( psAdiDesc->acName, psAdi->pacName, HOST_IMAGE_NAME_LENGTH - 1 );
+         }
+         if( ( iSize > 0 ) && !AddCopy( psAdi->uData.sVOID.pxValuePtr, lOffset, iSize ) )
+         {
+            return( FALSE );
+         }
+      }
+      lOffset = HOST_IMAGE_ALIGN( lOffset + iSize );
+   }
+
+   /*
+   ** Process data images, mapped elements packed in map order.
+   */
+   for( i = 0; i < iNumMapEntries; i++ )
+   {
+      psMap = &ABCC_API_asAdObjDefaultMap[ i ];
+      iAdi = FindAdi( psMap->iInstance, sHeader.iNumAdis );
+      if( iAdi < 0 )
+      {
+         ABCC_PORT_printf( "Process image: mapped ADI %u not found\n", psMap->iInstance );
+         return( FALSE );
+      }
+      psAdi = &ABCC_API_asAdiEntryList[ iAdi ];
+
+      bStart = ( psMap->bNumElem == AD_MAP_ALL_ELEM ) ? 0 : psMap->bElemStartIndex;
+      bNumElements = ( psMap->bNumElem == AD_MAP_ALL_ELEM ) ? psAdi->bNumOfElements : psMap->bNumElem;
+      iSize = (UINT16)( HOST_IMAGE_ElementSize( psAdi->bDataType ) * bNumElements );
+
+      if( pbSection != NULL )
+      {
+         psMapDesc = (HOST_IMAGE_MapDescType*)( pbSection + sHeader.lMapDirOffset ) + i;
+         psMapDesc->iInstance = psMap->iInstance;
+         psMapDesc->bDirection = (UINT8)psMap->eDir;
+         psMapDesc->bNumElements = bNumElements;
+         psMapDesc->bStartIndex = bStart;
+         psMapDesc->iPdOffset = iPdOffset[ psMap->eDir == PD_WRITE ];
+      }
+      iPdOffset[ psMap->eDir == PD_WRITE ] += iSize;
+   }
+
+   sHeader.iReadPdSize = iPdOffset[ 0 ];
+   sHeader.iWritePdSize = iPdOffset[ 1 ];
+   sHeader.lReadPdOffset = lOffset;
+   sHeader.lWritePdOffset = HOST_IMAGE_ALIGN( lOffset + sHeader.iReadPdSize );
+   sHeader.lSectionSize = HOST_IMAGE_ALIGN( sHeader.lWritePdOffset + sHeader.iWritePdSize );
+
+   if( pbSection != NULL )
+   {
+      /*
+      ** Second pass over the map for the process data copies, now that the
+      ** image offsets are known.
+      */
+      iPdOffset[ 0 ] = 0;
+      iPdOffset[ 1 ] = 0;
+      for( i = 0; i < iNumMapEntries; i++ )
+      {
+         psMap = &ABCC_API_asAdObjDefaultMap[ i ];
+         psAdi = &ABCC_API_asAdiEntryList[ FindAdi( psMap->iInstance, sHeader.iNumAdis ) ];
+         bStart = ( psMap->bNumElem == AD_MAP_ALL_ELEM ) ? 0 : psMap->bElemStartIndex;
+         bNumElements = ( psMap->bNumElem == AD_MAP_ALL_ELEM ) ? psAdi->bNumOfElements : psMap->bNumElem;
+         iSize = (UINT16)( HOST_IMAGE_ElementSize( psAdi->bDataType ) * bNumElements );
+         if( ( iSize > 0 ) &&
+             !AddCopy( (const UINT8*)psAdi->uData.sVOID.pxValuePtr +
+                       HOST_IMAGE_ElementSize( psAdi->bDataType ) * bStart,
+                       ( psMap->eDir == PD_WRITE ? sHeader.lWritePdOffset : sHeader.lReadPdOffset ) +
+                       iPdOffset[ psMap->eDir == PD_WRITE ],
+                       iSize ) )
+         {
+            return( FALSE );
+         }
+         iPdOffset[ psMap->eDir == PD_WRITE ] += iSize;
+      }
+      memcpy( pbSection, &sHeader, sizeof( sHeader ) );
+   }
+
+   *plSectionSize = sHeader.lSectionSize;
+   return( TRUE );
+}
+
+UINT8 HOST_IMAGE_ElementSize( UINT8 bDataType )
+{
+   switch( bDataType )
+   {
+   case ABP_BOOL:
+   case ABP_SINT8:
+   case ABP_UINT8:
+   case ABP_CHAR:
+   case ABP_ENUM:
+   case ABP_BITS8:
+   case ABP_OCTET:
+      return( 1 );
+
+   case ABP_SINT16:
+   case ABP_UINT16:
+   case ABP_BITS16:
+      return( 2 );
+
+   case ABP_SINT32:
+   case ABP_UINT32:
+   case ABP_FLOAT:
+   case ABP_BITS32:
+      return( 4 );
+
+   case ABP_SINT64:
+   case ABP_UINT64:
+      return( 8 );
+
+   default:
+      return( 0 );
+   }
+}
+
+BOOL HOST_IMAGE_Open( const char* pacName )
+{
+   UINT32 lSectionSize;
+
+   HOST_IMAGE_Close();
+
+   if( !BuildLayout( NULL, &lSectionSize ) )
+   {
+      return( FALSE );
+   }
+
+   host_hSection = CreateFileMappingA( INVALID_HANDLE_VALUE,
+                                       NULL,
+                                       PAGE_READWRITE,
+                                       0,
+                                       lSectionSize,
+                                       pacName );
+   if( host_hSection != NULL )
+   {
+      host_pbView = (UINT8*)MapViewOfFile( host_hSection, FILE_MAP_ALL_ACCESS, 0, 0, lSectionSize );
+   }
+   if( host_pbView == NULL )
+   {
+      ABCC_PORT_printf( "Could not create process image %s (error %lu)\n", pacName, GetLastError() );
+      HOST_IMAGE_Close();
+      return( FALSE );
+   }
+
+   /*
+   ** The section may be left over from an earlier run that a consumer still
+   ** holds open. Start from zero.
+   */
+   memset( host_pbView, 0, lSectionSize );
+   if( !BuildLayout( host_pbView, &lSectionSize ) )
+   {
+      ABCC_PORT_printf( "Process image: more than %u copies needed, increase HOST_CFG_IMAGE_MAX_COPIES\n",
+                        (UINT16)HOST_CFG_IMAGE_MAX_COPIES );
+      HOST_IMAGE_Close();
+      return( FALSE );
+   }
+   host_psHeader = (HOST_IMAGE_HeaderType*)host_pbView;
+
+   return( TRUE );
+}
+
+void HOST_IMAGE_Publish( void )
+{
+   UINT32 lSequence;
+   UINT16 i;
+
+   if( host_psHeader == NULL )
+   {
+      return;
+   }
+
+   lSequence = host_psHeader->lSequence + 1;
+   host_psHeader->lSequence = lSequence;
+   MemoryBarrier();
+
+   for( i = 0; i < host_iNumCopies; i++ )
+   {
+      memcpy( host_pbView + host_asCopies[ i ].lOffset,
+              host_asCopies[ i ].pbSource,
+              host_asCopies[ i ].iSize );
+   }
+   host_psHeader->llUpdateTimeUs = HOST_TIME_GetUs();
+
+   MemoryBarrier();
+   host_psHeader->lSequence = lSequence + 1;
+}
+
+void HOST_IMAGE_Close( void )
+{
+   host_psHeader = NULL;
+   host_iNumCopies = 0;
+
+   if( host_pbView != NULL )
+   {
+      UnmapViewOfFile( host_pbView );
+      host_pbView = NULL;
+   }
+   if( host_hSection != NULL )
+   {
+      CloseHandle( host_hSection );
+      host_hSection = NULL;
+   }
+}
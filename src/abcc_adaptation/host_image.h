@@ -0,0 +1,178 @@
+/*******************************************************************************
+** Copyright 2025-present HMS Industrial Networks AB.
+** Licensed under the MIT License.
+********************************************************************************
+** File Description:
+** Process image in shared memory for external consumers.
+**
+** The values of all ADIs, together with the read and write process data
+** images, are published once per communication cycle into a named shared
+** memory section. Historians, HMIs and test tools in other processes can
+** read them without any round trip to this application and without taking
+** the driver lock.
+**
+** The section is self-describing. Its layout is generated at startup from
+** ABCC_API_asAdiEntryList and ABCC_API_asAdObjDefaultMap:
+**    HOST_IMAGE_HeaderType                       at offset 0
+**    HOST_IMAGE_AdiDescType[ iNumAdis ]          at lAdiDirOffset
+**    HOST_IMAGE_MapDescType[ iNumMapEntries ]    at lMapDirOffset
+**    ADI values, each at its lValueOffset
+**    Read process data image                     at lReadPdOffset
+**    Write process data image                    at lWritePdOffset
+** All offsets are from the start of the section. The process data images are
+** the mapped ADI elements packed in map order, as on the network.
+**
+** Consistency is provided by a sequence lock. The publisher makes lSequence
+** odd while it updates the values and even again when done. A consumer
+** copies what it needs and retries if lSequence was odd or changed:
+**    do
+**    {
+**       lSeq = psHeader->lSequence;
+**       <barrier, copy values, barrier>
+**    }
+**    while( ( lSeq & 1 ) || ( lSeq != psHeader->lSequence ) );
+** The publisher never waits for consumers.
+********************************************************************************
+*/
+
+#ifndef HOST_IMAGE_H_
+#define HOST_IMAGE_H_
+
+#include "abcc_types.h"
+
+/*------------------------------------------------------------------------------
+** Section identification, "ABPI" in the first four bytes.
+**------------------------------------------------------------------------------
+*/
+#define HOST_IMAGE_MAGIC                           ( 0x49504241UL )
+#define HOST_IMAGE_VERSION                         ( 1 )
+#define HOST_IMAGE_NAME_LENGTH                     ( 32 )
+
+/*------------------------------------------------------------------------------
+** Section header.
+**
+** lMagic          - HOST_IMAGE_MAGIC.
+** iVersion        - HOST_IMAGE_VERSION.
+** iNumAdis        - Number of ADI descriptors.
+** iNumMapEntries  - Number of process data map descriptors.
+** lSectionSize    - Total size of the section.
+** lAdiDirOffset   - Offset of the ADI descriptors.
+** lMapDirOffset   - Offset of the map descriptors.
+** lReadPdOffset   - Offset and size of the read process data image.
+** iReadPdSize
+** lWritePdOffset  - Offset and size of the write process data image.
+** iWritePdSize
+** lSequence       - Sequence lock, odd while an update is in progress.
+** llUpdateTimeUs  - HOST_TIME_GetUs() of the last update. Protected by the
+**                   sequence lock.
+**------------------------------------------------------------------------------
+*/
+typedef struct HOST_IMAGE_HeaderType
+{
+   UINT32          lMagic;
+   UINT16          iVersion;
+   UINT16          iNumAdis;
+   UINT16          iNumMapEntries;
+   UINT16          iReserved;
+   UINT32          lSectionSize;
+   UINT32          lAdiDirOffset;
+   UINT32          lMapDirOffset;
+   UINT32          lReadPdOffset;
+   UINT32          lWritePdOffset;
+   UINT16          iReadPdSize;
+   UINT16          iWritePdSize;
+   volatile UINT32 lSequence;
+   volatile UINT64 llUpdateTimeUs;
+}
+HOST_IMAGE_HeaderType;
+
+/*------------------------------------------------------------------------------
+** ADI descriptor.
+**
+** iInstance       - ADI instance number.
+** bDataType       - ABP data type, e.g. ABP_UINT16.
+** bNumElements    - Number of elements.
+** bElementSize    - Size of one element in bytes.
+** bDesc           - Access descriptor from the ADI entry.
+** lValueOffset    - Offset of the value, 8 byte aligned.
+** acName          - Name, zero terminated and truncated if needed.
+**------------------------------------------------------------------------------
+*/
+typedef struct HOST_IMAGE_AdiDescType
+{
+   UINT16 iInstance;
+   UINT8  bDataType;
+   UINT8  bNumElements;
+   UINT8  bElementSize;
+   UINT8  bDesc;
+   UINT16 iReserved;
+   UINT32 lValueOffset;
+   char   acName[ HOST_IMAGE_NAME_LENGTH ];
+}
+HOST_IMAGE_AdiDescType;
+
+/*------------------------------------------------------------------------------
+** Process data map descriptor, one per default map entry.
+**
+** iInstance       - Mapped ADI instance.
+** bDirection      - PD_READ or PD_WRITE.
+** bNumElements    - Number of mapped elements.
+** bStartIndex     - First mapped element.
+** iPdOffset       - Byte offset within the read or write image.
+**------------------------------------------------------------------------------
+*/
+typedef struct HOST_IMAGE_MapDescType
+{
+   UINT16 iInstance;
+   UINT8  bDirection;
+   UINT8  bNumElements;
+   UINT8  bStartIndex;
+   UINT8  bReserved;
+   UINT16 iPdOffset;
+}
+HOST_IMAGE_MapDescType;
+
+/*------------------------------------------------------------------------------
+** HOST_IMAGE_ElementSize()
+** Size in bytes of one element of an ABP data type.
+**------------------------------------------------------------------------------
+** Outputs:
+**    Returns:  - 0 for bit field types and types without a fixed size.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC UINT8 HOST_IMAGE_ElementSize( UINT8 bDataType );
+
+/*------------------------------------------------------------------------------
+** HOST_IMAGE_Open()
+** Builds the layout from the ADI list and default map and creates the shared
+** memory section. Must be called before ABCC_API_Init().
+**------------------------------------------------------------------------------
+** Inputs:
+**    pacName - Name of the shared memory section, e.g.
+**              "Local\\abcc_process_image".
+**
+** Outputs:
+**    Returns:  - FALSE if the layout does not fit the configured limits or
+**                the section could not be created.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC BOOL HOST_IMAGE_Open( const char* pacName );
+
+/*------------------------------------------------------------------------------
+** HOST_IMAGE_Publish()
+** Copies the current ADI values and process data into the section. Does
+** nothing if the section is not open. Not reentrant, call from one context
+** only, normally ABCC_API_CbfCyclicalProcessing().
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void HOST_IMAGE_Publish( void );
+
+/*------------------------------------------------------------------------------
+** HOST_IMAGE_Close()
+** Releases the shared memory section. It disappears when the last consumer
+** has closed it.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void HOST_IMAGE_Close( void );
+
+#endif  /* inclusion lock */
@@ -0,0 +1,255 @@
+/*******************************************************************************
+** Copyright 2025-present HMS Industrial Networks AB.
+** Licensed under the MIT License.
+********************************************************************************
+** File Description:
+** Cycle interval and jitter measurement.
+********************************************************************************
+*/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "host_jitter.h"
+
+/*------------------------------------------------------------------------------
+** Tail histograms: intervals below 2^HOST_EXACT_BITS us get one bucket each.
+** Above that every power of two is split into 2^( HOST_EXACT_BITS - 1 )
+** buckets.
+**------------------------------------------------------------------------------
+*/
+#define HOST_EXACT_BITS                            ( 5 )
+#define HOST_EXACT_LIMIT                           ( 1UL << HOST_EXACT_BITS )
+#define HOST_SUB_BUCKETS                           ( HOST_EXACT_LIMIT / 2 )
+
+static FILE* host_pxCsvFile = NULL;
+static BOOL8 host_fCsvPaused = FALSE;
+
+static UINT16 BucketIndex( UINT32 lValue )
+{
+   UINT16 iShift = 1;
+
+   if( lValue < HOST_EXACT_LIMIT )
+   {
+      return( (UINT16)lValue );
+   }
+
+   while( ( lValue >> iShift ) >= HOST_EXACT_LIMIT )
+   {
+      iShift++;
+   }
+   return( (UINT16)( HOST_EXACT_LIMIT +
+                     ( iShift - 1 ) * HOST_SUB_BUCKETS +
+                     ( ( lValue >> iShift ) - HOST_SUB_BUCKETS ) ) );
+}
+
+static UINT32 BucketUpperBound( UINT16 iIndex )
+{
+   UINT16 iShift;
+   UINT64 llSub;
+
+   if( iIndex < HOST_EXACT_LIMIT )
+   {
+      return( iIndex );
+   }
+
+   iShift = (UINT16)( ( iIndex - HOST_EXACT_LIMIT ) / HOST_SUB_BUCKETS + 1 );
+   llSub = HOST_SUB_BUCKETS + ( iIndex - HOST_EXACT_LIMIT ) % HOST_SUB_BUCKETS;
+   llSub = ( ( llSub + 1 ) << iShift ) - 1;
+   return( llSub > 0xFFFFFFFFUL ? 0xFFFFFFFFUL : (UINT32)llSub );
+}
+
+void HOST_JITTER_Init( HOST_JITTER_Type* psMeter, const char* pacName, UINT32 lPeriodUs )
+{
+   memset( psMeter, 0, sizeof( *psMeter ) );
+   psMeter->pacName = pacName;
+   psMeter->lMinUs = 0xFFFFFFFFUL;
+
+   /*
+   ** Keep the window inside the 32-bit range at both ends.
+   */
+   if( lPeriodUs > 0xFFFFFFFFUL - HOST_JITTER_LINEAR_BUCKETS )
+   {
+      lPeriodUs = 0xFFFFFFFFUL - HOST_JITTER_LINEAR_BUCKETS;
+   }
+   psMeter->lLinearStartUs = ( lPeriodUs > HOST_JITTER_LINEAR_BUCKETS / 2 ) ?
+                             lPeriodUs - HOST_JITTER_LINEAR_BUCKETS / 2 : 0;
+}
+
+void HOST_JITTER_Mark( HOST_JITTER_Type* psMeter, UINT64 llNowUs )
+{
+   UINT64 llInterval;
+   UINT32 lIntervalUs;
+
+   if( !psMeter->fStarted )
+   {
+      psMeter->fStarted = TRUE;
+      psMeter->llLastUs = llNowUs;
+      return;
+   }
+
+   llInterval = llNowUs - psMeter->llLastUs;
+   lIntervalUs = llInterval > 0xFFFFFFFFUL ? 0xFFFFFFFFUL : (UINT32)llInterval;
+   psMeter->llLastUs = llNowUs;
+
+   psMeter->lCount++;
+   psMeter->llTotalUs += lIntervalUs;
+   if( lIntervalUs < psMeter->lMinUs )
+   {
+      psMeter->lMinUs = lIntervalUs;
+   }
+   if( lIntervalUs > psMeter->lMaxUs )
+   {
+      psMeter->lMaxUs = lIntervalUs;
+   }
+   if( lIntervalUs < psMeter->lLinearStartUs )
+   {
+      psMeter->alBelow[ BucketIndex( lIntervalUs ) ]++;
+   }
+   else if( lIntervalUs - psMeter->lLinearStartUs < HOST_JITTER_LINEAR_BUCKETS )
+   {
+      psMeter->alLinear[ lIntervalUs - psMeter->lLinearStartUs ]++;
+   }
+   else
+   {
+      psMeter->alAbove[ BucketIndex( lIntervalUs ) ]++;
+   }
+
+   if( ( host_pxCsvFile != NULL ) && !host_fCsvPaused )
+   {
+      fprintf( host_pxCsvFile, "%s,%llu,%lu\n",
+               psMeter->pacName,
+               (unsigned long long)llNowUs,
+               (unsigned long)lIntervalUs );
+   }
+}
+
+UINT32 HOST_JITTER_Percentile( const HOST_JITTER_Type* psMeter, UINT16 iPerMille )
+{
+   UINT64 llRank;
+   UINT64 llSeen = 0;
+   UINT32 lBound;
+   UINT16 i;
+
+   if( psMeter->lCount == 0 )
+   {
+      return( 0 );
+   }
+
+   /*
+   ** Smallest rank with at least iPerMille/1000 of the samples at or below it.
+   */
+   llRank = ( (UINT64)psMeter->lCount * iPerMille + 999 ) / 1000;
+   if( llRank == 0 )
+   {
+      llRank = 1;
+   }
+
+   /*
+   ** Walk the three histograms in interval order. A tail bucket that spans
+   ** an edge of the window only holds intervals on its own side of it.
+   */
+   lBound = psMeter->lMaxUs;
+   for( i = 0; i < HOST_JITTER_NUM_BUCKETS; i++ )
+   {
+      llSeen += psMeter->alBelow[ i ];
+      if( llSeen >= llRank )
+      {
+         lBound = BucketUpperBound( i );
+         if( lBound >= psMeter->lLinearStartUs )
+         {
+            lBound = psMeter->lLinearStartUs - 1;
+         }
+         break;
+      }
+   }
+
+   if( llSeen < llRank )
+   {
+      for( i = 0; i < HOST_JITTER_LINEAR_BUCKETS; i++ )
+      {
+         llSeen += psMeter->alLinear[ i ];
+         if( llSeen >= llRank )
+         {
+            lBound = psMeter->lLinearStartUs + i;
+            break;
+         }
+      }
+   }
+
+   if( llSeen < llRank )
+   {
+      for( i = 0; i < HOST_JITTER_NUM_BUCKETS; i++ )
+      {
+         llSeen += psMeter->alAbove[ i ];
+         if( llSeen >= llRank )
+         {
+            lBound = BucketUpperBound( i );
+            break;
+         }
+      }
+   }
+
+   return( lBound < psMeter->lMaxUs ? lBound : psMeter->lMaxUs );
+}
+
+void HOST_JITTER_GetStats( const HOST_JITTER_Type* psMeter, HOST_JITTER_StatsType* psStats )
+{
+   psStats->lCount = psMeter->lCount;
+   psStats->lMinUs = psMeter->lCount ? psMeter->lMinUs : 0;
+   psStats->lMeanUs = psMeter->lCount ? (UINT32)( psMeter->llTotalUs / psMeter->lCount ) : 0;
+   psStats->lP50Us = HOST_JITTER_Percentile( psMeter, 500 );
+   psStats->lP99Us = HOST_JITTER_Percentile( psMeter, 990 );
+   psStats->lP999Us = HOST_JITTER_Percentile( psMeter, 999 );
+   psStats->lMaxUs = psMeter->lMaxUs;
+}
+
+void HOST_JITTER_PrintHeader( void )
+{
+   printf( "Cycle intervals:\n" );
+   printf( " %-12s %9s %9s %9s %9s %9s %9s %9s\n",
+           "Meter", "Samples", "Min", "Mean", "p50", "p99", "p99.9", "Max" );
+}
+
+void HOST_JITTER_PrintStats( const HOST_JITTER_Type* psMeter )
+{
+   HOST_JITTER_StatsType sStats;
+
+   HOST_JITTER_GetStats( psMeter, &sStats );
+   printf( " %-12s %9lu %7luus %7luus %7luus %7luus %7luus %7luus\n",
+           psMeter->pacName,
+           (unsigned long)sStats.lCount,
+           (unsigned long)sStats.lMinUs,
+           (unsigned long)sStats.lMeanUs,
+           (unsigned long)sStats.lP50Us,
+           (unsigned long)sStats.lP99Us,
+           (unsigned long)sStats.lP999Us,
+           (unsigned long)sStats.lMaxUs );
+}
+
+BOOL HOST_JITTER_OpenCsv( const char* pacFileName )
+{
+   HOST_JITTER_CloseCsv();
+
+   host_pxCsvFile = fopen( pacFileName, "w" );
+   if( host_pxCsvFile == NULL )
+   {
+      return( FALSE );
+   }
+   fprintf( host_pxCsvFile, "meter,timestamp_us,interval_us\n" );
+   return( TRUE );
+}
+
+void HOST_JITTER_CloseCsv( void )
+{
+   if( host_pxCsvFile != NULL )
+   {
+      fclose( host_pxCsvFile );
+      host_pxCsvFile = NULL;
+   }
+}
+
+void HOST_JITTER_PauseCsv( BOOL8 fPause )
+{
+   host_fCsvPaused = fPause;
+}
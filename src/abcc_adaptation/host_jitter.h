@@ -0,0 +1,154 @@
+/*******************************************************************************
+** Copyright 2025-present HMS Industrial Networks AB.
+** Licensed under the MIT License.
+********************************************************************************
+** File Description:
+** Cycle interval and jitter measurement.
+**
+** A meter records the interval between consecutive calls to
+** HOST_JITTER_Mark() into a histogram. Intervals within
+** HOST_JITTER_LINEAR_BUCKETS / 2 us of the nominal period are counted in
+** 1 us buckets, so percentiles of the normal cycle jitter are exact to the
+** microsecond. Intervals outside that window go to log-linear tail
+** histograms: below 32 us exactly, longer ones in buckets of at most 1/16 of
+** their value, so that outliers of any length are still placed within about
+** 6%. Memory and time per sample are constant. Minimum, maximum and mean are
+** exact.
+**
+** The raw intervals of all meters can also be streamed to a CSV file for
+** offline analysis, one line per sample:
+**    <meter name>,<timestamp in us>,<interval in us>
+********************************************************************************
+*/
+
+#ifndef HOST_JITTER_H_
+#define HOST_JITTER_H_
+
+#include "abcc_types.h"
+
+/*------------------------------------------------------------------------------
+** Number of 1 us buckets around the nominal period, and number of log-linear
+** buckets needed to cover the full 32-bit interval range in each tail.
+**------------------------------------------------------------------------------
+*/
+#define HOST_JITTER_LINEAR_BUCKETS                 ( 2048 )
+#define HOST_JITTER_NUM_BUCKETS                    ( 464 )
+
+/*------------------------------------------------------------------------------
+** Interval meter. Treat as opaque, use HOST_JITTER_GetStats() to read it.
+**------------------------------------------------------------------------------
+*/
+typedef struct HOST_JITTER_Type
+{
+   const char* pacName;
+   BOOL8       fStarted;
+   UINT64      llLastUs;
+   UINT32      lCount;
+   UINT32      lMinUs;
+   UINT32      lMaxUs;
+   UINT64      llTotalUs;
+   UINT32      lLinearStartUs;
+   UINT32      alLinear[ HOST_JITTER_LINEAR_BUCKETS ];
+   UINT32      alBelow[ HOST_JITTER_NUM_BUCKETS ];
+   UINT32      alAbove[ HOST_JITTER_NUM_BUCKETS ];
+}
+HOST_JITTER_Type;
+
+/*------------------------------------------------------------------------------
+** Summary of a meter. All values in microseconds.
+**------------------------------------------------------------------------------
+*/
+typedef struct HOST_JITTER_StatsType
+{
+   UINT32 lCount;
+   UINT32 lMinUs;
+   UINT32 lMeanUs;
+   UINT32 lP50Us;
+   UINT32 lP99Us;
+   UINT32 lP999Us;
+   UINT32 lMaxUs;
+}
+HOST_JITTER_StatsType;
+
+/*------------------------------------------------------------------------------
+** HOST_JITTER_Init()
+** Clears a meter. The first HOST_JITTER_Mark() after this only sets the
+** starting point.
+**------------------------------------------------------------------------------
+** Inputs:
+**    psMeter   - Meter to clear.
+**    pacName   - Name used in the printout and the CSV file.
+**    lPeriodUs - Nominal interval, the centre of the 1 us buckets. 0 if there
+**                is none, the 1 us buckets then start at 0.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void HOST_JITTER_Init( HOST_JITTER_Type* psMeter, const char* pacName, UINT32 lPeriodUs );
+
+/*------------------------------------------------------------------------------
+** HOST_JITTER_Mark()
+** Records the interval since the previous mark.
+**------------------------------------------------------------------------------
+** Inputs:
+**    psMeter - Meter.
+**    llNowUs - Current time from HOST_TIME_GetUs().
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void HOST_JITTER_Mark( HOST_JITTER_Type* psMeter, UINT64 llNowUs );
+
+/*------------------------------------------------------------------------------
+** HOST_JITTER_Percentile()
+** Estimates a percentile from the histogram.
+**------------------------------------------------------------------------------
+** Inputs:
+**    psMeter    - Meter.
+**    iPerMille  - Percentile in 1/1000, for example 999 for p99.9.
+**
+** Outputs:
+**    Returns:   - Upper bound of the bucket holding the percentile, never more
+**                 than the largest recorded interval. Exact for a percentile
+**                 within the 1 us buckets. 0 if nothing has been recorded.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC UINT32 HOST_JITTER_Percentile( const HOST_JITTER_Type* psMeter, UINT16 iPerMille );
+
+/*------------------------------------------------------------------------------
+** HOST_JITTER_GetStats()
+** Reads the summary of a meter.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void HOST_JITTER_GetStats( const HOST_JITTER_Type* psMeter, HOST_JITTER_StatsType* psStats );
+
+/*------------------------------------------------------------------------------
+** HOST_JITTER_PrintHeader()
+** HOST_JITTER_PrintStats()
+** Prints a table header and one table row per meter.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void HOST_JITTER_PrintHeader( void );
+EXTFUNC void HOST_JITTER_PrintStats( const HOST_JITTER_Type* psMeter );
+
+/*------------------------------------------------------------------------------
+** HOST_JITTER_OpenCsv()
+** HOST_JITTER_CloseCsv()
+** Starts and stops streaming the samples of all meters to a CSV file. An
+** existing file is overwritten.
+**------------------------------------------------------------------------------
+** Inputs:
+**    pacFileName - Name of the file.
+**
+** Outputs:
+**    Returns:    - FALSE if the file could not be created.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC BOOL HOST_JITTER_OpenCsv( const char* pacFileName );
+EXTFUNC void HOST_JITTER_CloseCsv( void );
+
+/*------------------------------------------------------------------------------
+** HOST_JITTER_PauseCsv()
+** Stops or resumes writing samples to the CSV file. The statistics are still
+** collected while paused.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void HOST_JITTER_PauseCsv( BOOL8 fPause );
+
+#endif  /* inclusion lock */
@@ -0,0 +1,66 @@
+/*******************************************************************************
+** Copyright 2025-present HMS Industrial Networks AB.
+** Licensed under the MIT License.
+********************************************************************************
+** File Description:
+** Locks with contention metrics.
+********************************************************************************
+*/
+
+#include "windows.h"
+#include "stdio.h"
+#include "string.h"
+
+#include "host_time.h"
+#include "host_lock.h"
+#include "host_trace.h"
+
+void HOST_LOCK_Init( HOST_LOCK_Type* psLock, const char* pacName )
+{
+   memset( psLock, 0, sizeof( *psLock ) );
+   psLock->pacName = pacName;
+   InitializeCriticalSection( &psLock->sSection );
+}
+
+void HOST_LOCK_Enter( HOST_LOCK_Type* psLock )
+{
+   UINT64 llStartUs;
+   UINT64 llTraceNs;
+   UINT32 lWaitUs;
+
+   if( TryEnterCriticalSection( &psLock->sSection ) )
+   {
+      psLock->lNumAcquired++;
+      return;
+   }
+
+   llTraceNs = HOST_TRACE_Begin();
+   llStartUs = HOST_TIME_GetUs();
+   EnterCriticalSection( &psLock->sSection );
+   lWaitUs = (UINT32)( HOST_TIME_GetUs() - llStartUs );
+   HOST_TRACE_End( HOST_TRACE_CAT_LOCK, psLock->pacName, llTraceNs, 0 );
+
+   psLock->lNumAcquired++;
+   psLock->lNumContended++;
+   psLock->llWaitUs += lWaitUs;
+   if( lWaitUs > psLock->lMaxWaitUs )
+   {
+      psLock->lMaxWaitUs = lWaitUs;
+   }
+}
+
+void HOST_LOCK_Exit( HOST_LOCK_Type* psLock )
+{
+   LeaveCriticalSection( &psLock->sSection );
+}
+
+void HOST_LOCK_PrintStats( HOST_LOCK_Type* psLock )
+{
+   printf( " %-10s %10lu acquired, %8lu contended (%.2f%%), mean wait %.1fus, max wait %luus\n",
+           psLock->pacName,
+           (unsigned long)psLock->lNumAcquired,
+           (unsigned long)psLock->lNumContended,
+           psLock->lNumAcquired ? 100.0 * psLock->lNumContended / psLock->lNumAcquired : 0.0,
+           psLock->lNumContended ? (double)psLock->llWaitUs / psLock->lNumContended : 0.0,
+           (unsigned long)psLock->lMaxWaitUs );
+}
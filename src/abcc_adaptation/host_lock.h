@@ -0,0 +1,69 @@
+/*******************************************************************************
+** Copyright 2025-present HMS Industrial Networks AB.
+** Licensed under the MIT License.
+********************************************************************************
+** File Description:
+** Locks with contention metrics.
+**
+** A thin layer over a Windows critical section. Each acquisition is first
+** tried without waiting. Only when that fails is the wait timed, so an
+** uncontended lock costs no more than the critical section itself.
+**
+** The statistics are updated while the lock is held, so they need no
+** further protection. Like a critical section the lock is recursive.
+********************************************************************************
+*/
+
+#ifndef HOST_LOCK_H_
+#define HOST_LOCK_H_
+
+#include "windows.h"
+#include "abcc_types.h"
+
+/*------------------------------------------------------------------------------
+** Lock.
+**
+** pacName         - Name used in the statistics printout.
+** sSection        - The critical section.
+** lNumAcquired    - Number of acquisitions.
+** lNumContended   - Acquisitions that had to wait.
+** llWaitUs        - Total time spent waiting.
+** lMaxWaitUs      - Longest single wait.
+**------------------------------------------------------------------------------
+*/
+typedef struct HOST_LOCK_Type
+{
+   const char*      pacName;
+   CRITICAL_SECTION sSection;
+   UINT32           lNumAcquired;
+   UINT32           lNumContended;
+   UINT64           llWaitUs;
+   UINT32           lMaxWaitUs;
+}
+HOST_LOCK_Type;
+
+/*------------------------------------------------------------------------------
+** HOST_LOCK_Init()
+** Initialises a lock. Must be done before the lock is shared between
+** threads.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void HOST_LOCK_Init( HOST_LOCK_Type* psLock, const char* pacName );
+
+/*------------------------------------------------------------------------------
+** HOST_LOCK_Enter()
+** HOST_LOCK_Exit()
+** Acquires and releases a lock.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void HOST_LOCK_Enter( HOST_LOCK_Type* psLock );
+EXTFUNC void HOST_LOCK_Exit( HOST_LOCK_Type* psLock );
+
+/*------------------------------------------------------------------------------
+** HOST_LOCK_PrintStats()
+** Prints one line with the lock's contention statistics.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void HOST_LOCK_PrintStats( HOST_LOCK_Type* psLock );
+
+#endif  /* inclusion lock */
@@ -0,0 +1,208 @@
+/*******************************************************************************
+** Copyright 2025-present HMS Industrial Networks AB.
+** Licensed under the MIT License.
+********************************************************************************
+** File Description:
+** Locked, prefaulted memory for the cyclic path, and page fault counting.
+********************************************************************************
+*/
+
+#include "windows.h"
+#include "psapi.h"
+#include "stdio.h"
+
+#include "host_memory.h"
+
+#pragma comment( lib, "Psapi.lib" )
+
+/*------------------------------------------------------------------------------
+** Headroom added on top of each working set increase, and the number of
+** VirtualLock() attempts per range. Another thread may raise the working set
+** at the same time, so a failed attempt is retried after growing it again.
+**------------------------------------------------------------------------------
+*/
+#define HOST_MEMORY_WS_MARGIN_BYTES                ( 1024 * 1024 )
+#define HOST_MEMORY_LOCK_TRIES                     ( 3 )
+
+static volatile LONG host_lNumLocked = 0;
+static volatile LONG host_lLockedBytes = 0;
+static volatile LONG host_lNumFailures = 0;
+
+static DWORD  host_lLastFaultCount = 0;
+static BOOL8  host_fFaultsSampled = FALSE;
+static UINT32 host_lCyclicFaults = 0;
+static UINT32 host_lMaxFaultsPerSample = 0;
+static UINT32 host_lNumCyclicSamples = 0;
+static UINT32 host_lNumFaultySamples = 0;
+
+#if( HOST_CFG_MEMORY_LOCK_ENABLED )
+static BOOL GrowWorkingSet( SIZE_T nBytes )
+{
+   SIZE_T nMin;
+   SIZE_T nMax;
+
+   if( !GetProcessWorkingSetSize( GetCurrentProcess(), &nMin, &nMax ) )
+   {
+      return( FALSE );
+   }
+   nMin += nBytes + HOST_MEMORY_WS_MARGIN_BYTES;
+   if( nMax < nMin + HOST_MEMORY_WS_MARGIN_BYTES )
+   {
+      nMax = nMin + HOST_MEMORY_WS_MARGIN_BYTES;
+   }
+   return( SetProcessWorkingSetSize( GetCurrentProcess(), nMin, nMax ) );
+}
+
+static BOOL LockRange( void* pxStart, SIZE_T nSize )
+{
+   UINT8 bTry;
+
+   for( bTry = 0; bTry < HOST_MEMORY_LOCK_TRIES; bTry++ )
+   {
+      if( !GrowWorkingSet( nSize ) )
+      {
+         return( FALSE );
+      }
+      if( VirtualLock( pxStart, nSize ) )
+      {
+         return( TRUE );
+      }
+   }
+   return( FALSE );
+}
+#endif
+
+void HOST_MEMORY_Lock( const char* pacName, const void* pxStart, UINT32 lSize )
+{
+#if( HOST_CFG_MEMORY_LOCK_ENABLED )
+   MEMORY_BASIC_INFORMATION sInfo;
+   const UINT8*             pbNext;
+   const UINT8*             pbEnd;
+   const UINT8*             pbRangeStart;
+   const UINT8*             pbRangeEnd;
+   UINT32                   lLocked = 0;
+   BOOL8                    fFailed = FALSE;
+
+   if( ( pxStart == NULL ) || ( lSize == 0 ) )
+   {
+      return;
+   }
+
+   /*
+   ** Only committed, accessible pages can be locked. An image has a few
+   ** pages that are not, so the range is walked region by region.
+   */
+   pbNext = (const UINT8*)pxStart;
+   pbEnd = pbNext + lSize;
+   while( ( pbNext < pbEnd ) && ( VirtualQuery( pbNext, &sInfo, sizeof( sInfo ) ) != 0 ) )
+   {
+      pbRangeStart = pbNext;
+      pbRangeEnd = (const UINT8*)sInfo.BaseAddress + sInfo.RegionSize;
+      if( pbRangeEnd > pbEnd )
+      {
+         pbRangeEnd = pbEnd;
+      }
+      if( ( sInfo.State == MEM_COMMIT ) && !( sInfo.Protect & ( PAGE_NOACCESS | PAGE_GUARD ) ) )
+      {
+         if( LockRange( (void*)pbRangeStart, pbRangeEnd - pbRangeStart ) )
+         {
+            lLocked += (UINT32)( pbRangeEnd - pbRangeStart );
+         }
+         else
+         {
+            fFailed = TRUE;
+         }
+      }
+      pbNext = pbRangeEnd;
+   }
+
+   if( fFailed )
+   {
+      InterlockedIncrement( &host_lNumFailures );
+      printf( "Could not lock all of %s (error %lu), %lu of %lu bytes locked\n",
+              pacName, GetLastError(), (unsigned long)lLocked, (unsigned long)lSize );
+   }
+   InterlockedIncrement( &host_lNumLocked );
+   InterlockedExchangeAdd( &host_lLockedBytes, (LONG)lLocked );
+#else
+   (void)pacName;
+   (void)pxStart;
+   (void)lSize;
+#endif
+}
+
+void HOST_MEMORY_LockImage( void )
+{
+   MODULEINFO sModule;
+
+   if( GetModuleInformation( GetCurrentProcess(), GetModuleHandleA( NULL ), &sModule, sizeof( sModule ) ) )
+   {
+      HOST_MEMORY_Lock( "executable image", sModule.lpBaseOfDll, sModule.SizeOfImage );
+   }
+}
+
+void HOST_MEMORY_LockStack( const char* pacName )
+{
+   /*
+   ** The probe array lies just below the caller's frame. Touching it page by
+   ** page commits the stack in order through the guard page, after which the
+   ** pages stay committed for the calls the thread makes later.
+   */
+   volatile UINT8 abProbe[ HOST_CFG_MEMORY_STACK_BYTES ];
+   UINT32         i;
+
+   for( i = 0; i < sizeof( abProbe ); i += 4096 )
+   {
+      abProbe[ sizeof( abProbe ) - 1 - i ] = 0;
+   }
+   abProbe[ 0 ] = 0;
+   HOST_MEMORY_Lock( pacName, (const void*)abProbe, sizeof( abProbe ) );
+}
+
+void HOST_MEMORY_SampleFaults( BOOL8 fCyclic )
+{
+   PROCESS_MEMORY_COUNTERS sCounters;
+   UINT32                  lFaults;
+
+   if( !GetProcessMemoryInfo( GetCurrentProcess(), &sCounters, sizeof( sCounters ) ) )
+   {
+      return;
+   }
+
+   lFaults = sCounters.PageFaultCount - host_lLastFaultCount;
+   host_lLastFaultCount = sCounters.PageFaultCount;
+   if( !host_fFaultsSampled )
+   {
+      host_fFaultsSampled = TRUE;
+      return;
+   }
+
+   if( fCyclic )
+   {
+      host_lNumCyclicSamples++;
+      host_lCyclicFaults += lFaults;
+      if( lFaults > 0 )
+      {
+         host_lNumFaultySamples++;
+      }
+      if( lFaults > host_lMaxFaultsPerSample )
+      {
+         host_lMaxFaultsPerSample = lFaults;
+      }
+   }
+}
+
+void HOST_MEMORY_PrintStats( void )
+{
+   printf( "Memory:\n" );
+   printf( " %lu regions locked, %lu kB, %lu incomplete\n",
+           (unsigned long)host_lNumLocked,
+           (unsigned long)host_lLockedBytes / 1024,
+           (unsigned long)host_lNumFailures );
+   printf( " %lu page faults in PROCESS_ACTIVE, in %lu of %lu samples, max %lu per %lums\n",
+           (unsigned long)host_lCyclicFaults,
+           (unsigned long)host_lNumFaultySamples,
+           (unsigned long)host_lNumCyclicSamples,
+           (unsigned long)host_lMaxFaultsPerSample,
+           (unsigned long)( HOST_CFG_MEMORY_FAULT_SAMPLE_US / 1000 ) );
+}
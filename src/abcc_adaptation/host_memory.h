@@ -0,0 +1,79 @@
+/*******************************************************************************
+** Copyright 2025-present HMS Industrial Networks AB.
+** Licensed under the MIT License.
+********************************************************************************
+** File Description:
+** Locked, prefaulted memory for the cyclic path, and page fault counting.
+**
+** The first touch of a page that is not in the working set is a page fault,
+** and a hard fault that has to read from disk can take milliseconds. Memory
+** that the cyclic path uses is therefore locked into the working set before
+** the driver is started:
+**    - The executable image: code, constants and all static buffers, among
+**      them the message pools, the timer wheel and the trace ring.
+**    - Regions allocated at startup, e.g. the process data buffers.
+**    - The stack of each cyclic thread, locked by the thread itself.
+** VirtualLock() brings the pages in as it locks them. The working set
+** minimum is raised as needed so that the locks fit.
+**
+** HOST_MEMORY_SampleFaults() is called periodically and counts the page
+** faults of the whole process while the ABCC is in PROCESS_ACTIVE. Windows
+** does not tell soft and hard faults apart here, so any fault counted once
+** the application is warmed up is worth a look.
+**
+** With HOST_CFG_MEMORY_LOCK_ENABLED set to 0 nothing is locked, but faults
+** are still counted.
+********************************************************************************
+*/
+
+#ifndef HOST_MEMORY_H_
+#define HOST_MEMORY_H_
+
+#include "abcc_types.h"
+#include "abcc_config.h"
+
+/*------------------------------------------------------------------------------
+** HOST_MEMORY_LockImage()
+** Locks the committed pages of the executable image.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void HOST_MEMORY_LockImage( void );
+
+/*------------------------------------------------------------------------------
+** HOST_MEMORY_Lock()
+** Locks a region into the working set. Failures are printed and counted, the
+** application runs on without the lock.
+**------------------------------------------------------------------------------
+** Inputs:
+**    pacName  - Region name for the printout.
+**    pxStart  - Start of the region. NULL is ignored.
+**    lSize    - Size of the region in bytes.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void HOST_MEMORY_Lock( const char* pacName, const void* pxStart, UINT32 lSize );
+
+/*------------------------------------------------------------------------------
+** HOST_MEMORY_LockStack()
+** Commits and locks HOST_CFG_MEMORY_STACK_BYTES of the calling thread's
+** stack below the current frame. Call at the start of each thread that is
+** on the cyclic path.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void HOST_MEMORY_LockStack( const char* pacName );
+
+/*------------------------------------------------------------------------------
+** HOST_MEMORY_SampleFaults()
+** Reads the process page fault count. The faults since the previous sample
+** are counted as cyclic if fCyclic is set.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void HOST_MEMORY_SampleFaults( BOOL8 fCyclic );
+
+/*------------------------------------------------------------------------------
+** HOST_MEMORY_PrintStats()
+** Prints the locked memory and the page faults during cyclic operation.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void HOST_MEMORY_PrintStats( void );
+
+#endif  /* inclusion lock */
@@ -0,0 +1,105 @@
+/*******************************************************************************
+** Copyright 2025-present HMS Industrial Networks AB.
+** Licensed under the MIT License.
+********************************************************************************
+** File Description:
+** Fixed-size block pool used for host side message buffers.
+********************************************************************************
+*/
+
+#include "host_msg_pool.h"
+
+void HOST_MSG_POOL_Init( HOST_MSG_POOL_Type* psPool,
+                         void* pxStorage,
+                         UINT16* paiNextFree,
+                         UINT16 iBlockSize,
+                         UINT16 iDepth )
+{
+   UINT16 i;
+
+   psPool->pbStorage = (UINT8*)pxStorage;
+   psPool->paiNextFree = paiNextFree;
+   psPool->iBlockSize = iBlockSize;
+
+   for( i = 0; i < iDepth; i++ )
+   {
+      paiNextFree[ i ] = (UINT16)( i + 1 );
+   }
+   if( iDepth > 0 )
+   {
+      paiNextFree[ iDepth - 1 ] = HOST_MSG_POOL_END_OF_LIST;
+      psPool->iFreeHead = 0;
+   }
+   else
+   {
+      psPool->iFreeHead = HOST_MSG_POOL_END_OF_LIST;
+   }
+
+   psPool->sStats.iDepth = iDepth;
+   psPool->sStats.iInUse = 0;
+   HOST_MSG_POOL_ResetStats( psPool );
+}
+
+void* HOST_MSG_POOL_Alloc( HOST_MSG_POOL_Type* psPool )
+{
+   UINT16 iIndex;
+
+   iIndex = psPool->iFreeHead;
+   if( iIndex == HOST_MSG_POOL_END_OF_LIST )
+   {
+      psPool->sStats.lNumExhausted++;
+      return( NULL );
+   }
+
+   psPool->iFreeHead = psPool->paiNextFree[ iIndex ];
+   psPool->paiNextFree[ iIndex ] = HOST_MSG_POOL_END_OF_LIST;
+
+   psPool->sStats.lNumAllocs++;
+   psPool->sStats.iInUse++;
+   if( psPool->sStats.iInUse > psPool->sStats.iHighWaterMark )
+   {
+      psPool->sStats.iHighWaterMark = psPool->sStats.iInUse;
+   }
+
+   return( psPool->pbStorage + (UINT32)iIndex * psPool->iBlockSize );
+}
+
+void HOST_MSG_POOL_Free( HOST_MSG_POOL_Type* psPool, void* pxBlock )
+{
+   UINT8* pbBlock = (UINT8*)pxBlock;
+   UINT32 lOffset;
+   UINT16 iIndex;
+
+   if( ( pbBlock == NULL ) || ( pbBlock < psPool->pbStorage ) )
+   {
+      return;
+   }
+
+   lOffset = (UINT32)( pbBlock - psPool->pbStorage );
+   iIndex = (UINT16)( lOffset / psPool->iBlockSize );
+   if( ( iIndex >= psPool->sStats.iDepth ) ||
+       ( ( lOffset % psPool->iBlockSize ) != 0 ) )
+   {
+      return;
+   }
+
+   psPool->paiNextFree[ iIndex ] = psPool->iFreeHead;
+   psPool->iFreeHead = iIndex;
+
+   psPool->sStats.lNumFrees++;
+   psPool->sStats.iInUse--;
+}
+
+void HOST_MSG_POOL_GetStats( const HOST_MSG_POOL_Type* psPool,
+                             HOST_MSG_POOL_StatsType* psStats )
+{
+   *psStats = psPool->sStats;
+}
+
+void HOST_MSG_POOL_ResetStats( HOST_MSG_POOL_Type* psPool )
+{
+   psPool->sStats.iHighWaterMark = psPool->sStats.iInUse;
+   psPool->sStats.lNumAllocs = 0;
+   psPool->sStats.lNumFrees = 0;
+   psPool->sStats.lNumExhausted = 0;
+}
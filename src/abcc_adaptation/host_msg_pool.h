@@ -0,0 +1,117 @@
+/*******************************************************************************
+** Copyright 2025-present HMS Industrial Networks AB.
+** Licensed under the MIT License.
+********************************************************************************
+** File Description:
+** Fixed-size block pool used for host side message buffers. All storage is
+** supplied by the caller, so the pool never touches the heap and allocation
+** and release are both O(1).
+**
+** The pool is not thread safe. It is intended to be used from the main loop,
+** i.e. the same context that calls ABCC_API_Run().
+********************************************************************************
+*/
+
+#ifndef HOST_MSG_POOL_H_
+#define HOST_MSG_POOL_H_
+
+#include "abcc_types.h"
+
+/*------------------------------------------------------------------------------
+** Marks the end of the free list.
+**------------------------------------------------------------------------------
+*/
+#define HOST_MSG_POOL_END_OF_LIST                  ( 0xFFFF )
+
+/*------------------------------------------------------------------------------
+** Pool statistics.
+**
+** iDepth         - Number of blocks in the pool.
+** iInUse         - Number of blocks currently allocated.
+** iHighWaterMark - Highest value iInUse has reached since the last reset.
+** lNumAllocs     - Number of successful allocations.
+** lNumFrees      - Number of released blocks.
+** lNumExhausted  - Number of allocation attempts rejected because the pool
+**                  was empty, i.e. the number of times backpressure was
+**                  applied to the caller.
+**------------------------------------------------------------------------------
+*/
+typedef struct HOST_MSG_POOL_StatsType
+{
+   UINT16 iDepth;
+   UINT16 iInUse;
+   UINT16 iHighWaterMark;
+   UINT32 lNumAllocs;
+   UINT32 lNumFrees;
+   UINT32 lNumExhausted;
+}
+HOST_MSG_POOL_StatsType;
+
+/*------------------------------------------------------------------------------
+** Pool instance. Treat as opaque, use the functions below.
+**------------------------------------------------------------------------------
+*/
+typedef struct HOST_MSG_POOL_Type
+{
+   UINT8*                  pbStorage;
+   UINT16*                 paiNextFree;
+   UINT16                  iBlockSize;
+   UINT16                  iFreeHead;
+   HOST_MSG_POOL_StatsType sStats;
+}
+HOST_MSG_POOL_Type;
+
+/*------------------------------------------------------------------------------
+** HOST_MSG_POOL_Init()
+** Sets up a pool on top of caller supplied storage.
+**------------------------------------------------------------------------------
+** Inputs:
+**    psPool      - Pool instance to initialize.
+**    pxStorage   - iDepth * iBlockSize bytes of storage. Declaring it as an
+**                  array of the block type guarantees correct alignment.
+**    paiNextFree - Array of iDepth free list links.
+**    iBlockSize  - Size of each block in bytes.
+**    iDepth      - Number of blocks, must be less than
+**                  HOST_MSG_POOL_END_OF_LIST.
+**
+** Usage:
+**    static ABP_MsgType asBuffers[ 16 ];
+**    static UINT16      aiLinks[ 16 ];
+**    HOST_MSG_POOL_Init( &sPool, asBuffers, aiLinks, sizeof( ABP_MsgType ), 16 );
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void HOST_MSG_POOL_Init( HOST_MSG_POOL_Type* psPool,
+                                 void* pxStorage,
+                                 UINT16* paiNextFree,
+                                 UINT16 iBlockSize,
+                                 UINT16 iDepth );
+
+/*------------------------------------------------------------------------------
+** HOST_MSG_POOL_Alloc()
+** Takes a block from the pool.
+**------------------------------------------------------------------------------
+** Outputs:
+**    Returns:    - Pointer to the block, or NULL if the pool is exhausted.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void* HOST_MSG_POOL_Alloc( HOST_MSG_POOL_Type* psPool );
+
+/*------------------------------------------------------------------------------
+** HOST_MSG_POOL_Free()
+** Returns a block to the pool. Pointers not owned by the pool are ignored.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void HOST_MSG_POOL_Free( HOST_MSG_POOL_Type* psPool, void* pxBlock );
+
+/*------------------------------------------------------------------------------
+** HOST_MSG_POOL_GetStats()
+** HOST_MSG_POOL_ResetStats()
+** Reads the pool statistics. Resetting clears the counters and sets the high
+** water mark to the current number of blocks in use.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void HOST_MSG_POOL_GetStats( const HOST_MSG_POOL_Type* psPool,
+                                     HOST_MSG_POOL_StatsType* psStats );
+EXTFUNC void HOST_MSG_POOL_ResetStats( HOST_MSG_POOL_Type* psPool );
+
+#endif  /* inclusion lock */
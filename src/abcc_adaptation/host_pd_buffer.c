@@ -0,0 +1,105 @@
+/*******************************************************************************
+** Copyright 2025-present HMS Industrial Networks AB.
+** Licensed under the MIT License.
+********************************************************************************
+** File Description:
+** Process data buffers for the parallel interface.
+********************************************************************************
+*/
+
+#include "malloc.h"
+#include "string.h"
+
+#include "abcc_software_port.h"
+#include "host_pd_buffer.h"
+
+#if( HOST_CFG_PD_BUFFER_ALIGN & ( HOST_CFG_PD_BUFFER_ALIGN - 1 ) )
+#error HOST_CFG_PD_BUFFER_ALIGN must be a power of two
+#endif
+
+#define HOST_PD_BUFFER_ROUND_UP( x )               ( ( (x) + HOST_CFG_PD_BUFFER_ALIGN - 1 ) & \
+                                                     ~( (UINT32)HOST_CFG_PD_BUFFER_ALIGN - 1 ) )
+
+static UINT8* host_pbBlock = NULL;
+static UINT8* host_pbRead = NULL;
+static UINT8* host_pbWrite = NULL;
+static UINT16 host_iReadSize = 0;
+static UINT16 host_iWriteSize = 0;
+static UINT32 host_lBlockSize = 0;
+
+BOOL HOST_PD_BUFFER_Init( UINT16 iReadSize, UINT16 iWriteSize )
+{
+   UINT32 lReadSpan;
+   UINT32 lBlockSize;
+
+   HOST_PD_BUFFER_Close();
+
+   if( ( iReadSize > ABCC_CFG_MAX_PROCESS_DATA_SIZE ) ||
+       ( iWriteSize > ABCC_CFG_MAX_PROCESS_DATA_SIZE ) )
+   {
+      ABCC_PORT_printf( "Process data of %u/%u bytes exceeds ABCC_CFG_MAX_PROCESS_DATA_SIZE\n",
+                        iReadSize, iWriteSize );
+      return( FALSE );
+   }
+
+   /*
+   ** One block, the write buffer starting on the first cache line after the
+   ** read buffer. An unused direction still gets one cache line, so that
+   ** both buffers are valid pointers.
+   */
+   lReadSpan = HOST_PD_BUFFER_ROUND_UP( iReadSize > 0 ? iReadSize : 1 );
+   lBlockSize = lReadSpan + HOST_PD_BUFFER_ROUND_UP( iWriteSize > 0 ? iWriteSize : 1 );
+   host_pbBlock = (UINT8*)_aligned_malloc( lBlockSize, HOST_CFG_PD_BUFFER_ALIGN );
+   if( host_pbBlock == NULL )
+   {
+      ABCC_PORT_printf( "Could not allocate the process data buffers\n" );
+      return( FALSE );
+   }
+   memset( host_pbBlock, 0, lBlockSize );
+
+   host_pbRead = host_pbBlock;
+   host_pbWrite = host_pbBlock + lReadSpan;
+   host_iReadSize = iReadSize;
+   host_iWriteSize = iWriteSize;
+   host_lBlockSize = lBlockSize;
+   return( TRUE );
+}
+
+void HOST_PD_BUFFER_Close( void )
+{
+   if( host_pbBlock != NULL )
+   {
+      _aligned_free( host_pbBlock );
+   }
+   host_pbBlock = NULL;
+   host_pbRead = NULL;
+   host_pbWrite = NULL;
+   host_iReadSize = 0;
+   host_iWriteSize = 0;
+   host_lBlockSize = 0;
+}
+
+UINT8* HOST_PD_BUFFER_Read( void )
+{
+   return( host_pbRead );
+}
+
+UINT8* HOST_PD_BUFFER_Write( void )
+{
+   return( host_pbWrite );
+}
+
+UINT16 HOST_PD_BUFFER_ReadSize( void )
+{
+   return( host_iReadSize );
+}
+
+UINT16 HOST_PD_BUFFER_WriteSize( void )
+{
+   return( host_iWriteSize );
+}
+
+UINT32 HOST_PD_BUFFER_Span( void )
+{
+   return( host_lBlockSize );
+}
@@ -0,0 +1,76 @@
+/*******************************************************************************
+** Copyright 2025-present HMS Industrial Networks AB.
+** Licensed under the MIT License.
+********************************************************************************
+** File Description:
+** Process data buffers for the parallel interface.
+**
+** The read and write process data buffers are allocated at startup, sized
+** from the default map, see APPL_ADI_iReadPdSize. The HAL rejects a
+** transfer longer than a buffer. The driver does not report a remap to the
+** host application, so an application that lets the network remap its
+** process data must size both buffers to ABCC_CFG_MAX_PROCESS_DATA_SIZE.
+**
+** The buffers are aligned to HOST_CFG_PD_BUFFER_ALIGN and placed so that
+** they never share a cache line, since the read side is filled by the driver
+** while the application updates the write side.
+********************************************************************************
+*/
+
+#ifndef HOST_PD_BUFFER_H_
+#define HOST_PD_BUFFER_H_
+
+#include "abcc_types.h"
+#include "abcc_config.h"
+
+/*------------------------------------------------------------------------------
+** HOST_PD_BUFFER_Init()
+** Allocates the buffers. Must be called before ABCC_API_Init().
+**------------------------------------------------------------------------------
+** Inputs:
+**    iReadSize      - Read process data size in bytes.
+**    iWriteSize     - Write process data size in bytes.
+**
+** Outputs:
+**    Returns:       - FALSE if a size exceeds ABCC_CFG_MAX_PROCESS_DATA_SIZE
+**                     or the buffers could not be allocated.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC BOOL HOST_PD_BUFFER_Init( UINT16 iReadSize, UINT16 iWriteSize );
+
+/*------------------------------------------------------------------------------
+** HOST_PD_BUFFER_Close()
+** Frees the buffers. The driver must have been shut down.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void HOST_PD_BUFFER_Close( void );
+
+/*------------------------------------------------------------------------------
+** HOST_PD_BUFFER_Read()
+** HOST_PD_BUFFER_Write()
+** Return the read and write process data buffers, NULL before
+** HOST_PD_BUFFER_Init().
+**------------------------------------------------------------------------------
+*/
+EXTFUNC UINT8* HOST_PD_BUFFER_Read( void );
+EXTFUNC UINT8* HOST_PD_BUFFER_Write( void );
+
+/*------------------------------------------------------------------------------
+** HOST_PD_BUFFER_ReadSize()
+** HOST_PD_BUFFER_WriteSize()
+** Return the size of each buffer in bytes, as passed to
+** HOST_PD_BUFFER_Init().
+**------------------------------------------------------------------------------
+*/
+EXTFUNC UINT16 HOST_PD_BUFFER_ReadSize( void );
+EXTFUNC UINT16 HOST_PD_BUFFER_WriteSize( void );
+
+/*------------------------------------------------------------------------------
+** HOST_PD_BUFFER_Span()
+** Size in bytes of the memory holding both buffers, starting at
+** HOST_PD_BUFFER_Read(), e.g. for locking it into the working set.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC UINT32 HOST_PD_BUFFER_Span( void );
+
+#endif  /* inclusion lock */
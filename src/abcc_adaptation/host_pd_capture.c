@@ -0,0 +1,154 @@
+/*******************************************************************************
+** Copyright 2025-present HMS Industrial Networks AB.
+** Licensed under the MIT License.
+********************************************************************************
+** File Description:
+** Process data capture to a memory-mapped ring file.
+********************************************************************************
+*/
+
+#include "windows.h"
+#include "string.h"
+
+#include "abcc_software_port.h"
+#include "host_time.h"
+#include "host_pd_capture.h"
+
+#define HOST_PD_CAPTURE_HEADER_SIZE                ( 64 )
+
+static HANDLE                          host_hFile = INVALID_HANDLE_VALUE;
+static HANDLE                          host_hMapping = NULL;
+static UINT8*                          host_pbView = NULL;
+static HOST_PD_CAPTURE_FileHeaderType* host_psHeader = NULL;
+static UINT16                          host_iMaxPdSize;
+static SIZE_T                          host_xViewSize;
+static volatile BOOL8                  host_fPaused = FALSE;
+
+BOOL HOST_PD_CAPTURE_Open( const char* pacFileName, UINT32 lNumRecords, UINT16 iMaxPdSize )
+{
+   UINT32 lRecordSize;
+   UINT64 llFileSize;
+
+   HOST_PD_CAPTURE_Close();
+
+   if( lNumRecords == 0 )
+   {
+      return( FALSE );
+   }
+
+   lRecordSize = ( sizeof( HOST_PD_CAPTURE_RecordType ) + iMaxPdSize + 7 ) & ~7UL;
+   llFileSize = HOST_PD_CAPTURE_HEADER_SIZE + (UINT64)lRecordSize * lNumRecords;
+
+   host_hFile = CreateFileA( pacFileName,
+                             GENERIC_READ | GENERIC_WRITE,
+                             FILE_SHARE_READ | FILE_SHARE_WRITE,
+                             NULL,
+                             CREATE_ALWAYS,
+                             FILE_ATTRIBUTE_NORMAL,
+                             NULL );
+   if( host_hFile == INVALID_HANDLE_VALUE )
+   {
+      ABCC_PORT_printf( "Could not create %s (error %lu)\n", pacFileName, GetLastError() );
+      return( FALSE );
+   }
+
+   /*
+   ** Creating the mapping with the full size extends the file.
+   */
+   host_hMapping = CreateFileMappingA( host_hFile,
+                                       NULL,
+                                       PAGE_READWRITE,
+                                       (DWORD)( llFileSize >> 32 ),
+                                       (DWORD)llFileSize,
+                                       NULL );
+   if( host_hMapping != NULL )
+   {
+      host_pbView = (UINT8*)MapViewOfFile( host_hMapping, FILE_MAP_ALL_ACCESS, 0, 0, 0 );
+   }
+   if( host_pbView == NULL )
+   {
+      ABCC_PORT_printf( "Could not map %s (error %lu)\n", pacFileName, GetLastError() );
+      HOST_PD_CAPTURE_Close();
+      return( FALSE );
+   }
+
+   host_xViewSize = (SIZE_T)llFileSize;
+   host_iMaxPdSize = iMaxPdSize;
+
+   /*
+   ** A new mapping of an extended file reads as zeroes, so every slot starts
+   ** out empty (llSequence 0).
+   */
+   host_psHeader = (HOST_PD_CAPTURE_FileHeaderType*)host_pbView;
+   host_psHeader->lMagic = HOST_PD_CAPTURE_MAGIC;
+   host_psHeader->iVersion = HOST_PD_CAPTURE_VERSION;
+   host_psHeader->iHeaderSize = HOST_PD_CAPTURE_HEADER_SIZE;
+   host_psHeader->lRecordSize = lRecordSize;
+   host_psHeader->lNumRecords = lNumRecords;
+   host_psHeader->llNextSequence = 1;
+
+   return( TRUE );
+}
+
+void HOST_PD_CAPTURE_Record( UINT8 bDirection, const void* pxData, UINT16 iLength )
+{
+   HOST_PD_CAPTURE_RecordType* psRecord;
+   UINT64                      llSequence;
+
+   if( ( host_psHeader == NULL ) || host_fPaused )
+   {
+      return;
+   }
+
+   if( iLength > host_iMaxPdSize )
+   {
+      iLength = host_iMaxPdSize;
+   }
+
+   llSequence = host_psHeader->llNextSequence;
+   psRecord = (HOST_PD_CAPTURE_RecordType*)( host_pbView +
+                                             HOST_PD_CAPTURE_HEADER_SIZE +
+                                             (SIZE_T)( ( llSequence - 1 ) % host_psHeader->lNumRecords ) *
+                                             host_psHeader->lRecordSize );
+
+   /*
+   ** Invalidate the slot, fill it in, then publish it. The barriers keep
+   ** readers from seeing the new sequence before the new contents.
+   */
+   psRecord->llSequence = 0;
+   MemoryBarrier();
+   psRecord->llTimestampUs = HOST_TIME_GetUs();
+   psRecord->bDirection = bDirection;
+   psRecord->iLength = iLength;
+   memcpy( psRecord + 1, pxData, iLength );
+   MemoryBarrier();
+   psRecord->llSequence = llSequence;
+   host_psHeader->llNextSequence = llSequence + 1;
+}
+
+void HOST_PD_CAPTURE_Pause( BOOL8 fPause )
+{
+   host_fPaused = fPause;
+}
+
+void HOST_PD_CAPTURE_Close( void )
+{
+   if( host_pbView != NULL )
+   {
+      FlushViewOfFile( host_pbView, host_xViewSize );
+      UnmapViewOfFile( host_pbView );
+      host_pbView = NULL;
+   }
+   host_psHeader = NULL;
+
+   if( host_hMapping != NULL )
+   {
+      CloseHandle( host_hMapping );
+      host_hMapping = NULL;
+   }
+   if( host_hFile != INVALID_HANDLE_VALUE )
+   {
+      CloseHandle( host_hFile );
+      host_hFile = INVALID_HANDLE_VALUE;
+   }
+}
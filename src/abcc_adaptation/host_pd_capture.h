@@ -0,0 +1,139 @@
+/*******************************************************************************
+** Copyright 2025-present HMS Industrial Networks AB.
+** Licensed under the MIT License.
+********************************************************************************
+** File Description:
+** Process data capture to a memory-mapped ring file.
+**
+** Every read and write process data image that passes through the hardware
+** abstraction layer is timestamped and copied straight into a file mapping.
+** No file I/O calls are made per image, so the capture keeps up with the full
+** cycle rate. The file stays consistent if the application crashes, since the
+** mapped pages are written back by the operating system.
+**
+** File layout, all fields little endian:
+**    HOST_PD_CAPTURE_FileHeaderType   at offset 0
+**    lNumRecords records of lRecordSize bytes each, at offset lHeaderSize
+**
+** A record is a HOST_PD_CAPTURE_RecordType directly followed by iLength bytes
+** of process data. Record n (counting from 0 since the file was created) is
+** stored in slot n % lNumRecords and has llSequence n + 1.
+**
+** External tools may read the file while it is being written. The writer sets
+** the sequence of a slot to 0 before changing it and to the record number
+** after, then advances llNextSequence in the file header. A reader copies a
+** record and accepts it if its sequence is non-zero and unchanged after the
+** copy.
+********************************************************************************
+*/
+
+#ifndef HOST_PD_CAPTURE_H_
+#define HOST_PD_CAPTURE_H_
+
+#include "abcc_types.h"
+
+/*------------------------------------------------------------------------------
+** File identification, "PDCR" in the first four bytes of the file.
+**------------------------------------------------------------------------------
+*/
+#define HOST_PD_CAPTURE_MAGIC                      ( 0x52434450UL )
+#define HOST_PD_CAPTURE_VERSION                    ( 1 )
+
+/*------------------------------------------------------------------------------
+** Process data direction of a record, as seen from the host.
+**------------------------------------------------------------------------------
+*/
+#define HOST_PD_CAPTURE_READ                       ( 0 )
+#define HOST_PD_CAPTURE_WRITE                      ( 1 )
+
+/*------------------------------------------------------------------------------
+** File header.
+**
+** lMagic          - HOST_PD_CAPTURE_MAGIC.
+** iVersion        - HOST_PD_CAPTURE_VERSION.
+** iHeaderSize     - Offset of the first record slot.
+** lRecordSize     - Size of a record slot, a multiple of 8.
+** lNumRecords     - Number of record slots.
+** llNextSequence  - Sequence number of the next record to be written. The
+**                   newest complete record has llNextSequence - 1.
+**------------------------------------------------------------------------------
+*/
+typedef struct HOST_PD_CAPTURE_FileHeaderType
+{
+   UINT32          lMagic;
+   UINT16          iVersion;
+   UINT16          iHeaderSize;
+   UINT32          lRecordSize;
+   UINT32          lNumRecords;
+   volatile UINT64 llNextSequence;
+}
+HOST_PD_CAPTURE_FileHeaderType;
+
+/*------------------------------------------------------------------------------
+** Record header.
+**
+** llSequence      - Record number + 1, 0 while the slot is being written.
+** llTimestampUs   - HOST_TIME_GetUs() when the image was transferred.
+** bDirection      - HOST_PD_CAPTURE_READ or HOST_PD_CAPTURE_WRITE.
+** iLength         - Number of process data bytes following the header, the
+**                   length of this transfer. The rest of the slot is unused.
+**------------------------------------------------------------------------------
+*/
+typedef struct HOST_PD_CAPTURE_RecordType
+{
+   volatile UINT64 llSequence;
+   UINT64          llTimestampUs;
+   UINT8           bDirection;
+   UINT8           bReserved;
+   UINT16          iLength;
+   UINT32          lReserved;
+}
+HOST_PD_CAPTURE_RecordType;
+
+/*------------------------------------------------------------------------------
+** HOST_PD_CAPTURE_Open()
+** Creates or truncates the capture file and maps it. Capturing starts
+** immediately.
+**------------------------------------------------------------------------------
+** Inputs:
+**    pacFileName   - Name of the capture file.
+**    lNumRecords   - Number of record slots in the ring.
+**    iMaxPdSize    - Largest process data image to capture. Longer images are
+**                    truncated.
+**
+** Outputs:
+**    Returns:      - FALSE if the file could not be created or mapped.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC BOOL HOST_PD_CAPTURE_Open( const char* pacFileName, UINT32 lNumRecords, UINT16 iMaxPdSize );
+
+/*------------------------------------------------------------------------------
+** HOST_PD_CAPTURE_Record()
+** Appends one process data image. Does nothing if no capture file is open.
+** Not reentrant. The HAL calls it with its data lock, sys_sDataLock in
+** abcc_hardware_abstraction.c, held.
+**------------------------------------------------------------------------------
+** Inputs:
+**    bDirection    - HOST_PD_CAPTURE_READ or HOST_PD_CAPTURE_WRITE.
+**    pxData        - Process data image.
+**    iLength       - Size of the image in bytes.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void HOST_PD_CAPTURE_Record( UINT8 bDirection, const void* pxData, UINT16 iLength );
+
+/*------------------------------------------------------------------------------
+** HOST_PD_CAPTURE_Pause()
+** Stops or resumes recording. Images passed while paused are not recorded,
+** which shows as a gap in the record timestamps.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void HOST_PD_CAPTURE_Pause( BOOL8 fPause );
+
+/*------------------------------------------------------------------------------
+** HOST_PD_CAPTURE_Close()
+** Flushes and closes the capture file.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void HOST_PD_CAPTURE_Close( void );
+
+#endif  /* inclusion lock */
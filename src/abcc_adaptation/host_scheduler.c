@@ -0,0 +1,195 @@
+/*******************************************************************************
+** Copyright 2025-present HMS Industrial Networks AB.
+** Licensed under the MIT License.
+********************************************************************************
+** File Description:
+** Multi-rate task scheduler for cyclic application processing.
+********************************************************************************
+*/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "abcc_config.h"
+#include "host_time.h"
+#include "host_scheduler.h"
+#include "host_trace.h"
+
+typedef struct host_TaskType
+{
+   const char*              pacName;
+   HOST_SCHED_TaskFuncType  pnTask;
+   UINT32                   lPeriodUs;
+   UINT8                    bPriority;
+   BOOL8                    fStarted;
+   UINT64                   llNextReleaseUs;
+   HOST_SCHED_TaskStatsType sStats;
+}
+host_TaskType;
+
+static host_TaskType host_asTasks[ HOST_CFG_SCHED_MAX_TASKS ];
+static UINT8         host_bNumTasks;
+
+/*------------------------------------------------------------------------------
+** Task handles in priority order.
+**------------------------------------------------------------------------------
+*/
+static UINT8         host_abRunOrder[ HOST_CFG_SCHED_MAX_TASKS ];
+
+void HOST_SCHED_Init( void )
+{
+   memset( host_asTasks, 0, sizeof( host_asTasks ) );
+   host_bNumTasks = 0;
+}
+
+UINT8 HOST_SCHED_AddTask( const char* pacName,
+                          HOST_SCHED_TaskFuncType pnTask,
+                          UINT32 lPeriodUs,
+                          UINT8 bPriority )
+{
+   host_TaskType* psTask;
+   UINT8          bTask;
+   UINT8          i;
+
+   if( ( host_bNumTasks >= HOST_CFG_SCHED_MAX_TASKS ) ||
+       ( pnTask == NULL ) ||
+       ( lPeriodUs == 0 ) )
+   {
+      return( HOST_SCHED_INVALID_TASK );
+   }
+
+   bTask = host_bNumTasks;
+   psTask = &host_asTasks[ bTask ];
+   psTask->pacName = pacName;
+   psTask->pnTask = pnTask;
+   psTask->lPeriodUs = lPeriodUs;
+   psTask->bPriority = bPriority;
+   psTask->fStarted = FALSE;
+   memset( &psTask->sStats, 0, sizeof( psTask->sStats ) );
+   psTask->sStats.lExecTimeMinUs = 0xFFFFFFFF;
+
+   /*
+   ** Insert into the run order after all tasks of the same or higher
+   ** priority.
+   */
+   i = host_bNumTasks;
+   while( ( i > 0 ) && ( host_asTasks[ host_abRunOrder[ i - 1 ] ].bPriority > bPriority ) )
+   {
+      host_abRunOrder[ i ] = host_abRunOrder[ i - 1 ];
+      i--;
+   }
+   host_abRunOrder[ i ] = bTask;
+   host_bNumTasks++;
+
+   return( bTask );
+}
+
+void HOST_SCHED_Run( UINT64 llNowUs )
+{
+   host_TaskType* psTask;
+   UINT64         llStartUs;
+   UINT64         llEndUs;
+   UINT64         llTraceNs;
+   UINT64         llDeadlineUs;
+   UINT32         lExecUs;
+   UINT32         lDelayUs;
+   UINT32         lSkipped;
+   UINT8          i;
+
+   for( i = 0; i < host_bNumTasks; i++ )
+   {
+      psTask = &host_asTasks[ host_abRunOrder[ i ] ];
+
+      if( !psTask->fStarted )
+      {
+         psTask->llNextReleaseUs = llNowUs;
+         psTask->fStarted = TRUE;
+      }
+
+      if( llNowUs < psTask->llNextReleaseUs )
+      {
+         continue;
+      }
+
+      /*
+      ** Higher priority tasks may have run since llNowUs was sampled.
+      */
+      llTraceNs = HOST_TRACE_Begin();
+      llStartUs = HOST_TIME_GetUs();
+      psTask->pnTask();
+      llEndUs = HOST_TIME_GetUs();
+      HOST_TRACE_End( HOST_TRACE_CAT_APPL, psTask->pacName, llTraceNs, 0 );
+
+      lExecUs = (UINT32)( llEndUs - llStartUs );
+      lDelayUs = (UINT32)( llStartUs - psTask->llNextReleaseUs );
+      llDeadlineUs = psTask->llNextReleaseUs + psTask->lPeriodUs;
+
+      psTask->sStats.lNumRuns++;
+      psTask->sStats.llExecTimeTotalUs += lExecUs;
+      if( lExecUs < psTask->sStats.lExecTimeMinUs )
+      {
+         psTask->sStats.lExecTimeMinUs = lExecUs;
+      }
+      if( lExecUs > psTask->sStats.lExecTimeMaxUs )
+      {
+         psTask->sStats.lExecTimeMaxUs = lExecUs;
+      }
+      if( lDelayUs > psTask->sStats.lMaxStartDelayUs )
+      {
+         psTask->sStats.lMaxStartDelayUs = lDelayUs;
+      }
+
+      /*
+      ** Every period boundary passed before completion is a missed deadline.
+      ** Move the release to the first boundary after completion.
+      */
+      if( llEndUs > llDeadlineUs )
+      {
+         lSkipped = (UINT32)( ( llEndUs - llDeadlineUs ) / psTask->lPeriodUs ) + 1;
+         psTask->sStats.lNumDeadlineMisses += lSkipped;
+         psTask->llNextReleaseUs = llDeadlineUs + (UINT64)lSkipped * psTask->lPeriodUs;
+      }
+      else
+      {
+         psTask->llNextReleaseUs = llDeadlineUs;
+      }
+   }
+}
+
+BOOL HOST_SCHED_GetTaskStats( UINT8 bTask, HOST_SCHED_TaskStatsType* psStats )
+{
+   if( bTask >= host_bNumTasks )
+   {
+      return( FALSE );
+   }
+
+   *psStats = host_asTasks[ bTask ].sStats;
+   return( TRUE );
+}
+
+void HOST_SCHED_PrintStats( void )
+{
+   const host_TaskType* psTask;
+   UINT32               lAvgUs;
+   UINT8                i;
+
+   printf( "Scheduler:\n" );
+   printf( " %-12s %3s %9s %9s %8s %6s %6s %6s %8s\n",
+           "Task", "Pri", "Period", "Runs", "Misses", "Min", "Avg", "Max", "Delay" );
+   for( i = 0; i < host_bNumTasks; i++ )
+   {
+      psTask = &host_asTasks[ host_abRunOrder[ i ] ];
+      lAvgUs = psTask->sStats.lNumRuns ?
+               (UINT32)( psTask->sStats.llExecTimeTotalUs / psTask->sStats.lNumRuns ) : 0;
+      printf( " %-12s %3u %7luus %9lu %8lu %4luus %4luus %4luus %6luus\n",
+              psTask->pacName,
+              psTask->bPriority,
+              (unsigned long)psTask->lPeriodUs,
+              (unsigned long)psTask->sStats.lNumRuns,
+              (unsigned long)psTask->sStats.lNumDeadlineMisses,
+              (unsigned long)( psTask->sStats.lNumRuns ? psTask->sStats.lExecTimeMinUs : 0 ),
+              (unsigned long)lAvgUs,
+              (unsigned long)psTask->sStats.lExecTimeMaxUs,
+              (unsigned long)psTask->sStats.lMaxStartDelayUs );
+   }
+}
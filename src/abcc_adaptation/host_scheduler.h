@@ -0,0 +1,108 @@
+/*******************************************************************************
+** Copyright 2025-present HMS Industrial Networks AB.
+** Licensed under the MIT License.
+********************************************************************************
+** File Description:
+** Multi-rate task scheduler for cyclic application processing.
+**
+** The application registers tasks with their own period and priority and
+** calls HOST_SCHED_Run() on every communication tick, normally from
+** ABCC_API_CbfCyclicalProcessing(). Due tasks are run to completion in
+** priority order in the calling context, so they can access ADI values
+** without locking.
+**
+** A task misses its deadline when it completes after the start of its next
+** period, or when one or more of its periods pass without it being run at
+** all. Missed periods are not caught up, the task keeps its phase.
+********************************************************************************
+*/
+
+#ifndef HOST_SCHEDULER_H_
+#define HOST_SCHEDULER_H_
+
+#include "abcc_types.h"
+
+/*------------------------------------------------------------------------------
+** Returned by HOST_SCHED_AddTask() when the task table is full.
+**------------------------------------------------------------------------------
+*/
+#define HOST_SCHED_INVALID_TASK                    ( 0xFF )
+
+/*------------------------------------------------------------------------------
+** Task function.
+**------------------------------------------------------------------------------
+*/
+typedef void (*HOST_SCHED_TaskFuncType)( void );
+
+/*------------------------------------------------------------------------------
+** Per task statistics.
+**
+** lNumRuns           - Number of times the task has been run.
+** lNumDeadlineMisses - Number of periods in which the task did not complete
+**                      in time, including periods that were skipped.
+** lExecTimeMinUs     - Shortest execution time.
+** lExecTimeMaxUs     - Longest execution time.
+** llExecTimeTotalUs  - Sum of all execution times.
+** lMaxStartDelayUs   - Longest delay from release to start.
+**------------------------------------------------------------------------------
+*/
+typedef struct HOST_SCHED_TaskStatsType
+{
+   UINT32 lNumRuns;
+   UINT32 lNumDeadlineMisses;
+   UINT32 lExecTimeMinUs;
+   UINT32 lExecTimeMaxUs;
+   UINT64 llExecTimeTotalUs;
+   UINT32 lMaxStartDelayUs;
+}
+HOST_SCHED_TaskStatsType;
+
+/*------------------------------------------------------------------------------
+** HOST_SCHED_Init()
+** Removes all tasks.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void HOST_SCHED_Init( void );
+
+/*------------------------------------------------------------------------------
+** HOST_SCHED_AddTask()
+** Registers a periodic task. Its first release is at the first call to
+** HOST_SCHED_Run() after registration.
+**------------------------------------------------------------------------------
+** Inputs:
+**    pacName   - Name used in the statistics printout.
+**    pnTask    - Task function.
+**    lPeriodUs - Period in microseconds.
+**    bPriority - Priority, 0 is the highest. Tasks with equal priority run in
+**                registration order.
+**
+** Outputs:
+**    Returns:    - Task handle, or HOST_SCHED_INVALID_TASK if the task table
+**                  is full.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC UINT8 HOST_SCHED_AddTask( const char* pacName,
+                                  HOST_SCHED_TaskFuncType pnTask,
+                                  UINT32 lPeriodUs,
+                                  UINT8 bPriority );
+
+/*------------------------------------------------------------------------------
+** HOST_SCHED_Run()
+** Runs all tasks that are due, highest priority first.
+**------------------------------------------------------------------------------
+** Inputs:
+**    llNowUs - Current time from HOST_TIME_GetUs().
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void HOST_SCHED_Run( UINT64 llNowUs );
+
+/*------------------------------------------------------------------------------
+** HOST_SCHED_GetTaskStats()
+** HOST_SCHED_PrintStats()
+** Reads the statistics of one task or prints the statistics of all tasks.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC BOOL HOST_SCHED_GetTaskStats( UINT8 bTask, HOST_SCHED_TaskStatsType* psStats );
+EXTFUNC void HOST_SCHED_PrintStats( void );
+
+#endif  /* inclusion lock */
@@ -0,0 +1,260 @@
+/*******************************************************************************
+** Copyright 2025-present HMS Industrial Networks AB.
+** Licensed under the MIT License.
+********************************************************************************
+** File Description:
+** Background receiver for the serial operating mode.
+********************************************************************************
+*/
+
+#include "windows.h"
+#include "process.h"
+#include "stdio.h"
+
+#include "tp.h"
+#include "imp_tp.h"
+#include "abcc_config.h"
+#include "host_time.h"
+#include "host_serial_rx.h"
+#include "host_trace.h"
+#include "host_memory.h"
+
+#if( HOST_CFG_SERIAL_RX_RING_SIZE & ( HOST_CFG_SERIAL_RX_RING_SIZE - 1 ) )
+#error HOST_CFG_SERIAL_RX_RING_SIZE must be a power of two
+#endif
+
+#define HOST_SERIAL_RX_CHUNK_SIZE                  ( 256 )
+
+/*------------------------------------------------------------------------------
+** Ring buffer with one producer, the reader thread, and one consumer, the
+** driver. The indices run freely and are masked on access.
+**------------------------------------------------------------------------------
+*/
+static UINT8           host_abRing[ HOST_CFG_SERIAL_RX_RING_SIZE ];
+static volatile UINT32 host_lHead = 0;
+static volatile UINT32 host_lTail = 0;
+
+static TP_Path         host_xPath = NULL;
+static HOST_LOCK_Type* host_psLock = NULL;
+static HANDLE          host_hThread = NULL;
+static HANDLE          host_hDataEvent = NULL;
+static volatile LONG   host_lStopThread = FALSE;
+static volatile LONG   host_lError = TP_ERR_NONE;
+static BOOL8           host_fStarted = FALSE;
+
+/*
+** host_llNumBytes is written by the reader thread and read by the statistics
+** printout, so it is only accessed with the interlocked functions.
+*/
+static volatile LONG   host_lNumOverruns = 0;
+static volatile LONG64 host_llNumBytes = 0;
+static UINT32          host_lNumFrames = 0;
+static UINT32          host_lNumTimeouts = 0;
+static UINT32          host_lMaxWaitUs = 0;
+
+static void Push( const UINT8* pbData, UINT16 iSize )
+{
+   UINT32 lHead;
+   UINT16 i;
+
+   lHead = host_lHead;
+   for( i = 0; i < iSize; i++ )
+   {
+      if( lHead - host_lTail >= HOST_CFG_SERIAL_RX_RING_SIZE )
+      {
+         /*
+         ** The driver is not collecting its frames. Drop the rest, the frame
+         ** CRC check will reject what is left.
+         */
+         InterlockedExchangeAdd( &host_lNumOverruns, iSize - i );
+         break;
+      }
+      host_abRing[ lHead & ( HOST_CFG_SERIAL_RX_RING_SIZE - 1 ) ] = pbData[ i ];
+      lHead++;
+   }
+
+   MemoryBarrier();
+   host_lHead = lHead;
+   InterlockedExchangeAdd64( &host_llNumBytes, (LONG64)i );
+}
+
+static unsigned __stdcall ReaderThread( void* pxArg )
+{
+   UINT8         abChunk[ HOST_SERIAL_RX_CHUNK_SIZE ];
+   UINT16        iSize;
+   TP_StatusType eStatus;
+   UINT64        llTraceNs;
+   BOOL8         fTimerResolutionSet;
+
+   (void)pxArg;
+
+   /*
+   ** The idle sleep below is only HOST_CFG_SERIAL_RX_POLL_MS long at that
+   ** timer resolution. The thread requests it itself instead of relying on
+   ** the main loop pacing having done so.
+   */
+   fTimerResolutionSet = ( timeBeginPeriod( HOST_CFG_SERIAL_RX_POLL_MS ) == 0 );
+
+   HOST_TRACE_NameThread( "serial rx" );
+   HOST_MEMORY_LockStack( "serial rx stack" );
+   while( !host_lStopThread )
+   {
+      iSize = sizeof( abChunk );
+      HOST_LOCK_Enter( host_psLock );
+      llTraceNs = HOST_TRACE_Begin();
+      eStatus = TP_SerialRead( host_xPath, abChunk, &iSize, 0 );
+      HOST_LOCK_Exit( host_psLock );
+
+      /*
+      ** Only reads that returned data are traced, the idle polls would fill
+      ** the trace buffer.
+      */
+      if( iSize > 0 )
+      {
+         HOST_TRACE_End( HOST_TRACE_CAT_HAL, "TP_SerialRead", llTraceNs, iSize );
+      }
+
+      if( eStatus != TP_ERR_NONE )
+      {
+         InterlockedExchange( &host_lError, (LONG)eStatus );
+         iSize = 0;
+      }
+
+      if( iSize > 0 )
+      {
+         Push( abChunk, iSize );
+         SetEvent( host_hDataEvent );
+      }
+      else
+      {
+         Sleep( HOST_CFG_SERIAL_RX_POLL_MS );
+      }
+   }
+
+   if( fTimerResolutionSet )
+   {
+      timeEndPeriod( HOST_CFG_SERIAL_RX_POLL_MS );
+   }
+
+   _endthreadex( 0 );
+   return( 0 );
+}
+
+BOOL HOST_SERIAL_RX_Start( TP_Path xPath, HOST_LOCK_Type* psLock )
+{
+   HOST_SERIAL_RX_Stop();
+
+   host_xPath = xPath;
+   host_psLock = psLock;
+   host_lHead = 0;
+   host_lTail = 0;
+   host_lError = TP_ERR_NONE;
+   host_lStopThread = FALSE;
+
+   host_hDataEvent = CreateEvent( NULL, FALSE, FALSE, NULL );
+   if( host_hDataEvent == NULL )
+   {
+      return( FALSE );
+   }
+
+   host_hThread = (HANDLE)_beginthreadex( NULL, 0, &ReaderThread, NULL, 0, NULL );
+   if( host_hThread == NULL )
+   {
+      CloseHandle( host_hDataEvent );
+      host_hDataEvent = NULL;
+      return( FALSE );
+   }
+
+   host_fStarted = TRUE;
+   return( TRUE );
+}
+
+void HOST_SERIAL_RX_Stop( void )
+{
+   if( host_hThread != NULL )
+   {
+      InterlockedExchange( &host_lStopThread, TRUE );
+      WaitForSingleObject( host_hThread, INFINITE );
+      CloseHandle( host_hThread );
+      host_hThread = NULL;
+   }
+   if( host_hDataEvent != NULL )
+   {
+      CloseHandle( host_hDataEvent );
+      host_hDataEvent = NULL;
+   }
+}
+
+TP_StatusType HOST_SERIAL_RX_Receive( UINT8* pbData, UINT16 iSize, UINT32 lTimeoutMs, UINT16* piReceived )
+{
+   UINT64 llStartUs;
+   UINT64 llDeadlineUs;
+   UINT64 llNowUs;
+   UINT32 lAvailable;
+   UINT32 lTail;
+   UINT32 lWaitUs;
+   UINT16 i;
+
+   llStartUs = HOST_TIME_GetUs();
+   llDeadlineUs = llStartUs + (UINT64)lTimeoutMs * 1000;
+   llNowUs = llStartUs;
+
+   lAvailable = host_lHead - host_lTail;
+   while( ( lAvailable < iSize ) && ( llNowUs < llDeadlineUs ) && ( host_hDataEvent != NULL ) )
+   {
+      WaitForSingleObject( host_hDataEvent, (DWORD)( ( llDeadlineUs - llNowUs + 999 ) / 1000 ) );
+      llNowUs = HOST_TIME_GetUs();
+      lAvailable = host_lHead - host_lTail;
+   }
+   MemoryBarrier();
+
+   if( lAvailable > iSize )
+   {
+      lAvailable = iSize;
+   }
+   lTail = host_lTail;
+   for( i = 0; i < lAvailable; i++ )
+   {
+      pbData[ i ] = host_abRing[ ( lTail + i ) & ( HOST_CFG_SERIAL_RX_RING_SIZE - 1 ) ];
+   }
+   MemoryBarrier();
+   host_lTail = lTail + lAvailable;
+   *piReceived = (UINT16)lAvailable;
+
+   if( lAvailable == iSize )
+   {
+      host_lNumFrames++;
+      lWaitUs = (UINT32)( llNowUs - llStartUs );
+      if( lWaitUs > host_lMaxWaitUs )
+      {
+         host_lMaxWaitUs = lWaitUs;
+      }
+   }
+   else
+   {
+      host_lNumTimeouts++;
+   }
+
+   return( (TP_StatusType)InterlockedExchange( &host_lError, TP_ERR_NONE ) );
+}
+
+void HOST_SERIAL_RX_Flush( void )
+{
+   host_lTail = host_lHead;
+}
+
+void HOST_SERIAL_RX_PrintStats( void )
+{
+   if( !host_fStarted )
+   {
+      return;
+   }
+
+   printf( "Serial receiver:\n" );
+   printf( " %llu bytes, %lu frames, %lu timeouts, %ld bytes lost to overruns, max frame wait %luus\n",
+           (unsigned long long)InterlockedCompareExchange64( &host_llNumBytes, 0, 0 ),
+           (unsigned long)host_lNumFrames,
+           (unsigned long)host_lNumTimeouts,
+           host_lNumOverruns,
+           (unsigned long)host_lMaxWaitUs );
+}
@@ -0,0 +1,86 @@
+/*******************************************************************************
+** Copyright 2025-present HMS Industrial Networks AB.
+** Licensed under the MIT License.
+********************************************************************************
+** File Description:
+** Background receiver for the serial operating mode.
+**
+** A reader thread drains the serial port into a ring buffer. A send/receive
+** cycle then waits for its response frame on an event instead of blocking in
+** TP_SerialRead() with the HAL lock held, so other HAL users are not locked
+** out for up to the whole frame time.
+**
+** The reader takes the HAL data lock only for each non-blocking
+** TP_SerialRead(), which keeps the data channel calls serialised. A blocking
+** read would hold the lock for its whole timeout. When no data is waiting
+** the reader sleeps HOST_CFG_SERIAL_RX_POLL_MS outside the lock, with the
+** system timer resolution raised to that for as long as it runs.
+**
+** ABCC serial frames have a fixed length for a given configuration, so a
+** frame is complete when the number of bytes the caller asks for has
+** arrived.
+********************************************************************************
+*/
+
+#ifndef HOST_SERIAL_RX_H_
+#define HOST_SERIAL_RX_H_
+
+#include "abcc_types.h"
+#include "tp.h"
+#include "host_lock.h"
+
+/*------------------------------------------------------------------------------
+** HOST_SERIAL_RX_Start()
+** Starts the reader thread on an open serial path.
+**------------------------------------------------------------------------------
+** Inputs:
+**    xPath   - Open serial path.
+**    psLock  - Lock serialising the calls on the path.
+**
+** Outputs:
+**    Returns:  - FALSE if the thread could not be created.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC BOOL HOST_SERIAL_RX_Start( TP_Path xPath, HOST_LOCK_Type* psLock );
+
+/*------------------------------------------------------------------------------
+** HOST_SERIAL_RX_Stop()
+** Stops the reader thread. Call before closing the serial path.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void HOST_SERIAL_RX_Stop( void );
+
+/*------------------------------------------------------------------------------
+** HOST_SERIAL_RX_Receive()
+** Waits for a complete frame and copies it out of the ring buffer. Must not
+** be called with the data lock held.
+**------------------------------------------------------------------------------
+** Inputs:
+**    pbData      - Destination.
+**    iSize       - Frame length.
+**    lTimeoutMs  - Longest time to wait for the frame to complete.
+**
+** Outputs:
+**    piReceived  - Number of bytes copied. Less than iSize on timeout.
+**    Returns:    - Status of a TP_SerialRead() in the reader that failed
+**                  since the previous call, otherwise TP_ERR_NONE.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC TP_StatusType HOST_SERIAL_RX_Receive( UINT8* pbData, UINT16 iSize, UINT32 lTimeoutMs, UINT16* piReceived );
+
+/*------------------------------------------------------------------------------
+** HOST_SERIAL_RX_Flush()
+** Discards everything received so far.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void HOST_SERIAL_RX_Flush( void );
+
+/*------------------------------------------------------------------------------
+** HOST_SERIAL_RX_PrintStats()
+** Prints byte, frame and overrun counters. Prints nothing if the reader has
+** never been started.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void HOST_SERIAL_RX_PrintStats( void );
+
+#endif  /* inclusion lock */
@@ -0,0 +1,76 @@
+/*******************************************************************************
+** Copyright 2025-present HMS Industrial Networks AB.
+** Licensed under the MIT License.
+********************************************************************************
+** File Description:
+** High resolution monotonic time base. Uses QueryPerformanceCounter() on
+** Windows. A clock_gettime() fallback is kept so that the portable benchmark
+** programs can be built on other hosts as well.
+********************************************************************************
+*/
+
+#include "host_time.h"
+
+#if defined( _WIN32 )
+#include "windows.h"
+
+static UINT64 host_llFrequency = 0;
+
+void HOST_TIME_Init( void )
+{
+   LARGE_INTEGER sFrequency;
+
+   if( host_llFrequency == 0 )
+   {
+      QueryPerformanceFrequency( &sFrequency );
+      host_llFrequency = (UINT64)sFrequency.QuadPart;
+   }
+}
+
+static UINT64 ScaleCounter( UINT64 llScale )
+{
+   LARGE_INTEGER sCounter;
+   UINT64        llTicks;
+
+   QueryPerformanceCounter( &sCounter );
+   llTicks = (UINT64)sCounter.QuadPart;
+
+   /*
+   ** Split into whole seconds and remainder to avoid overflowing the 64-bit
+   ** intermediate result for long uptimes.
+   */
+   return( ( llTicks / host_llFrequency ) * llScale +
+           ( ( llTicks % host_llFrequency ) * llScale ) / host_llFrequency );
+}
+
+UINT64 HOST_TIME_GetUs( void )
+{
+   return( ScaleCounter( 1000000 ) );
+}
+
+UINT64 HOST_TIME_GetNs( void )
+{
+   return( ScaleCounter( 1000000000 ) );
+}
+
+#else
+#include <time.h>
+
+void HOST_TIME_Init( void )
+{
+}
+
+UINT64 HOST_TIME_GetNs( void )
+{
+   struct timespec sNow;
+
+   clock_gettime( CLOCK_MONOTONIC, &sNow );
+   return( (UINT64)sNow.tv_sec * 1000000000 + (UINT64)sNow.tv_nsec );
+}
+
+UINT64 HOST_TIME_GetUs( void )
+{
+   return( HOST_TIME_GetNs() / 1000 );
+}
+
+#endif
@@ -0,0 +1,35 @@
+/*******************************************************************************
+** Copyright 2025-present HMS Industrial Networks AB.
+** Licensed under the MIT License.
+********************************************************************************
+** File Description:
+** High resolution monotonic time base for host side measurements (statistics,
+** benchmarks and deadline handling). Not used by the ABCC driver itself, which
+** gets its time base through ABCC_API_RunTimerSystem().
+********************************************************************************
+*/
+
+#ifndef HOST_TIME_H_
+#define HOST_TIME_H_
+
+#include "abcc_types.h"
+
+/*------------------------------------------------------------------------------
+** HOST_TIME_Init()
+** Samples the frequency of the underlying performance counter. Must be called
+** once before any other HOST_TIME_ function. Calling it again is harmless.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void HOST_TIME_Init( void );
+
+/*------------------------------------------------------------------------------
+** HOST_TIME_GetUs()
+** HOST_TIME_GetNs()
+** Returns a monotonic timestamp in microseconds/nanoseconds. The epoch is
+** arbitrary, only differences between two timestamps are meaningful.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC UINT64 HOST_TIME_GetUs( void );
+EXTFUNC UINT64 HOST_TIME_GetNs( void );
+
+#endif  /* inclusion lock */
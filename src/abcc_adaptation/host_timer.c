@@ -0,0 +1,356 @@
+/*******************************************************************************
+** Copyright 2025-present HMS Industrial Networks AB.
+** Licensed under the MIT License.
+********************************************************************************
+** File Description:
+** One-shot and periodic application timers on a hierarchical timer wheel.
+********************************************************************************
+*/
+
+#include <stdio.h>
+#include <string.h>
+#if defined( _MSC_VER )
+#include <intrin.h>
+#endif
+
+#include "host_timer.h"
+
+#define HOST_TIMER_LEVELS                          ( 8 )
+#define HOST_TIMER_SLOT_BITS                       ( 6 )
+#define HOST_TIMER_SLOTS                           ( 1 << HOST_TIMER_SLOT_BITS )
+#define HOST_TIMER_SLOT_MASK                       ( HOST_TIMER_SLOTS - 1 )
+
+/*------------------------------------------------------------------------------
+** bLevel of a timer taken out of its slot and waiting to be run or moved.
+**------------------------------------------------------------------------------
+*/
+#define HOST_TIMER_LEVEL_DETACHED                  ( 0xFF )
+
+static HOST_TIMER_LinkType host_aasSlots[ HOST_TIMER_LEVELS ][ HOST_TIMER_SLOTS ];
+static UINT64              host_allOccupied[ HOST_TIMER_LEVELS ];
+
+/*------------------------------------------------------------------------------
+** Wheel time, counted from HOST_TIMER_Init(), and the HOST_TIME_GetUs() time
+** it started at.
+**------------------------------------------------------------------------------
+*/
+static UINT64              host_llNowUs;
+static UINT64              host_llBaseUs;
+
+static UINT32              host_lNumRunning;
+static UINT32              host_lNumExpired;
+static UINT32              host_lNumSkipped;
+static UINT32              host_lMaxLateUs;
+
+static UINT8 LowestBit( UINT64 llBits )
+{
+#if defined( _MSC_VER )
+   unsigned long lIndex;
+
+   _BitScanForward64( &lIndex, llBits );
+   return( (UINT8)lIndex );
+#else
+   return( (UINT8)__builtin_ctzll( llBits ) );
+#endif
+}
+
+static UINT8 HighestBit( UINT64 llBits )
+{
+#if defined( _MSC_VER )
+   unsigned long lIndex;
+
+   _BitScanReverse64( &lIndex, llBits );
+   return( (UINT8)lIndex );
+#else
+   return( (UINT8)( 63 - __builtin_clzll( llBits ) ) );
+#endif
+}
+
+static void ListInit( HOST_TIMER_LinkType* psHead )
+{
+   psHead->psNext = psHead;
+   psHead->psPrev = psHead;
+}
+
+static void ListAppend( HOST_TIMER_LinkType* psHead, HOST_TIMER_LinkType* psLink )
+{
+   psLink->psPrev = psHead->psPrev;
+   psLink->psNext = psHead;
+   psHead->psPrev->psNext = psLink;
+   psHead->psPrev = psLink;
+}
+
+static void ListRemove( HOST_TIMER_LinkType* psLink )
+{
+   psLink->psPrev->psNext = psLink->psNext;
+   psLink->psNext->psPrev = psLink->psPrev;
+   psLink->psNext = psLink;
+   psLink->psPrev = psLink;
+}
+
+/*------------------------------------------------------------------------------
+** Moves the whole content of a slot to psList and marks the timers as
+** detached.
+**------------------------------------------------------------------------------
+*/
+static void DetachSlot( UINT8 bLevel, UINT8 bSlot, HOST_TIMER_LinkType* psList )
+{
+   HOST_TIMER_LinkType* psHead;
+   HOST_TIMER_LinkType* psLink;
+
+   psHead = &host_aasSlots[ bLevel ][ bSlot ];
+   ListInit( psList );
+   if( psHead->psNext != psHead )
+   {
+      psList->psNext = psHead->psNext;
+      psList->psPrev = psHead->psPrev;
+      psList->psNext->psPrev = psList;
+      psList->psPrev->psNext = psList;
+      ListInit( psHead );
+   }
+   host_allOccupied[ bLevel ] &= ~( 1ULL << bSlot );
+
+   for( psLink = psList->psNext; psLink != psList; psLink = psLink->psNext )
+   {
+      ( (HOST_TIMER_Type*)psLink )->bLevel = HOST_TIMER_LEVEL_DETACHED;
+   }
+}
+
+static void Insert( HOST_TIMER_Type* psTimer )
+{
+   UINT64 llDiff;
+   UINT8  bLevel = 0;
+
+   /*
+   ** A timer that is already due goes into the current slot on level 0 and
+   ** is run by the next advance.
+   */
+   if( psTimer->llExpiresUs < host_llNowUs )
+   {
+      psTimer->llExpiresUs = host_llNowUs;
+   }
+
+   llDiff = psTimer->llExpiresUs ^ host_llNowUs;
+   if( llDiff != 0 )
+   {
+      bLevel = HighestBit( llDiff ) / HOST_TIMER_SLOT_BITS;
+      if( bLevel >= HOST_TIMER_LEVELS )
+      {
+         bLevel = HOST_TIMER_LEVELS - 1;
+      }
+   }
+
+   psTimer->bLevel = bLevel;
+   psTimer->bSlot = (UINT8)( ( psTimer->llExpiresUs >> ( bLevel * HOST_TIMER_SLOT_BITS ) ) & HOST_TIMER_SLOT_MASK );
+   ListAppend( &host_aasSlots[ bLevel ][ psTimer->bSlot ], &psTimer->sLink );
+   host_allOccupied[ bLevel ] |= 1ULL << psTimer->bSlot;
+}
+
+/*------------------------------------------------------------------------------
+** Finds the first occupied slot at or after the current time.
+**------------------------------------------------------------------------------
+** Outputs:
+**    pbLevel     - Level of the slot.
+**    pbSlot      - Slot index.
+**    Returns:    - Wheel time at which the slot is reached, or
+**                  HOST_TIMER_NO_EXPIRY if the wheel is empty.
+**------------------------------------------------------------------------------
+*/
+static UINT64 NextSlot( UINT8* pbLevel, UINT8* pbSlot )
+{
+   UINT64 llCandidates;
+   UINT8  bShift;
+   UINT8  bCurrent;
+   UINT8  bLevel;
+
+   for( bLevel = 0; bLevel < HOST_TIMER_LEVELS; bLevel++ )
+   {
+      bShift = bLevel * HOST_TIMER_SLOT_BITS;
+      bCurrent = (UINT8)( ( host_llNowUs >> bShift ) & HOST_TIMER_SLOT_MASK );
+
+      /*
+      ** Level 0 holds timers that expire in the current slot. On the higher
+      ** levels the current slot is always empty, it has been moved down.
+      */
+      if( bLevel == 0 )
+      {
+         llCandidates = host_allOccupied[ 0 ] & ( ~0ULL << bCurrent );
+      }
+      else
+      {
+         llCandidates = ( bCurrent == HOST_TIMER_SLOT_MASK ) ?
+                        0 : host_allOccupied[ bLevel ] & ( ~0ULL << ( bCurrent + 1 ) );
+      }
+
+      if( llCandidates != 0 )
+      {
+         *pbLevel = bLevel;
+         *pbSlot = LowestBit( llCandidates );
+         return( ( ( host_llNowUs >> ( bShift + HOST_TIMER_SLOT_BITS ) ) << ( bShift + HOST_TIMER_SLOT_BITS ) ) |
+                 ( (UINT64)*pbSlot << bShift ) );
+      }
+   }
+
+   return( HOST_TIMER_NO_EXPIRY );
+}
+
+void HOST_TIMER_Init( UINT64 llNowUs )
+{
+   UINT8 bLevel;
+   UINT8 bSlot;
+
+   for( bLevel = 0; bLevel < HOST_TIMER_LEVELS; bLevel++ )
+   {
+      for( bSlot = 0; bSlot < HOST_TIMER_SLOTS; bSlot++ )
+      {
+         ListInit( &host_aasSlots[ bLevel ][ bSlot ] );
+      }
+   }
+   memset( host_allOccupied, 0, sizeof( host_allOccupied ) );
+
+   host_llNowUs = 0;
+   host_llBaseUs = llNowUs;
+   host_lNumRunning = 0;
+   host_lNumExpired = 0;
+   host_lNumSkipped = 0;
+   host_lMaxLateUs = 0;
+}
+
+void HOST_TIMER_Start( HOST_TIMER_Type* psTimer,
+                       UINT32 lDelayUs,
+                       UINT32 lPeriodUs,
+                       HOST_TIMER_CallbackType pnCallback,
+                       void* pxContext )
+{
+   HOST_TIMER_Stop( psTimer );
+
+   psTimer->llExpiresUs = host_llNowUs + lDelayUs;
+   psTimer->lPeriodUs = lPeriodUs;
+   psTimer->pnCallback = pnCallback;
+   psTimer->pxContext = pxContext;
+   psTimer->fRunning = TRUE;
+   host_lNumRunning++;
+
+   Insert( psTimer );
+}
+
+void HOST_TIMER_Stop( HOST_TIMER_Type* psTimer )
+{
+   HOST_TIMER_LinkType* psHead;
+
+   if( !psTimer->fRunning )
+   {
+      return;
+   }
+
+   ListRemove( &psTimer->sLink );
+   if( psTimer->bLevel != HOST_TIMER_LEVEL_DETACHED )
+   {
+      psHead = &host_aasSlots[ psTimer->bLevel ][ psTimer->bSlot ];
+      if( psHead->psNext == psHead )
+      {
+         host_allOccupied[ psTimer->bLevel ] &= ~( 1ULL << psTimer->bSlot );
+      }
+   }
+
+   psTimer->fRunning = FALSE;
+   host_lNumRunning--;
+}
+
+void HOST_TIMER_Advance( UINT32 lDeltaUs )
+{
+   HOST_TIMER_LinkType sList;
+   HOST_TIMER_Type*    psTimer;
+   UINT64              llTargetUs;
+   UINT64              llSlotUs;
+   UINT64              llMissed;
+   UINT32              lLateUs;
+   UINT8               bLevel;
+   UINT8               bSlot;
+
+   llTargetUs = host_llNowUs + lDeltaUs;
+
+   for( ;; )
+   {
+      llSlotUs = NextSlot( &bLevel, &bSlot );
+      if( llSlotUs > llTargetUs )
+      {
+         break;
+      }
+
+      /*
+      ** Callbacks see the wheel at the expiry time, so that timers they start
+      ** are relative to it and periodic timers keep their phase.
+      */
+      host_llNowUs = llSlotUs;
+      DetachSlot( bLevel, bSlot, &sList );
+
+      /*
+      ** Take the timers one at a time, a callback may stop any of the
+      ** remaining ones.
+      */
+      while( sList.psNext != &sList )
+      {
+         psTimer = (HOST_TIMER_Type*)sList.psNext;
+         ListRemove( &psTimer->sLink );
+
+         if( bLevel > 0 )
+         {
+            Insert( psTimer );
+            continue;
+         }
+
+         lLateUs = (UINT32)( llTargetUs - psTimer->llExpiresUs );
+         if( lLateUs > host_lMaxLateUs )
+         {
+            host_lMaxLateUs = lLateUs;
+         }
+         host_lNumExpired++;
+
+         if( psTimer->lPeriodUs > 0 )
+         {
+            psTimer->llExpiresUs += psTimer->lPeriodUs;
+            if( psTimer->llExpiresUs <= llTargetUs )
+            {
+               llMissed = ( llTargetUs - psTimer->llExpiresUs ) / psTimer->lPeriodUs + 1;
+               psTimer->llExpiresUs += llMissed * psTimer->lPeriodUs;
+               host_lNumSkipped += (UINT32)llMissed;
+            }
+            Insert( psTimer );
+         }
+         else
+         {
+            psTimer->fRunning = FALSE;
+            host_lNumRunning--;
+         }
+
+         psTimer->pnCallback( psTimer->pxContext );
+      }
+   }
+
+   host_llNowUs = llTargetUs;
+}
+
+UINT64 HOST_TIMER_GetNextExpiryUs( void )
+{
+   UINT64 llSlotUs;
+   UINT8  bLevel;
+   UINT8  bSlot;
+
+   llSlotUs = NextSlot( &bLevel, &bSlot );
+   if( llSlotUs == HOST_TIMER_NO_EXPIRY )
+   {
+      return( HOST_TIMER_NO_EXPIRY );
+   }
+   return( host_llBaseUs + llSlotUs );
+}
+
+void HOST_TIMER_PrintStats( void )
+{
+   printf( "Timers:\n" );
+   printf( " %lu running, %lu expired, %lu periods skipped, max callback delay %luus\n",
+           (unsigned long)host_lNumRunning,
+           (unsigned long)host_lNumExpired,
+           (unsigned long)host_lNumSkipped,
+           (unsigned long)host_lMaxLateUs );
+}
@@ -0,0 +1,139 @@
+/*******************************************************************************
+** Copyright 2025-present HMS Industrial Networks AB.
+** Licensed under the MIT License.
+********************************************************************************
+** File Description:
+** One-shot and periodic application timers on a hierarchical timer wheel.
+**
+** The wheel is driven with HOST_TIMER_Advance() from the main loop, with the
+** same time delta that is given to ABCC_API_RunTimerSystem(), and calls the
+** expired timers' callbacks in the main loop context. Timers have microsecond
+** resolution.
+**
+** The wheel has 8 levels of 64 slots. A timer is kept at the level of the
+** highest bit in which its expiry time differs from the current time, so
+** starting and stopping a timer is O(1). An occupancy bitmap per level lets
+** HOST_TIMER_Advance() jump straight to the next occupied slot instead of
+** stepping through every microsecond. When the time reaches a slot on a
+** higher level, its timers are moved down. The wheel covers 2^48 us (about
+** 8.9 years) from HOST_TIMER_Init().
+**
+** HOST_TIMER_GetNextExpiryUs() gives the main loop the time it may sleep
+** until. It can be earlier than the actual expiry, in which case the wake-up
+** only moves timers between levels.
+**
+** A periodic timer keeps its phase. Periods that have passed completely by
+** the time the timer is run are skipped, not caught up.
+********************************************************************************
+*/
+
+#ifndef HOST_TIMER_H_
+#define HOST_TIMER_H_
+
+#include "abcc_types.h"
+
+/*------------------------------------------------------------------------------
+** Returned by HOST_TIMER_GetNextExpiryUs() when no timer is running.
+**------------------------------------------------------------------------------
+*/
+#define HOST_TIMER_NO_EXPIRY                       ( 0xFFFFFFFFFFFFFFFFULL )
+
+/*------------------------------------------------------------------------------
+** Timer callback, called from HOST_TIMER_Advance(). It may start and stop any
+** timer, including its own.
+**------------------------------------------------------------------------------
+*/
+typedef void (*HOST_TIMER_CallbackType)( void* pxContext );
+
+/*------------------------------------------------------------------------------
+** Timer list link.
+**------------------------------------------------------------------------------
+*/
+typedef struct HOST_TIMER_LinkType
+{
+   struct HOST_TIMER_LinkType* psNext;
+   struct HOST_TIMER_LinkType* psPrev;
+}
+HOST_TIMER_LinkType;
+
+/*------------------------------------------------------------------------------
+** Timer. Allocated by the user and owned by the wheel while it runs. The
+** fields are private to host_timer.c.
+**------------------------------------------------------------------------------
+*/
+typedef struct HOST_TIMER_Type
+{
+   HOST_TIMER_LinkType     sLink;
+   UINT64                  llExpiresUs;
+   UINT32                  lPeriodUs;
+   HOST_TIMER_CallbackType pnCallback;
+   void*                   pxContext;
+   UINT8                   bLevel;
+   UINT8                   bSlot;
+   BOOL8                   fRunning;
+}
+HOST_TIMER_Type;
+
+/*------------------------------------------------------------------------------
+** HOST_TIMER_Init()
+** Removes all timers and sets the time of the wheel.
+**------------------------------------------------------------------------------
+** Inputs:
+**    llNowUs - Current time from HOST_TIME_GetUs().
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void HOST_TIMER_Init( UINT64 llNowUs );
+
+/*------------------------------------------------------------------------------
+** HOST_TIMER_Start()
+** Starts a timer, or restarts it if it is running.
+**------------------------------------------------------------------------------
+** Inputs:
+**    psTimer     - Timer.
+**    lDelayUs    - Time to the first expiry.
+**    lPeriodUs   - Time between later expiries, 0 for a one-shot timer.
+**    pnCallback  - Called on expiry.
+**    pxContext   - Passed to pnCallback.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void HOST_TIMER_Start( HOST_TIMER_Type* psTimer,
+                               UINT32 lDelayUs,
+                               UINT32 lPeriodUs,
+                               HOST_TIMER_CallbackType pnCallback,
+                               void* pxContext );
+
+/*------------------------------------------------------------------------------
+** HOST_TIMER_Stop()
+** Stops a timer. Does nothing if it is not running.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void HOST_TIMER_Stop( HOST_TIMER_Type* psTimer );
+
+/*------------------------------------------------------------------------------
+** HOST_TIMER_Advance()
+** Advances the wheel and runs the callbacks of the timers that expire, in
+** expiry order.
+**------------------------------------------------------------------------------
+** Inputs:
+**    lDeltaUs - Time since the previous call.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void HOST_TIMER_Advance( UINT32 lDeltaUs );
+
+/*------------------------------------------------------------------------------
+** HOST_TIMER_GetNextExpiryUs()
+** Returns the HOST_TIME_GetUs() time at which the wheel needs to be advanced
+** next, or HOST_TIMER_NO_EXPIRY if no timer is running.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC UINT64 HOST_TIMER_GetNextExpiryUs( void );
+
+/*------------------------------------------------------------------------------
+** HOST_TIMER_PrintStats()
+** Prints the number of running timers, expiries, skipped periods and the
+** largest delay between expiry and callback.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void HOST_TIMER_PrintStats( void );
+
+#endif  /* inclusion lock */
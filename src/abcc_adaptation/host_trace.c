@@ -0,0 +1,245 @@
+/*******************************************************************************
+** Copyright 2025-present HMS Industrial Networks AB.
+** Licensed under the MIT License.
+********************************************************************************
+** File Description:
+** Timeline trace of driver, HAL and application activity.
+********************************************************************************
+*/
+
+#include "windows.h"
+#include "stdio.h"
+#include "string.h"
+
+#include "host_time.h"
+#include "host_trace.h"
+
+#if( HOST_CFG_TRACE_ENABLED )
+
+#if( HOST_CFG_TRACE_BUFFER_EVENTS & ( HOST_CFG_TRACE_BUFFER_EVENTS - 1 ) )
+#error HOST_CFG_TRACE_BUFFER_EVENTS must be a power of two
+#endif
+
+#define HOST_TRACE_MAX_THREADS                     ( 16 )
+
+#define HOST_TRACE_TYPE_COMPLETE                   ( 0 )
+#define HOST_TRACE_TYPE_INSTANT                    ( 1 )
+
+/*------------------------------------------------------------------------------
+** One buffered event. lSeq is written last, as the event's index plus one,
+** so that the dump can tell a finished event from one that is still being
+** written or has been overwritten.
+**------------------------------------------------------------------------------
+*/
+typedef struct host_EventType
+{
+   UINT64          llStartNs;
+   const char*     pacName;
+   UINT32          lDurationNs;
+   UINT32          lThreadId;
+   UINT32          lArg;
+   volatile LONG   lSeq;
+   UINT8           bCategory;
+   UINT8           bType;
+}
+host_EventType;
+
+typedef struct host_ThreadNameType
+{
+   UINT32      lThreadId;
+   const char* pacName;
+}
+host_ThreadNameType;
+
+static const char* const host_apacCategories[] =
+{
+   "api", "state", "hal", "lock", "appl", "host"
+};
+
+static host_EventType      host_asEvents[ HOST_CFG_TRACE_BUFFER_EVENTS ];
+static volatile LONG       host_lNext = 0;
+static volatile LONG       host_lRecording = FALSE;
+static BOOL8               host_fStarted = FALSE;
+static UINT64              host_llBaseNs = 0;
+
+static host_ThreadNameType host_asThreads[ HOST_TRACE_MAX_THREADS ];
+static volatile LONG       host_lNumThreads = 0;
+
+static UINT32              host_lNumDumps = 0;
+
+static void Record( UINT8 bType, UINT8 bCategory, const char* pacName, UINT64 llStartNs, UINT64 llEndNs, UINT32 lArg )
+{
+   host_EventType* psEvent;
+   LONG            lIndex;
+
+   lIndex = InterlockedIncrement( &host_lNext ) - 1;
+   psEvent = &host_asEvents[ (UINT32)lIndex & ( HOST_CFG_TRACE_BUFFER_EVENTS - 1 ) ];
+
+   psEvent->lSeq = 0;
+   MemoryBarrier();
+   psEvent->pacName = pacName;
+   psEvent->llStartNs = llStartNs - host_llBaseNs;
+   psEvent->lDurationNs = (UINT32)( llEndNs - llStartNs );
+   psEvent->lThreadId = GetCurrentThreadId();
+   psEvent->lArg = lArg;
+   psEvent->bCategory = bCategory;
+   psEvent->bType = bType;
+   MemoryBarrier();
+   psEvent->lSeq = lIndex + 1;
+}
+
+void HOST_TRACE_Start( void )
+{
+   InterlockedExchange( &host_lRecording, FALSE );
+   memset( host_asEvents, 0, sizeof( host_asEvents ) );
+   host_lNext = 0;
+   host_llBaseNs = HOST_TIME_GetNs();
+   host_fStarted = TRUE;
+   InterlockedExchange( &host_lRecording, TRUE );
+}
+
+void HOST_TRACE_NameThread( const char* pacName )
+{
+   LONG lIndex;
+
+   lIndex = InterlockedIncrement( &host_lNumThreads ) - 1;
+   if( lIndex >= HOST_TRACE_MAX_THREADS )
+   {
+      InterlockedDecrement( &host_lNumThreads );
+      return;
+   }
+   host_asThreads[ lIndex ].lThreadId = GetCurrentThreadId();
+   host_asThreads[ lIndex ].pacName = pacName;
+}
+
+UINT64 HOST_TRACE_Begin( void )
+{
+   if( !host_lRecording )
+   {
+      return( 0 );
+   }
+   return( HOST_TIME_GetNs() );
+}
+
+void HOST_TRACE_End( UINT8 bCategory, const char* pacName, UINT64 llStartNs, UINT32 lArg )
+{
+   if( ( llStartNs == 0 ) || !host_lRecording )
+   {
+      return;
+   }
+   Record( HOST_TRACE_TYPE_COMPLETE, bCategory, pacName, llStartNs, HOST_TIME_GetNs(), lArg );
+}
+
+void HOST_TRACE_Instant( UINT8 bCategory, const char* pacName, UINT32 lArg )
+{
+   UINT64 llNowNs;
+
+   if( !host_lRecording )
+   {
+      return;
+   }
+   llNowNs = HOST_TIME_GetNs();
+   Record( HOST_TRACE_TYPE_INSTANT, bCategory, pacName, llNowNs, llNowNs, lArg );
+}
+
+BOOL HOST_TRACE_Dump( const char* pacFile )
+{
+   const host_EventType* psEvent;
+   FILE*                 psFile;
+   UINT32                lNext;
+   UINT32                lCount;
+   UINT32                lIndex;
+   UINT32                lPid;
+   LONG                  i;
+
+   if( !host_fStarted )
+   {
+      return( FALSE );
+   }
+
+   psFile = fopen( pacFile, "w" );
+   if( psFile == NULL )
+   {
+      printf( "Could not create trace file %s\n", pacFile );
+      return( FALSE );
+   }
+
+   /*
+   ** Pause recording so that the ring is not overwritten while it is read.
+   ** A trace point that was already past its flag test still completes, its
+   ** event is skipped if lSeq shows it unfinished.
+   */
+   InterlockedExchange( &host_lRecording, FALSE );
+   lNext = (UINT32)host_lNext;
+   lCount = ( lNext > HOST_CFG_TRACE_BUFFER_EVENTS ) ? HOST_CFG_TRACE_BUFFER_EVENTS : lNext;
+   lPid = GetCurrentProcessId();
+
+   fprintf( psFile, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n" );
+   fprintf( psFile, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%lu,\"args\":{\"name\":\"abcc host\"}}",
+            (unsigned long)lPid );
+   for( i = 0; i < host_lNumThreads; i++ )
+   {
+      fprintf( psFile, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%lu,\"tid\":%lu,\"args\":{\"name\":\"%s\"}}",
+               (unsigned long)lPid,
+               (unsigned long)host_asThreads[ i ].lThreadId,
+               host_asThreads[ i ].pacName );
+   }
+
+   for( lIndex = lNext - lCount; lIndex != lNext; lIndex++ )
+   {
+      psEvent = &host_asEvents[ lIndex & ( HOST_CFG_TRACE_BUFFER_EVENTS - 1 ) ];
+      if( psEvent->lSeq != (LONG)( lIndex + 1 ) )
+      {
+         continue;
+      }
+
+      /*
+      ** Timestamps are in microseconds with nanosecond decimals.
+      */
+      fprintf( psFile, ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"pid\":%lu,\"tid\":%lu,\"ts\":%llu.%03u,",
+               psEvent->pacName,
+               host_apacCategories[ psEvent->bCategory ],
+               (unsigned long)lPid,
+               (unsigned long)psEvent->lThreadId,
+               (unsigned long long)( psEvent->llStartNs / 1000 ),
+               (unsigned)( psEvent->llStartNs % 1000 ) );
+      if( psEvent->bType == HOST_TRACE_TYPE_COMPLETE )
+      {
+         fprintf( psFile, "\"ph\":\"X\",\"dur\":%lu.%03u,",
+                  (unsigned long)( psEvent->lDurationNs / 1000 ),
+                  (unsigned)( psEvent->lDurationNs % 1000 ) );
+      }
+      else
+      {
+         fprintf( psFile, "\"ph\":\"i\",\"s\":\"t\"," );
+      }
+      fprintf( psFile, "\"args\":{\"arg\":%lu}}", (unsigned long)psEvent->lArg );
+   }
+   fprintf( psFile, "\n]}\n" );
+   fclose( psFile );
+
+   host_lNumDumps++;
+   printf( "Trace with %lu events written to %s\n", (unsigned long)lCount, pacFile );
+
+   InterlockedExchange( &host_lRecording, TRUE );
+   return( TRUE );
+}
+
+void HOST_TRACE_PrintStats( void )
+{
+   UINT32 lNext;
+
+   if( !host_fStarted )
+   {
+      return;
+   }
+
+   lNext = (UINT32)host_lNext;
+   printf( "Trace:\n" );
+   printf( " %lu events recorded, %lu overwritten, %lu dumps\n",
+           (unsigned long)lNext,
+           (unsigned long)( ( lNext > HOST_CFG_TRACE_BUFFER_EVENTS ) ? lNext - HOST_CFG_TRACE_BUFFER_EVENTS : 0 ),
+           (unsigned long)host_lNumDumps );
+}
+
+#endif
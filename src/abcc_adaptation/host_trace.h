@@ -0,0 +1,117 @@
+/*******************************************************************************
+** Copyright 2025-present HMS Industrial Networks AB.
+** Licensed under the MIT License.
+********************************************************************************
+** File Description:
+** Timeline trace of driver, HAL and application activity.
+**
+** Trace points record events into an in-memory ring buffer: ABCC_API_Run()
+** passes, ANB state changes, Transport Provider calls, lock waits and
+** application callbacks. HOST_TRACE_Dump() writes the buffer in the Chrome
+** trace event JSON format, which chrome://tracing and ui.perfetto.dev open
+** directly.
+**
+** Recording costs two HOST_TIME_GetNs() calls and one interlocked increment
+** per event. Until HOST_TRACE_Start() is called, or with
+** HOST_CFG_TRACE_ENABLED set to 0, a trace point is a single flag test or
+** nothing at all.
+**
+** Events from any thread go into the same buffer. Each thread that records
+** events should name itself with HOST_TRACE_NameThread() so that its track
+** is labelled in the viewer.
+********************************************************************************
+*/
+
+#ifndef HOST_TRACE_H_
+#define HOST_TRACE_H_
+
+#include "abcc_types.h"
+#include "abcc_config.h"
+
+/*------------------------------------------------------------------------------
+** Event categories, shown as "cat" in the viewer.
+**------------------------------------------------------------------------------
+*/
+#define HOST_TRACE_CAT_API                         ( 0 )
+#define HOST_TRACE_CAT_STATE                       ( 1 )
+#define HOST_TRACE_CAT_HAL                         ( 2 )
+#define HOST_TRACE_CAT_LOCK                        ( 3 )
+#define HOST_TRACE_CAT_APPL                        ( 4 )
+#define HOST_TRACE_CAT_HOST                        ( 5 )
+
+#if( HOST_CFG_TRACE_ENABLED )
+
+/*------------------------------------------------------------------------------
+** HOST_TRACE_Start()
+** Empties the buffer and starts recording. HOST_TIME_Init() must have been
+** called.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void HOST_TRACE_Start( void );
+
+/*------------------------------------------------------------------------------
+** HOST_TRACE_NameThread()
+** Names the calling thread's track in the dump.
+**------------------------------------------------------------------------------
+** Inputs:
+**    pacName - Thread name. Must stay valid, only the pointer is kept.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void HOST_TRACE_NameThread( const char* pacName );
+
+/*------------------------------------------------------------------------------
+** HOST_TRACE_Begin()
+** HOST_TRACE_End()
+** Record one complete event that spans from HOST_TRACE_Begin() to
+** HOST_TRACE_End(). Begin returns 0 when not recording, and End ignores a
+** start time of 0, so an event is never left half recorded.
+**------------------------------------------------------------------------------
+** Inputs:
+**    bCategory   - One of the HOST_TRACE_CAT_ values.
+**    pacName     - Event name. Must stay valid, only the pointer is kept.
+**    llStartNs   - Value returned by HOST_TRACE_Begin().
+**    lArg        - Shown as the event's argument, e.g. a transfer length.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC UINT64 HOST_TRACE_Begin( void );
+EXTFUNC void HOST_TRACE_End( UINT8 bCategory, const char* pacName, UINT64 llStartNs, UINT32 lArg );
+
+/*------------------------------------------------------------------------------
+** HOST_TRACE_Instant()
+** Records an event without duration, e.g. a state change.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void HOST_TRACE_Instant( UINT8 bCategory, const char* pacName, UINT32 lArg );
+
+/*------------------------------------------------------------------------------
+** HOST_TRACE_Dump()
+** Writes the buffered events to a Chrome trace JSON file. Recording is
+** paused while the file is written. Call from the main loop.
+**------------------------------------------------------------------------------
+** Outputs:
+**    Returns:    - FALSE if the file could not be written, or recording has
+**                  not been started.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC BOOL HOST_TRACE_Dump( const char* pacFile );
+
+/*------------------------------------------------------------------------------
+** HOST_TRACE_PrintStats()
+** Prints the number of recorded and overwritten events.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void HOST_TRACE_PrintStats( void );
+
+#else
+
+#define HOST_TRACE_Start()
+#define HOST_TRACE_NameThread( pacName )
+#define HOST_TRACE_Begin()                                        ( 0 )
+#define HOST_TRACE_End( bCategory, pacName, llStartNs, lArg )     ( (void)( llStartNs ) )
+#define HOST_TRACE_Instant( bCategory, pacName, lArg )
+#define HOST_TRACE_Dump( pacFile )                                ( FALSE )
+#define HOST_TRACE_PrintStats()
+
+#endif
+
+#endif  /* inclusion lock */
@@ -0,0 +1,200 @@
+/*******************************************************************************
+** Copyright 2025-present HMS Industrial Networks AB.
+** Licensed under the MIT License.
+********************************************************************************
+** File Description:
+** Deadline based cycle pacing for the main loop.
+********************************************************************************
+*/
+
+#include "windows.h"
+#include "stdio.h"
+#include "string.h"
+
+#include "host_time.h"
+#include "host_wait.h"
+
+/*------------------------------------------------------------------------------
+** Requested system timer resolution in milliseconds. With it Sleep( n )
+** returns after n to n + 1 ms instead of up to a full 15.6 ms quantum later.
+**------------------------------------------------------------------------------
+*/
+#define HOST_WAIT_TIMER_RESOLUTION_MS              ( 1 )
+
+static HOST_WAIT_StatsType host_sStats;
+static UINT64              host_llDeadlineUs;
+static UINT64              host_llStartUs;
+static UINT64              host_llStartCpuUs;
+static BOOL8               host_fTimerResolutionSet = FALSE;
+
+static UINT64 ProcessCpuUs( void )
+{
+   FILETIME sCreation;
+   FILETIME sExit;
+   FILETIME sKernel;
+   FILETIME sUser;
+
+   if( !GetProcessTimes( GetCurrentProcess(), &sCreation, &sExit, &sKernel, &sUser ) )
+   {
+      return( 0 );
+   }
+
+   /*
+   ** FILETIME counts 100 ns units.
+   */
+   return( ( ( ( (UINT64)sKernel.dwHighDateTime << 32 ) | sKernel.dwLowDateTime ) +
+             ( ( (UINT64)sUser.dwHighDateTime << 32 ) | sUser.dwLowDateTime ) ) / 10 );
+}
+
+void HOST_WAIT_Init( UINT32 lPeriodUs, UINT32 lSpinUs )
+{
+   if( !host_fTimerResolutionSet )
+   {
+      host_fTimerResolutionSet = ( timeBeginPeriod( HOST_WAIT_TIMER_RESOLUTION_MS ) == 0 );
+   }
+
+   memset( &host_sStats, 0, sizeof( host_sStats ) );
+   host_sStats.lPeriodUs = lPeriodUs;
+   host_sStats.lSpinUs = lSpinUs;
+
+   host_llStartUs = HOST_TIME_GetUs();
+   host_llStartCpuUs = ProcessCpuUs();
+   host_llDeadlineUs = host_llStartUs + lPeriodUs;
+}
+
+BOOL HOST_WAIT_Until( UINT64 llWakeUpUs )
+{
+   UINT64 llNowUs;
+   UINT64 llTargetUs;
+   UINT64 llPhaseStartUs;
+   UINT64 llRemainingUs;
+   UINT64 llSleepMs;
+   UINT32 lLateUs;
+
+   llNowUs = HOST_TIME_GetUs();
+
+   if( llNowUs >= host_llDeadlineUs )
+   {
+      host_sStats.lNumCycles++;
+      host_sStats.lNumOverruns++;
+      host_llDeadlineUs = llNowUs + host_sStats.lPeriodUs;
+      return( TRUE );
+   }
+
+   llTargetUs = ( llWakeUpUs < host_llDeadlineUs ) ? llWakeUpUs : host_llDeadlineUs;
+   if( llNowUs >= llTargetUs )
+   {
+      host_sStats.lNumEarlyWakeUps++;
+      return( FALSE );
+   }
+
+   /*
+   ** Sleep in whole milliseconds as long as at least one millisecond is left
+   ** above the spin margin. Without a spin margin the sleep is rounded up
+   ** instead, so that the wait ends at or after the target without spinning.
+   ** A wake-up before the deadline is never rounded up past the deadline,
+   ** what is left of it is spun.
+   */
+   llPhaseStartUs = llNowUs;
+   llRemainingUs = llTargetUs - llNowUs;
+   while( ( llRemainingUs >= (UINT64)host_sStats.lSpinUs + 1000 ) ||
+          ( ( host_sStats.lSpinUs == 0 ) && ( llRemainingUs > 0 ) ) )
+   {
+      if( host_sStats.lSpinUs == 0 )
+      {
+         llSleepMs = ( llRemainingUs + 999 ) / 1000;
+         if( ( llTargetUs < host_llDeadlineUs ) &&
+             ( llNowUs + llSleepMs * 1000 > host_llDeadlineUs ) )
+         {
+            llSleepMs = ( host_llDeadlineUs - llNowUs ) / 1000;
+            if( llSleepMs == 0 )
+            {
+               break;
+            }
+         }
+      }
+      else
+      {
+         llSleepMs = ( llRemainingUs - host_sStats.lSpinUs ) / 1000;
+      }
+      Sleep( (DWORD)llSleepMs );
+      llNowUs = HOST_TIME_GetUs();
+      llRemainingUs = ( llNowUs < llTargetUs ) ? llTargetUs - llNowUs : 0;
+   }
+   host_sStats.llSleepUs += llNowUs - llPhaseStartUs;
+
+   /*
+   ** Spin for the rest.
+   */
+   llPhaseStartUs = llNowUs;
+   while( llNowUs < llTargetUs )
+   {
+      YieldProcessor();
+      llNowUs = HOST_TIME_GetUs();
+   }
+   host_sStats.llSpinUs += llNowUs - llPhaseStartUs;
+
+   /*
+   ** A wait for a wake-up time that ended at or after the deadline, e.g.
+   ** late out of Sleep(), completes the cycle as if it had waited for the
+   ** deadline. Otherwise the next call would count it as an overrun.
+   */
+   if( ( llTargetUs < host_llDeadlineUs ) && ( llNowUs < host_llDeadlineUs ) )
+   {
+      host_sStats.lNumEarlyWakeUps++;
+      return( FALSE );
+   }
+
+   lLateUs = (UINT32)( llNowUs - host_llDeadlineUs );
+   if( lLateUs > host_sStats.lMaxWakeLateUs )
+   {
+      host_sStats.lMaxWakeLateUs = lLateUs;
+   }
+
+   host_sStats.lNumCycles++;
+   host_llDeadlineUs += host_sStats.lPeriodUs;
+   return( TRUE );
+}
+
+void HOST_WAIT_UntilNextCycle( void )
+{
+   HOST_WAIT_Until( HOST_WAIT_NO_WAKE_UP );
+}
+
+void HOST_WAIT_GetStats( HOST_WAIT_StatsType* psStats )
+{
+   *psStats = host_sStats;
+   psStats->llElapsedUs = HOST_TIME_GetUs() - host_llStartUs;
+   psStats->llCpuUs = ProcessCpuUs() - host_llStartCpuUs;
+}
+
+void HOST_WAIT_PrintStats( void )
+{
+   HOST_WAIT_StatsType sStats;
+   double              dElapsed;
+
+   HOST_WAIT_GetStats( &sStats );
+   dElapsed = sStats.llElapsedUs ? (double)sStats.llElapsedUs : 1.0;
+
+   printf( "Cycle wait:\n" );
+   printf( " Period %luus, spin margin %luus, %lu cycles, %lu overruns, %lu early wake-ups, max wake delay %luus\n",
+           (unsigned long)sStats.lPeriodUs,
+           (unsigned long)sStats.lSpinUs,
+           (unsigned long)sStats.lNumCycles,
+           (unsigned long)sStats.lNumOverruns,
+           (unsigned long)sStats.lNumEarlyWakeUps,
+           (unsigned long)sStats.lMaxWakeLateUs );
+   printf( " Sleeping %.1f%%, spinning %.1f%%, process CPU %.1f%%\n",
+           100.0 * (double)sStats.llSleepUs / dElapsed,
+           100.0 * (double)sStats.llSpinUs / dElapsed,
+           100.0 * (double)sStats.llCpuUs / dElapsed );
+}
+
+void HOST_WAIT_Close( void )
+{
+   if( host_fTimerResolutionSet )
+   {
+      timeEndPeriod( HOST_WAIT_TIMER_RESOLUTION_MS );
+      host_fTimerResolutionSet = FALSE;
+   }
+}
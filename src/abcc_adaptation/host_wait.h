@@ -0,0 +1,121 @@
+/*******************************************************************************
+** Copyright 2025-present HMS Industrial Networks AB.
+** Licensed under the MIT License.
+********************************************************************************
+** File Description:
+** Deadline based cycle pacing for the main loop.
+**
+** A plain Sleep() oversleeps by up to a scheduler quantum, which makes short
+** cycle periods impossible and adds jitter to longer ones. Here the main loop
+** runs on absolute deadlines, one period apart. Each wait sleeps until a spin
+** margin before the deadline and then busy-waits for the rest. A larger spin
+** margin gives tighter timing at the cost of CPU time, and the statistics
+** show both sides of that trade-off.
+**
+** An overrun cycle, one that ends after its deadline, is counted. The next
+** cycle then starts immediately with a new deadline one period later.
+**
+** HOST_WAIT_Until() can also return before the deadline, when something
+** else such as an application timer is due. The deadline is then kept.
+********************************************************************************
+*/
+
+#ifndef HOST_WAIT_H_
+#define HOST_WAIT_H_
+
+#include "abcc_types.h"
+
+/*------------------------------------------------------------------------------
+** Wake-up time for HOST_WAIT_Until() that only waits for the deadline.
+**------------------------------------------------------------------------------
+*/
+#define HOST_WAIT_NO_WAKE_UP                       ( 0xFFFFFFFFFFFFFFFFULL )
+
+/*------------------------------------------------------------------------------
+** Wait statistics since HOST_WAIT_Init().
+**
+** lPeriodUs        - Configured cycle period.
+** lSpinUs          - Configured spin margin.
+** lNumCycles       - Number of completed cycles.
+** lNumOverruns     - Cycles that ended after their deadline.
+** lNumEarlyWakeUps - Waits that returned early for a wake-up time.
+** lMaxWakeLateUs   - Largest delay from deadline to the end of a wait.
+** llSleepUs        - Total time spent sleeping.
+** llSpinUs         - Total time spent spinning.
+** llElapsedUs      - Wall time since HOST_WAIT_Init().
+** llCpuUs          - Process CPU time (user + kernel) since HOST_WAIT_Init().
+**------------------------------------------------------------------------------
+*/
+typedef struct HOST_WAIT_StatsType
+{
+   UINT32 lPeriodUs;
+   UINT32 lSpinUs;
+   UINT32 lNumCycles;
+   UINT32 lNumOverruns;
+   UINT32 lNumEarlyWakeUps;
+   UINT32 lMaxWakeLateUs;
+   UINT64 llSleepUs;
+   UINT64 llSpinUs;
+   UINT64 llElapsedUs;
+   UINT64 llCpuUs;
+}
+HOST_WAIT_StatsType;
+
+/*------------------------------------------------------------------------------
+** HOST_WAIT_Init()
+** Raises the system timer resolution and sets the first deadline one period
+** from now.
+**------------------------------------------------------------------------------
+** Inputs:
+**    lPeriodUs - Cycle period in microseconds.
+**    lSpinUs   - Time before each deadline spent spinning instead of
+**                sleeping. A sleep can return up to one timer tick (about
+**                1 ms) late, so a margin below that risks late wake-ups. 0
+**                only sleeps and accepts those, a value of at least
+**                lPeriodUs only spins.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void HOST_WAIT_Init( UINT32 lPeriodUs, UINT32 lSpinUs );
+
+/*------------------------------------------------------------------------------
+** HOST_WAIT_UntilNextCycle()
+** Waits for the current deadline and advances it by one period. Returns
+** immediately if the deadline has already passed.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void HOST_WAIT_UntilNextCycle( void );
+
+/*------------------------------------------------------------------------------
+** HOST_WAIT_Until()
+** Waits for the current deadline or for llWakeUpUs, whichever comes first.
+**------------------------------------------------------------------------------
+** Inputs:
+**    llWakeUpUs  - HOST_TIME_GetUs() time to return at if it is before the
+**                  deadline, or HOST_WAIT_NO_WAKE_UP.
+**
+** Outputs:
+**    Returns:    - TRUE if the deadline was reached, and advanced by one
+**                  period. This includes a wait for llWakeUpUs that ends at
+**                  or after the deadline. FALSE if the wait ended at
+**                  llWakeUpUs, before the deadline.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC BOOL HOST_WAIT_Until( UINT64 llWakeUpUs );
+
+/*------------------------------------------------------------------------------
+** HOST_WAIT_GetStats()
+** HOST_WAIT_PrintStats()
+** Reads or prints the wait statistics.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void HOST_WAIT_GetStats( HOST_WAIT_StatsType* psStats );
+EXTFUNC void HOST_WAIT_PrintStats( void );
+
+/*------------------------------------------------------------------------------
+** HOST_WAIT_Close()
+** Restores the system timer resolution.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void HOST_WAIT_Close( void );
+
+#endif  /* inclusion lock */
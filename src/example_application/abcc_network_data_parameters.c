@@ -3,9 +3,13 @@
 ** Licensed under the MIT License.
 ********************************************************************************
 ** File Description:
-** Example of an ADI setup with two simple UINT16 ADIs representing speed and
-** reference speed of a motor. Both are mapped as cyclical process data
-** parameters.
+** Example of an ADI setup with UINT16 array ADIs representing speed,
+** reference speed and speed limits of APPL_CFG_NUM_AXES motor axes. Speed and
+** reference speed are mapped as cyclical process data parameters, the limits
+** are acyclic parameters.
+**
+** With APPL_CFG_HOST_PERF_ADIS_ENABLED the host's own performance figures are
+** added as ADIs 0x100-0x105, see APPL_HostPerfType.
 **
 ** Make sure that the following definitions, if they exist in
 ** abcc_driver_config.h, are set to the following:
@@ -15,17 +19,49 @@
 */
 
 #include "abcc_api.h"
+#include "host_scheduler.h"
+#include "host_time.h"
+#include "host_jitter.h"
+#include "host_image.h"
+#include "host_trace.h"
+#include "host_budget.h"
+#include "abcc_network_data_parameters.h"
+#include "appl_adi_table.h"
+#include "appl_axis_engine.h"
 
 #if (  ABCC_CFG_STRUCT_DATA_TYPE_ENABLED || ABCC_CFG_ADI_GET_SET_CALLBACK_ENABLED )
    #error ABCC_CFG_ADI_GET_SET_CALLBACK_ENABLED must be set to 0 and ABCC_CFG_STRUCT_DATA_TYPE_ENABLED set to 0 in order to run this example
 #endif
 
+#if( ( APPL_CFG_NUM_AXES < 1 ) || ( APPL_CFG_NUM_AXES > 255 ) )
+   #error APPL_CFG_NUM_AXES must be 1-255, the number of elements of an ADI is an 8-bit value
+#endif
+
+/*------------------------------------------------------------------------------
+** Data holder for the network data parameters (ADI). One array per quantity,
+** indexed by axis.
+**------------------------------------------------------------------------------
+*/
+uint16_t appl_aiSpeed[ APPL_CFG_NUM_AXES ];
+uint16_t appl_aiRefSpeed[ APPL_CFG_NUM_AXES ];
+uint16_t appl_aiMinSpeed[ APPL_CFG_NUM_AXES ];
+uint16_t appl_aiMaxSpeed[ APPL_CFG_NUM_AXES ];
+
+static const APPL_AXIS_EngineType appl_sAxisEngine =
+{
+   appl_aiSpeed,
+   appl_aiRefSpeed,
+   appl_aiMinSpeed,
+   appl_aiMaxSpeed,
+   APPL_CFG_NUM_AXES,
+   APPL_CFG_MOTOR_RAMP_STEP
+};
+
 /*------------------------------------------------------------------------------
-** Data holder for the network data parameters (ADI)
+** Interval between consecutive process data updates.
 **------------------------------------------------------------------------------
 */
-uint16_t appl_iSpeed;
-uint16_t appl_iRefSpeed;
+static HOST_JITTER_Type appl_sPdJitter;
 
 /*------------------------------------------------------------------------------
 ** Min, max and default value for appl_aiUint16
@@ -33,66 +69,141 @@ uint16_t appl_iRefSpeed;
 */
 static AD_UINT16Type appl_sUint16Prop = { { 0, 0xFFFF, 0 } };
 
-/*-------------------------------------------------------------------------------------------------------------
-** 1. iInstance | 2. pabName | 3. bDataType | 4. bNumOfElements | 5. bDesc | 6. pxValuePtr | 7. pxValuePropPtr
-**--------------------------------------------------------------------------------------------------------------
-*/
-const AD_AdiEntryType ABCC_API_asAdiEntryList[] =
-{
-   {  0x1,  "SPEED",     ABP_UINT16,   1, AD_ADI_DESC___W_G, { { &appl_iSpeed,    &appl_sUint16Prop } } },
-   {  0x2,  "REF_SPEED", ABP_UINT16,   1, AD_ADI_DESC__R_S_, { { &appl_iRefSpeed, &appl_sUint16Prop } } }
-};
+#if( APPL_CFG_HOST_PERF_ADIS_ENABLED )
+APPL_HostPerfType APPL_sHostPerf;
+#endif
 
 /*------------------------------------------------------------------------------
-** Map all adi:s in both directions
+** ADI declarations. ABCC_API_asAdiEntryList, ABCC_API_asAdObjDefaultMap and
+** ABCC_API_CbfGetNumAdi() are generated from them, see appl_adi_table.h.
+** Speed and reference speed of all axes are mapped, the limits are not.
 **------------------------------------------------------------------------------
-** 1. AD instance | 2. Direction | 3. Num elements | 4. Start index |
+** 1. Instance | 2. Name | 3. Type | 4. Elements | 5. Descriptor | 6. Value |
+** 7. Shape | 8. Properties | 9. Mapping
 **------------------------------------------------------------------------------
 */
-const AD_MapType ABCC_API_asAdObjDefaultMap[] =
-{
-   { 1, PD_WRITE, AD_MAP_ALL_ELEM, 0 },
-   { 2, PD_READ,  AD_MAP_ALL_ELEM, 0 },
-   { AD_MAP_END_ENTRY }
-};
+#define APPL_AXIS_ADIS( ADI )                                                   \
+   ADI( 0x1, SPEED,     UINT16, APPL_CFG_NUM_AXES, AD_ADI_DESC___W_G, appl_aiSpeed,    ARRAY, &appl_sUint16Prop, PD_WRITE ) \
+   ADI( 0x2, REF_SPEED, UINT16, APPL_CFG_NUM_AXES, AD_ADI_DESC__R_S_, appl_aiRefSpeed, ARRAY, &appl_sUint16Prop, PD_READ  ) \
+   ADI( 0x3, MIN_SPEED, UINT16, APPL_CFG_NUM_AXES, AD_ADI_DESC__R_S_, appl_aiMinSpeed, ARRAY, &appl_sUint16Prop, NO_PD    ) \
+   ADI( 0x4, MAX_SPEED, UINT16, APPL_CFG_NUM_AXES, AD_ADI_DESC__R_S_, appl_aiMaxSpeed, ARRAY, &appl_sUint16Prop, NO_PD    )
 
-UINT16 ABCC_API_CbfGetNumAdi( void )
-{
-   return( sizeof( ABCC_API_asAdiEntryList ) / sizeof( AD_AdiEntryType ) );
-}
+#if( APPL_CFG_HOST_PERF_ADIS_ENABLED )
+/*
+** Host performance figures, read-only and mappable as write process data.
+*/
+#define APPL_HOST_PERF_ADIS( ADI )                                              \
+   ADI( 0x100, HOST_LOOP_COUNT,   UINT32, 1, AD_ADI_DESC___W_G, APPL_sHostPerf.lLoopCount,         SCALAR, NULL, NO_PD ) \
+   ADI( 0x101, HOST_CYCLE_P99_US, UINT32, 1, AD_ADI_DESC___W_G, APPL_sHostPerf.lCycleP99Us,        SCALAR, NULL, NO_PD ) \
+   ADI( 0x102, HOST_CYCLE_MAX_US, UINT32, 1, AD_ADI_DESC___W_G, APPL_sHostPerf.lCycleMaxUs,        SCALAR, NULL, NO_PD ) \
+   ADI( 0x103, HOST_HAL_ERRORS,   UINT32, 1, AD_ADI_DESC___W_G, APPL_sHostPerf.lHalErrors,         SCALAR, NULL, NO_PD ) \
+   ADI( 0x104, HOST_TP_PER_CYCLE, FLOAT,  1, AD_ADI_DESC___W_G, APPL_sHostPerf.rTransfersPerCycle, SCALAR, NULL, NO_PD ) \
+   ADI( 0x105, HOST_CMD_QUEUE,    UINT16, 1, AD_ADI_DESC___W_G, APPL_sHostPerf.iCmdQueueDepth,     SCALAR, NULL, NO_PD )
+#else
+#define APPL_HOST_PERF_ADIS( ADI )
+#endif
+
+#define APPL_ADIS( ADI )                                                        \
+   APPL_AXIS_ADIS( ADI )                                                        \
+   APPL_HOST_PERF_ADIS( ADI )
+
+APPL_ADI_DEFINE_TABLES( APPL_ADIS )
 
 /*------------------------------------------------------------------------------
 ** Example - electric motor control loop
 **------------------------------------------------------------------------------
 */
-void ABCC_API_CbfCyclicalProcessing()
+static void MotorRampTask( void )
 {
    if( ABCC_API_AnbState() == ABP_ANB_STATE_PROCESS_ACTIVE )
    {
       /*
-      ** An example of ADI data handling.
+      ** An example of ADI data handling. Moves every axis one ramp step
+      ** towards its reference speed.
       */
-      if( appl_iSpeed > appl_iRefSpeed )
-      {
-         /*
-         ** Do something that lowers speed.
-         */
-         appl_iSpeed -= 1;
-      }
-      else if( appl_iSpeed < appl_iRefSpeed )
-      {
-         /*
-         ** Do something that increases speed.
-         */
-         appl_iSpeed += 1;
-      }
+      APPL_AXIS_Update( &appl_sAxisEngine );
    }
    else
    {
       /*
-      ** We are not in process active, the default should be that the motor
+      ** We are not in process active, the default should be that the motors
       ** should not run.
       */
-      appl_iSpeed = 0;
+      APPL_AXIS_Stop( &appl_sAxisEngine );
    }
 }
+
+/*------------------------------------------------------------------------------
+** Example - slow diagnostics, reports when the number of axes running at
+** their reference speed changes.
+**------------------------------------------------------------------------------
+*/
+static void DiagnosticsTask( void )
+{
+   static UINT16 iAtReference = 0;
+   UINT16        iNowAtReference;
+
+   if( ABCC_API_AnbState() != ABP_ANB_STATE_PROCESS_ACTIVE )
+   {
+      iAtReference = 0;
+      return;
+   }
+
+   /*
+   ** The log line is deferred while the host sheds load.
+   */
+   iNowAtReference = APPL_AXIS_CountAtReference( &appl_sAxisEngine );
+   if( ( iNowAtReference != iAtReference ) && !HOST_BUDGET_IsShedding() )
+   {
+      ABCC_LOG_INFO( "%u of %u axes at reference speed\n",
+                     iNowAtReference, (UINT16)APPL_CFG_NUM_AXES );
+      iAtReference = iNowAtReference;
+   }
+}
+
+void APPL_ControlLoopInit( UINT32 lPeriodUs )
+{
+   UINT16 iAxis;
+
+   /*
+   ** Default limits allow the full speed range.
+   */
+   for( iAxis = 0; iAxis < APPL_CFG_NUM_AXES; iAxis++ )
+   {
+      appl_aiMinSpeed[ iAxis ] = 0;
+      appl_aiMaxSpeed[ iAxis ] = 0xFFFF;
+   }
+
+   HOST_JITTER_Init( &appl_sPdJitter, "pd update", lPeriodUs );
+
+   HOST_SCHED_Init();
+   HOST_SCHED_AddTask( "motor ramp", MotorRampTask, APPL_CFG_MOTOR_RAMP_PERIOD_US, 0 );
+   HOST_SCHED_AddTask( "diagnostics", DiagnosticsTask, APPL_CFG_DIAGNOSTICS_PERIOD_US, 1 );
+}
+
+void APPL_ControlLoopPrintJitter( void )
+{
+   HOST_JITTER_PrintStats( &appl_sPdJitter );
+}
+
+/*------------------------------------------------------------------------------
+** Called on every communication tick, after new read process data has been
+** received. Runs the tasks that are due.
+**------------------------------------------------------------------------------
+*/
+void ABCC_API_CbfCyclicalProcessing()
+{
+   UINT64 llNowUs;
+   UINT64 llTraceNs;
+
+   llTraceNs = HOST_TRACE_Begin();
+   llNowUs = HOST_TIME_GetUs();
+   HOST_JITTER_Mark( &appl_sPdJitter, llNowUs );
+   HOST_SCHED_Run( llNowUs );
+
+   /*
+   ** Publish after the tasks so that the image holds this cycle's results.
+   */
+   HOST_IMAGE_Publish();
+   HOST_TRACE_End( HOST_TRACE_CAT_APPL, "ABCC_API_CbfCyclicalProcessing", llTraceNs, 0 );
+}
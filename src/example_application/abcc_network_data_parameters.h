@@ -0,0 +1,65 @@
+/*******************************************************************************
+** Copyright 2025-present HMS Industrial Networks AB.
+** Licensed under the MIT License.
+********************************************************************************
+** File Description:
+** Example ADI setup and the control loop operating on it.
+********************************************************************************
+*/
+
+#ifndef ABCC_NETWORK_DATA_PARAMETERS_H_
+#define ABCC_NETWORK_DATA_PARAMETERS_H_
+
+#include "abcc_types.h"
+#include "abcc_config.h"
+
+#if( APPL_CFG_HOST_PERF_ADIS_ENABLED )
+/*------------------------------------------------------------------------------
+** Host performance figures, published as ADIs 0x100-0x105. Filled in by the
+** main loop, see APPL_CFG_HOST_PERF_PERIOD_US.
+**
+** lLoopCount          - Main loop iterations since start.
+** lCycleP99Us         - 99th percentile of the main loop interval.
+** lCycleMaxUs         - Longest main loop interval.
+** lHalErrors          - Failed Transport Provider calls since start.
+** rTransfersPerCycle  - Transport Provider round trips per main loop
+**                       iteration over the last refresh period.
+** iCmdQueueDepth      - Application commands queued or sent and not answered
+**                       yet. They all go through the command batches.
+**------------------------------------------------------------------------------
+*/
+typedef struct APPL_HostPerfType
+{
+   UINT32  lLoopCount;
+   UINT32  lCycleP99Us;
+   UINT32  lCycleMaxUs;
+   UINT32  lHalErrors;
+   FLOAT32 rTransfersPerCycle;
+   UINT16  iCmdQueueDepth;
+}
+APPL_HostPerfType;
+
+EXTVAR APPL_HostPerfType APPL_sHostPerf;
+#endif
+
+/*------------------------------------------------------------------------------
+** APPL_ControlLoopInit()
+** Registers the control loop tasks with the scheduler. Must be called before
+** ABCC_API_Init().
+**------------------------------------------------------------------------------
+** Inputs:
+**    lPeriodUs - Main loop period, the expected process data update
+**                interval.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void APPL_ControlLoopInit( UINT32 lPeriodUs );
+
+/*------------------------------------------------------------------------------
+** APPL_ControlLoopPrintJitter()
+** Prints the process data update interval row of the jitter table. See
+** host_jitter.h.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void APPL_ControlLoopPrintJitter( void );
+
+#endif  /* inclusion lock */
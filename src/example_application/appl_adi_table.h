@@ -0,0 +1,200 @@
+/*******************************************************************************
+** Copyright 2025-present HMS Industrial Networks AB.
+** Licensed under the MIT License.
+********************************************************************************
+** File Description:
+** Generates the ADI entry list, the default map and ABCC_API_CbfGetNumAdi()
+** from one list of typed ADI declarations.
+**
+** The ADIs are declared once, as a list macro that invokes its argument for
+** every ADI:
+**
+**    #define APPL_ADIS( ADI )                                                 \
+**       ADI( 0x1, SPEED, UINT16, 4, AD_ADI_DESC___W_G, appl_aiSpeed,      ARRAY,  &appl_sProp, PD_WRITE ) \
+**       ADI( 0x2, COUNT, UINT32, 1, AD_ADI_DESC___W_G, appl_sPerf.lCount, SCALAR, NULL,        NO_PD    )
+**
+**    APPL_ADI_DEFINE_TABLES( APPL_ADIS )
+**
+** 1. Instance | 2. Name | 3. Data type without the ABP_ prefix |
+** 4. Number of elements | 5. Descriptor | 6. Value variable, not a pointer |
+** 7. ARRAY or SCALAR, the shape of the value variable |
+** 8. Property pointer or NULL | 9. PD_READ, PD_WRITE or NO_PD
+**
+** The tables are constant initializers, nothing is set up at runtime. The
+** default map holds the PD_READ and PD_WRITE ADIs, all elements, in the order
+** they are declared.
+**
+** Layout errors are build errors:
+**    - An element of the value variable is not the size of the data type.
+**      Signedness is not checked.
+**    - The value variable does not hold the number of elements, a SCALAR
+**      exactly one.
+**    - The number of elements is not 1-255.
+**    - Two ADIs have the same instance number (duplicate case value).
+**    - The default map of one direction needs more than
+**      ABCC_CFG_MAX_PROCESS_DATA_SIZE bytes.
+**
+** The process data layout of the default map is known at build time as well.
+** APPL_ADI_READ_OFFSET( Name ) and APPL_ADI_WRITE_OFFSET( Name ) are the
+** offsets of a mapped ADI in the read and write images, APPL_ADI_READ_PD_SIZE
+** and APPL_ADI_WRITE_PD_SIZE the image sizes. All are constant expressions,
+** usable in the file that holds the declaration list. The image sizes are
+** also exported as APPL_ADI_iReadPdSize and APPL_ADI_iWritePdSize, which
+** main() sizes the process data buffers from.
+**
+** Structured ADIs and the get/set callbacks are not covered, see the
+** ABCC_CFG_STRUCT_DATA_TYPE_ENABLED check in abcc_network_data_parameters.c.
+********************************************************************************
+*/
+
+#ifndef APPL_ADI_TABLE_H_
+#define APPL_ADI_TABLE_H_
+
+#include <stddef.h>
+
+#include "abcc_api.h"
+
+/*------------------------------------------------------------------------------
+** Element size of each data type, by the name used in the declarations.
+**------------------------------------------------------------------------------
+*/
+#define APPL_ADI_SIZE_BOOL                         ( 1 )
+#define APPL_ADI_SIZE_SINT8                        ( 1 )
+#define APPL_ADI_SIZE_UINT8                        ( 1 )
+#define APPL_ADI_SIZE_CHAR                         ( 1 )
+#define APPL_ADI_SIZE_ENUM                         ( 1 )
+#define APPL_ADI_SIZE_BITS8                        ( 1 )
+#define APPL_ADI_SIZE_OCTET                        ( 1 )
+#define APPL_ADI_SIZE_SINT16                       ( 2 )
+#define APPL_ADI_SIZE_UINT16                       ( 2 )
+#define APPL_ADI_SIZE_BITS16                       ( 2 )
+#define APPL_ADI_SIZE_SINT32                       ( 4 )
+#define APPL_ADI_SIZE_UINT32                       ( 4 )
+#define APPL_ADI_SIZE_FLOAT                        ( 4 )
+#define APPL_ADI_SIZE_BITS32                       ( 4 )
+#define APPL_ADI_SIZE_SINT64                       ( 8 )
+#define APPL_ADI_SIZE_UINT64                       ( 8 )
+
+/*------------------------------------------------------------------------------
+** Size of one element of a value variable, by its shape.
+**------------------------------------------------------------------------------
+*/
+#define APPL_ADI_ELEM_SIZE_ARRAY( Value )          sizeof( (Value)[ 0 ] )
+#define APPL_ADI_ELEM_SIZE_SCALAR( Value )         sizeof( Value )
+
+/*------------------------------------------------------------------------------
+** Build time check. A false condition declares an array of negative size.
+**------------------------------------------------------------------------------
+*/
+#define APPL_ADI_ASSERT( fCondition, Tag )                                      \
+   typedef char appl_AdiAssert_##Tag[ ( fCondition ) ? 1 : -1 ]
+
+/*------------------------------------------------------------------------------
+** Generators, one per table. Each is invoked by the declaration list with
+** the nine columns of an ADI. The shape and mapping columns are only ever
+** pasted, so ARRAY, SCALAR, PD_READ and PD_WRITE select a variant and are not
+** expanded.
+**------------------------------------------------------------------------------
+*/
+#define APPL_ADI_ENTRY( iInst, Name, Type, bNumElem, bDesc, Value, Shape, pxProp, Map ) \
+   { iInst, #Name, ABP_##Type, bNumElem, bDesc, { { (void*)&( Value ), pxProp } } },
+
+#define APPL_ADI_CHECK( iInst, Name, Type, bNumElem, bDesc, Value, Shape, pxProp, Map ) \
+   APPL_ADI_ASSERT( APPL_ADI_ELEM_SIZE_##Shape( Value ) == APPL_ADI_SIZE_##Type, Name##_element_size ); \
+   APPL_ADI_ASSERT( sizeof( Value ) == (bNumElem) * APPL_ADI_ELEM_SIZE_##Shape( Value ), Name##_size ); \
+   APPL_ADI_ASSERT( ( (bNumElem) >= 1 ) && ( (bNumElem) <= 255 ), Name##_elements );
+
+#define APPL_ADI_CASE( iInst, Name, Type, bNumElem, bDesc, Value, Shape, pxProp, Map ) \
+   case iInst:
+
+#define APPL_ADI_MAP( iInst, Name, Type, bNumElem, bDesc, Value, Shape, pxProp, Map ) \
+   APPL_ADI_MAP_##Map( iInst )
+#define APPL_ADI_MAP_PD_READ( iInst )              { iInst, PD_READ,  AD_MAP_ALL_ELEM, 0 },
+#define APPL_ADI_MAP_PD_WRITE( iInst )             { iInst, PD_WRITE, AD_MAP_ALL_ELEM, 0 },
+#define APPL_ADI_MAP_NO_PD( iInst )
+
+/*------------------------------------------------------------------------------
+** The process data images as structures with one byte array per mapped ADI.
+** Byte arrays need no padding, so the member offsets are the offsets in the
+** image. bEnd marks the image size and keeps an unmapped direction from
+** being an empty structure.
+**------------------------------------------------------------------------------
+*/
+#define APPL_ADI_READ_MEMBER( iInst, Name, Type, bNumElem, bDesc, Value, Shape, pxProp, Map ) \
+   APPL_ADI_READ_MEMBER_##Map( Name, Value )
+#define APPL_ADI_READ_MEMBER_PD_READ( Name, Value )  UINT8 ab##Name[ sizeof( Value ) ];
+#define APPL_ADI_READ_MEMBER_PD_WRITE( Name, Value )
+#define APPL_ADI_READ_MEMBER_NO_PD( Name, Value )
+
+#define APPL_ADI_WRITE_MEMBER( iInst, Name, Type, bNumElem, bDesc, Value, Shape, pxProp, Map ) \
+   APPL_ADI_WRITE_MEMBER_##Map( Name, Value )
+#define APPL_ADI_WRITE_MEMBER_PD_READ( Name, Value )
+#define APPL_ADI_WRITE_MEMBER_PD_WRITE( Name, Value ) UINT8 ab##Name[ sizeof( Value ) ];
+#define APPL_ADI_WRITE_MEMBER_NO_PD( Name, Value )
+
+#define APPL_ADI_READ_OFFSET( Name )               offsetof( appl_AdiReadImageType, ab##Name )
+#define APPL_ADI_WRITE_OFFSET( Name )              offsetof( appl_AdiWriteImageType, ab##Name )
+#define APPL_ADI_READ_PD_SIZE                      offsetof( appl_AdiReadImageType, bEnd )
+#define APPL_ADI_WRITE_PD_SIZE                     offsetof( appl_AdiWriteImageType, bEnd )
+
+/*------------------------------------------------------------------------------
+** Read and write process data sizes of the default map, defined by
+** APPL_ADI_DEFINE_TABLES().
+**------------------------------------------------------------------------------
+*/
+EXTVAR const UINT16 APPL_ADI_iReadPdSize;
+EXTVAR const UINT16 APPL_ADI_iWritePdSize;
+
+/*------------------------------------------------------------------------------
+** APPL_ADI_DEFINE_TABLES()
+** Defines ABCC_API_asAdiEntryList, ABCC_API_asAdObjDefaultMap,
+** ABCC_API_CbfGetNumAdi() and the process data layout from a declaration
+** list. Use once, at file scope, after the value and property variables.
+**------------------------------------------------------------------------------
+*/
+#define APPL_ADI_DEFINE_TABLES( LIST )                                          \
+   LIST( APPL_ADI_CHECK )                                                       \
+                                                                                \
+   typedef struct appl_AdiReadImageType                                         \
+   {                                                                            \
+      LIST( APPL_ADI_READ_MEMBER )                                              \
+      UINT8 bEnd;                                                               \
+   }                                                                            \
+   appl_AdiReadImageType;                                                       \
+                                                                                \
+   typedef struct appl_AdiWriteImageType                                        \
+   {                                                                            \
+      LIST( APPL_ADI_WRITE_MEMBER )                                             \
+      UINT8 bEnd;                                                               \
+   }                                                                            \
+   appl_AdiWriteImageType;                                                      \
+                                                                                \
+   APPL_ADI_ASSERT( APPL_ADI_READ_PD_SIZE <= ABCC_CFG_MAX_PROCESS_DATA_SIZE, read_pd_size ); \
+   APPL_ADI_ASSERT( APPL_ADI_WRITE_PD_SIZE <= ABCC_CFG_MAX_PROCESS_DATA_SIZE, write_pd_size ); \
+                                                                                \
+   const UINT16 APPL_ADI_iReadPdSize = (UINT16)APPL_ADI_READ_PD_SIZE;           \
+   const UINT16 APPL_ADI_iWritePdSize = (UINT16)APPL_ADI_WRITE_PD_SIZE;         \
+                                                                                \
+   const AD_AdiEntryType ABCC_API_asAdiEntryList[] =                            \
+   {                                                                            \
+      LIST( APPL_ADI_ENTRY )                                                    \
+   };                                                                           \
+                                                                                \
+   const AD_MapType ABCC_API_asAdObjDefaultMap[] =                              \
+   {                                                                            \
+      LIST( APPL_ADI_MAP )                                                      \
+      { AD_MAP_END_ENTRY }                                                      \
+   };                                                                           \
+                                                                                \
+   UINT16 ABCC_API_CbfGetNumAdi( void )                                         \
+   {                                                                            \
+      switch( 0 )                                                               \
+      {                                                                         \
+      LIST( APPL_ADI_CASE )                                                     \
+      default:                                                                  \
+         break;                                                                 \
+      }                                                                         \
+      return( sizeof( ABCC_API_asAdiEntryList ) / sizeof( AD_AdiEntryType ) );  \
+   }
+
+#endif  /* inclusion lock */
@@ -0,0 +1,142 @@
+/*******************************************************************************
+** Copyright 2025-present HMS Industrial Networks AB.
+** Licensed under the MIT License.
+********************************************************************************
+** File Description:
+** Multi-axis speed ramp engine.
+********************************************************************************
+*/
+
+#include <string.h>
+
+#include "appl_axis_engine.h"
+
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && ( _M_IX86_FP >= 2 ) )
+   #define APPL_AXIS_SSE2_ENABLED                  1
+   #include <emmintrin.h>
+#else
+   #define APPL_AXIS_SSE2_ENABLED                  0
+#endif
+
+/*------------------------------------------------------------------------------
+** Clamps the reference to the axis limits.
+**------------------------------------------------------------------------------
+*/
+static UINT16 GetTarget( const APPL_AXIS_EngineType* psEngine, UINT16 iAxis )
+{
+   UINT16 iTarget = psEngine->paiRefSpeed[ iAxis ];
+
+   if( iTarget > psEngine->paiMaxSpeed[ iAxis ] )
+   {
+      iTarget = psEngine->paiMaxSpeed[ iAxis ];
+   }
+   if( iTarget < psEngine->paiMinSpeed[ iAxis ] )
+   {
+      iTarget = psEngine->paiMinSpeed[ iAxis ];
+   }
+   return( iTarget );
+}
+
+static void UpdateScalarRange( const APPL_AXIS_EngineType* psEngine, UINT16 iFirst )
+{
+   UINT16 iAxis;
+   UINT16 iTarget;
+   UINT16 iSpeed;
+
+   for( iAxis = iFirst; iAxis < psEngine->iNumAxes; iAxis++ )
+   {
+      iTarget = GetTarget( psEngine, iAxis );
+      iSpeed = psEngine->paiSpeed[ iAxis ];
+
+      if( iSpeed > iTarget )
+      {
+         /*
+         ** Do something that lowers speed.
+         */
+         iSpeed = ( iSpeed - iTarget > psEngine->iRampStep ) ?
+                  (UINT16)( iSpeed - psEngine->iRampStep ) : iTarget;
+      }
+      else if( iSpeed < iTarget )
+      {
+         /*
+         ** Do something that increases speed.
+         */
+         iSpeed = ( iTarget - iSpeed > psEngine->iRampStep ) ?
+                  (UINT16)( iSpeed + psEngine->iRampStep ) : iTarget;
+      }
+      psEngine->paiSpeed[ iAxis ] = iSpeed;
+   }
+}
+
+void APPL_AXIS_UpdateScalar( const APPL_AXIS_EngineType* psEngine )
+{
+   UpdateScalarRange( psEngine, 0 );
+}
+
+#if APPL_AXIS_SSE2_ENABLED
+/*------------------------------------------------------------------------------
+** SSE2 has no unsigned 16-bit min/max, they are built from saturating
+** subtraction instead:
+**    min( a, b ) = a - sat( a - b )
+**    max( a, b ) = b + sat( a - b )
+**------------------------------------------------------------------------------
+*/
+#define MinU16( a, b )  _mm_sub_epi16( ( a ), _mm_subs_epu16( ( a ), ( b ) ) )
+#define MaxU16( a, b )  _mm_add_epi16( ( b ), _mm_subs_epu16( ( a ), ( b ) ) )
+
+void APPL_AXIS_Update( const APPL_AXIS_EngineType* psEngine )
+{
+   __m128i xStep;
+   __m128i xSpeed;
+   __m128i xTarget;
+   __m128i xUp;
+   __m128i xDown;
+   UINT16  iAxis;
+
+   xStep = _mm_set1_epi16( (short)psEngine->iRampStep );
+
+   for( iAxis = 0; iAxis + 8 <= psEngine->iNumAxes; iAxis += 8 )
+   {
+      xSpeed = _mm_loadu_si128( (const __m128i*)&psEngine->paiSpeed[ iAxis ] );
+      xTarget = _mm_loadu_si128( (const __m128i*)&psEngine->paiRefSpeed[ iAxis ] );
+      xTarget = MinU16( xTarget, _mm_loadu_si128( (const __m128i*)&psEngine->paiMaxSpeed[ iAxis ] ) );
+      xTarget = MaxU16( xTarget, _mm_loadu_si128( (const __m128i*)&psEngine->paiMinSpeed[ iAxis ] ) );
+
+      /*
+      ** At most one of the two differences is non-zero for each axis.
+      */
+      xUp = MinU16( _mm_subs_epu16( xTarget, xSpeed ), xStep );
+      xDown = MinU16( _mm_subs_epu16( xSpeed, xTarget ), xStep );
+      xSpeed = _mm_subs_epu16( _mm_adds_epu16( xSpeed, xUp ), xDown );
+
+      _mm_storeu_si128( (__m128i*)&psEngine->paiSpeed[ iAxis ], xSpeed );
+   }
+
+   UpdateScalarRange( psEngine, iAxis );
+}
+#else
+void APPL_AXIS_Update( const APPL_AXIS_EngineType* psEngine )
+{
+   UpdateScalarRange( psEngine, 0 );
+}
+#endif
+
+void APPL_AXIS_Stop( const APPL_AXIS_EngineType* psEngine )
+{
+   memset( psEngine->paiSpeed, 0, psEngine->iNumAxes * sizeof( psEngine->paiSpeed[ 0 ] ) );
+}
+
+UINT16 APPL_AXIS_CountAtReference( const APPL_AXIS_EngineType* psEngine )
+{
+   UINT16 iAxis;
+   UINT16 iCount = 0;
+
+   for( iAxis = 0; iAxis < psEngine->iNumAxes; iAxis++ )
+   {
+      if( psEngine->paiSpeed[ iAxis ] == GetTarget( psEngine, iAxis ) )
+      {
+         iCount++;
+      }
+   }
+   return( iCount );
+}
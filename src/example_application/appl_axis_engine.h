@@ -0,0 +1,75 @@
+/*******************************************************************************
+** Copyright 2025-present HMS Industrial Networks AB.
+** Licensed under the MIT License.
+********************************************************************************
+** File Description:
+** Multi-axis speed ramp engine.
+**
+** The axis data is kept as a structure of arrays, one array per quantity, so
+** that the same arrays can be exposed directly as ADI arrays and so that the
+** per-cycle update can process several axes per instruction. On x86 targets
+** with SSE2 eight axes are updated at a time, other targets use the scalar
+** implementation.
+**
+** Every cycle each axis moves its speed at most iRampStep towards its
+** reference speed, after the reference has been clamped to the axis limits.
+********************************************************************************
+*/
+
+#ifndef APPL_AXIS_ENGINE_H_
+#define APPL_AXIS_ENGINE_H_
+
+#include "abcc_types.h"
+
+/*------------------------------------------------------------------------------
+** Axis data.
+**
+** paiSpeed    - Actual speed of each axis.
+** paiRefSpeed - Reference speed of each axis.
+** paiMinSpeed - Lower limit of each axis.
+** paiMaxSpeed - Upper limit of each axis.
+** iNumAxes    - Number of elements in each array.
+** iRampStep   - Largest speed change per cycle.
+**------------------------------------------------------------------------------
+*/
+typedef struct APPL_AXIS_EngineType
+{
+   UINT16* paiSpeed;
+   UINT16* paiRefSpeed;
+   UINT16* paiMinSpeed;
+   UINT16* paiMaxSpeed;
+   UINT16  iNumAxes;
+   UINT16  iRampStep;
+}
+APPL_AXIS_EngineType;
+
+/*------------------------------------------------------------------------------
+** APPL_AXIS_Update()
+** Runs one ramp cycle for all axes, vectorized where supported.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void APPL_AXIS_Update( const APPL_AXIS_EngineType* psEngine );
+
+/*------------------------------------------------------------------------------
+** APPL_AXIS_UpdateScalar()
+** Same as APPL_AXIS_Update() but always one axis at a time. Used as reference
+** by the benchmark.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void APPL_AXIS_UpdateScalar( const APPL_AXIS_EngineType* psEngine );
+
+/*------------------------------------------------------------------------------
+** APPL_AXIS_Stop()
+** Sets the speed of all axes to zero.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void APPL_AXIS_Stop( const APPL_AXIS_EngineType* psEngine );
+
+/*------------------------------------------------------------------------------
+** APPL_AXIS_CountAtReference()
+** Returns the number of axes whose speed equals their clamped reference.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC UINT16 APPL_AXIS_CountAtReference( const APPL_AXIS_EngineType* psEngine );
+
+#endif  /* inclusion lock */
@@ -0,0 +1,425 @@
+/*******************************************************************************
+** Copyright 2025-present HMS Industrial Networks AB.
+** Licensed under the MIT License.
+********************************************************************************
+** File Description:
+** Batches of application originated commands with one completion callback.
+********************************************************************************
+*/
+
+#include "abcc.h"
+#include "abcc_log.h"
+#include "host_time.h"
+#include "host_trace.h"
+#include "appl_command_queue.h"
+#include "appl_command_batch.h"
+
+/*------------------------------------------------------------------------------
+** A command in flight: the source ID it was sent with and the entry its
+** response belongs to. psBatch is NULL for a free slot. A command is in
+** flight from the moment it is queued, so there can be as many as the driver
+** has command buffers plus what the command queue holds.
+**------------------------------------------------------------------------------
+*/
+typedef struct appl_InFlightType
+{
+   APPL_CMD_BATCH_Type* psBatch;
+   UINT16               iEntry;
+   UINT8                bSourceId;
+}
+appl_InFlightType;
+
+static appl_InFlightType        appl_asInFlight[ APPL_CMD_BATCH_MAX_IN_FLIGHT ];
+static UINT16                   appl_iInFlight;
+static APPL_CMD_BATCH_Type*     appl_psBatchHead;
+static APPL_CMD_BATCH_StatsType appl_sBatchStats;
+
+static void HandleResponse( ABP_MsgType* psMsg );
+static void HandleSendError( const ABP_MsgType* psMsg );
+
+/*------------------------------------------------------------------------------
+** Returns the slot of the command in flight with the source ID of psMsg, or
+** NULL if there is none.
+**------------------------------------------------------------------------------
+*/
+static appl_InFlightType* FindSlot( const ABP_MsgType* psMsg )
+{
+   UINT16 i;
+
+   for( i = 0; i < APPL_CMD_BATCH_MAX_IN_FLIGHT; i++ )
+   {
+      if( ( appl_asInFlight[ i ].psBatch != NULL ) &&
+          ( appl_asInFlight[ i ].bSourceId == ABCC_GetMsgSourceId( psMsg ) ) )
+      {
+         return( &appl_asInFlight[ i ] );
+      }
+   }
+   return( NULL );
+}
+
+/*------------------------------------------------------------------------------
+** Counts a finished entry. The last one unlinks the batch and calls its
+** callback. Returns TRUE if the batch completed.
+**------------------------------------------------------------------------------
+*/
+static BOOL CompleteEntry( APPL_CMD_BATCH_Type* psBatch, BOOL8 fError )
+{
+   APPL_CMD_BATCH_Type** ppsLink;
+
+   psBatch->iNumDone++;
+   if( fError )
+   {
+      psBatch->iNumErrors++;
+      appl_sBatchStats.lNumErrors++;
+   }
+   if( psBatch->iNumDone < psBatch->iNumEntries )
+   {
+      return( FALSE );
+   }
+
+   for( ppsLink = &appl_psBatchHead; *ppsLink != NULL; ppsLink = &(*ppsLink)->psNext )
+   {
+      if( *ppsLink == psBatch )
+      {
+         *ppsLink = psBatch->psNext;
+         break;
+      }
+   }
+   psBatch->psNext = NULL;
+
+   psBatch->lTimeUs = (UINT32)( HOST_TIME_GetUs() - psBatch->llStartUs );
+   appl_sBatchStats.lNumBatches++;
+   if( psBatch->iWindow == 1 )
+   {
+      appl_sBatchStats.lSequentialCmds += psBatch->iNumEntries;
+      appl_sBatchStats.llSequentialUs += psBatch->lTimeUs;
+   }
+   else
+   {
+      appl_sBatchStats.lPipelinedCmds += psBatch->iNumEntries;
+      appl_sBatchStats.llPipelinedUs += psBatch->lTimeUs;
+   }
+   HOST_TRACE_Instant( HOST_TRACE_CAT_APPL, "command batch done", psBatch->lTimeUs );
+
+   psBatch->pnDone( psBatch );
+   return( TRUE );
+}
+
+/*------------------------------------------------------------------------------
+** Sends commands of a batch until its window is full, it has nothing left to
+** send or the command queue has no free buffer. Returns FALSE if the queue is
+** full.
+**------------------------------------------------------------------------------
+*/
+static BOOL SendPending( APPL_CMD_BATCH_Type* psBatch )
+{
+   APPL_CMD_BATCH_EntryType* psEntry;
+   appl_InFlightType*        psSlot;
+   ABP_MsgType*              psMsg;
+   UINT16                    i;
+
+   while( ( psBatch->iInFlight < psBatch->iWindow ) &&
+          ( psBatch->iNextToSend < psBatch->iNumEntries ) )
+   {
+      psSlot = NULL;
+      for( i = 0; i < APPL_CMD_BATCH_MAX_IN_FLIGHT; i++ )
+      {
+         if( appl_asInFlight[ i ].psBatch == NULL )
+         {
+            psSlot = &appl_asInFlight[ i ];
+            break;
+         }
+      }
+
+      psMsg = ( psSlot != NULL ) ? APPL_CMDQ_GetCmdMsgBuffer() : NULL;
+      if( psMsg == NULL )
+      {
+         appl_sBatchStats.lNumQueueFull++;
+         return( FALSE );
+      }
+
+      psEntry = &psBatch->pasEntries[ psBatch->iNextToSend ];
+      psSlot->psBatch = psBatch;
+      psSlot->iEntry = psBatch->iNextToSend;
+      psSlot->bSourceId = ABCC_GetNewSourceId();
+      psBatch->iNextToSend++;
+
+      ABCC_SetMsgHeader( psMsg,
+                         psEntry->bObject,
+                         psEntry->iInstance,
+                         psEntry->bCmdExt0,
+                         psEntry->bCmd,
+                         psEntry->iDataSize,
+                         psSlot->bSourceId );
+      if( psEntry->iDataSize > 0 )
+      {
+         memcpy( ABCC_GetMsgDataPtr( psMsg ), psEntry->pxData, psEntry->iDataSize );
+      }
+
+      /*
+      ** Counted before it is queued, the queue may hand it to the driver and
+      ** report a send error right away.
+      */
+      appl_sBatchStats.lNumCommands++;
+      psBatch->iInFlight++;
+      appl_iInFlight++;
+      if( appl_iInFlight > appl_sBatchStats.iInFlightHighWater )
+      {
+         appl_sBatchStats.iInFlightHighWater = appl_iInFlight;
+      }
+
+      APPL_CMDQ_SendCmdMsg( psMsg, HandleResponse, HandleSendError );
+   }
+
+   return( TRUE );
+}
+
+/*------------------------------------------------------------------------------
+** Response handler of all batch commands.
+**------------------------------------------------------------------------------
+*/
+static void HandleResponse( ABP_MsgType* psMsg )
+{
+   APPL_CMD_BATCH_Type*      psBatch;
+   APPL_CMD_BATCH_EntryType* psEntry;
+   appl_InFlightType*        psSlot;
+   UINT16                    iSize;
+
+   psSlot = FindSlot( psMsg );
+   if( psSlot == NULL )
+   {
+      appl_sBatchStats.lNumUnmatched++;
+      ABCC_LOG_WARNING( ABCC_EC_INTERNAL_ERROR,
+         (UINT32)ABCC_GetMsgSourceId( psMsg ),
+         "Batch response without a matching command\n" );
+      return;
+   }
+
+   psBatch = psSlot->psBatch;
+   psEntry = &psBatch->pasEntries[ psSlot->iEntry ];
+   psSlot->psBatch = NULL;
+   psBatch->iInFlight--;
+   appl_iInFlight--;
+
+   iSize = 0;
+   if( psEntry->pxResponse != NULL )
+   {
+      iSize = ABCC_GetMsgDataSize( psMsg );
+      if( iSize > psEntry->iResponseBufSize )
+      {
+         iSize = psEntry->iResponseBufSize;
+      }
+      memcpy( psEntry->pxResponse, ABCC_GetMsgDataPtr( psMsg ), iSize );
+   }
+   psEntry->iResponseSize = iSize;
+   psEntry->fError = ( ABCC_VerifyMessage( psMsg ) != ABCC_EC_NO_ERROR );
+
+   CompleteEntry( psBatch, psEntry->fError );
+
+   /*
+   ** A slot is free again. Send the next command now instead of waiting for
+   ** the main loop, that is what keeps the pipeline full.
+   */
+   APPL_CMD_BATCH_Run();
+}
+
+/*------------------------------------------------------------------------------
+** Send error handler of all batch commands. Called by the command queue when
+** the driver rejects a queued command, which then never gets a response. The
+** slot is not refilled here, the queue is still handing over commands.
+**------------------------------------------------------------------------------
+*/
+static void HandleSendError( const ABP_MsgType* psMsg )
+{
+   APPL_CMD_BATCH_Type*      psBatch;
+   APPL_CMD_BATCH_EntryType* psEntry;
+   appl_InFlightType*        psSlot;
+
+   psSlot = FindSlot( psMsg );
+   if( psSlot == NULL )
+   {
+      return;
+   }
+
+   psBatch = psSlot->psBatch;
+   psEntry = &psBatch->pasEntries[ psSlot->iEntry ];
+   psSlot->psBatch = NULL;
+   psBatch->iInFlight--;
+   appl_iInFlight--;
+
+   psEntry->iResponseSize = 0;
+   psEntry->fError = TRUE;
+   CompleteEntry( psBatch, TRUE );
+}
+
+void APPL_CMD_BATCH_Init( void )
+{
+   memset( appl_asInFlight, 0, sizeof( appl_asInFlight ) );
+   appl_iInFlight = 0;
+   appl_psBatchHead = NULL;
+   memset( &appl_sBatchStats, 0, sizeof( appl_sBatchStats ) );
+}
+
+BOOL APPL_CMD_BATCH_Start( APPL_CMD_BATCH_Type* psBatch,
+                           APPL_CMD_BATCH_EntryType* pasEntries,
+                           UINT16 iNumEntries,
+                           UINT16 iWindow,
+                           APPL_CMD_BATCH_DoneFuncType pnDone,
+                           void* pxContext )
+{
+   APPL_CMD_BATCH_Type** ppsLink;
+
+   if( ( iNumEntries == 0 ) || ( pnDone == NULL ) )
+   {
+      return( FALSE );
+   }
+
+   for( ppsLink = &appl_psBatchHead; *ppsLink != NULL; ppsLink = &(*ppsLink)->psNext )
+   {
+      if( *ppsLink == psBatch )
+      {
+         return( FALSE );
+      }
+   }
+
+   if( ( iWindow == 0 ) || ( iWindow > APPL_CMD_BATCH_MAX_IN_FLIGHT ) )
+   {
+      iWindow = APPL_CMD_BATCH_MAX_IN_FLIGHT;
+   }
+
+   psBatch->pasEntries = pasEntries;
+   psBatch->iNumEntries = iNumEntries;
+   psBatch->iWindow = iWindow;
+   psBatch->pnDone = pnDone;
+   psBatch->pxContext = pxContext;
+   psBatch->iNextToSend = 0;
+   psBatch->iInFlight = 0;
+   psBatch->iNumDone = 0;
+   psBatch->iNumErrors = 0;
+   psBatch->lTimeUs = 0;
+   psBatch->fAborted = FALSE;
+   psBatch->llStartUs = HOST_TIME_GetUs();
+   psBatch->psNext = NULL;
+
+   /*
+   ** Appended, so that batches get free queue buffers in the order they
+   ** were started.
+   */
+   *ppsLink = psBatch;
+
+   SendPending( psBatch );
+   return( TRUE );
+}
+
+void APPL_CMD_BATCH_Run( void )
+{
+   APPL_CMD_BATCH_Type* psBatch;
+   APPL_CMD_BATCH_Type* psNext;
+
+   for( psBatch = appl_psBatchHead; psBatch != NULL; psBatch = psNext )
+   {
+      /*
+      ** A send error can complete the batch and unlink it.
+      */
+      psNext = psBatch->psNext;
+      if( !SendPending( psBatch ) )
+      {
+         return;
+      }
+   }
+}
+
+void APPL_CMD_BATCH_Abort( void )
+{
+   APPL_CMD_BATCH_Type*      psBatch;
+   APPL_CMD_BATCH_Type*      psNext;
+   APPL_CMD_BATCH_EntryType* psEntry;
+   UINT16                    i;
+
+   /*
+   ** Free the slots first. Their responses never arrive, and a response to a
+   ** new command must not match one of them by a reused source ID.
+   */
+   for( i = 0; i < APPL_CMD_BATCH_MAX_IN_FLIGHT; i++ )
+   {
+      if( appl_asInFlight[ i ].psBatch != NULL )
+      {
+         psEntry = &appl_asInFlight[ i ].psBatch->pasEntries[ appl_asInFlight[ i ].iEntry ];
+         psEntry->iResponseSize = 0;
+         psEntry->fError = TRUE;
+         appl_asInFlight[ i ].psBatch = NULL;
+      }
+   }
+   appl_iInFlight = 0;
+
+   /*
+   ** Batches started by the callbacks go to the new, empty list.
+   */
+   psBatch = appl_psBatchHead;
+   appl_psBatchHead = NULL;
+   for( ; psBatch != NULL; psBatch = psNext )
+   {
+      psNext = psBatch->psNext;
+      psBatch->psNext = NULL;
+
+      for( i = psBatch->iNextToSend; i < psBatch->iNumEntries; i++ )
+      {
+         psBatch->pasEntries[ i ].iResponseSize = 0;
+         psBatch->pasEntries[ i ].fError = TRUE;
+      }
+      appl_sBatchStats.lNumErrors += (UINT32)( psBatch->iNumEntries - psBatch->iNumDone );
+      psBatch->iNumErrors += psBatch->iNumEntries - psBatch->iNumDone;
+      psBatch->iNumDone = psBatch->iNumEntries;
+      psBatch->iNextToSend = psBatch->iNumEntries;
+      psBatch->iInFlight = 0;
+      psBatch->lTimeUs = (UINT32)( HOST_TIME_GetUs() - psBatch->llStartUs );
+      psBatch->fAborted = TRUE;
+      appl_sBatchStats.lNumAborted++;
+      HOST_TRACE_Instant( HOST_TRACE_CAT_APPL, "command batch aborted", psBatch->lTimeUs );
+
+      psBatch->pnDone( psBatch );
+   }
+}
+
+void APPL_CMD_BATCH_GetStats( APPL_CMD_BATCH_StatsType* psStats )
+{
+   *psStats = appl_sBatchStats;
+   psStats->iInFlight = appl_iInFlight;
+}
+
+void APPL_CMD_BATCH_PrintStats( void )
+{
+   double dSequential = 0.0;
+   double dPipelined = 0.0;
+
+   if( appl_sBatchStats.llSequentialUs > 0 )
+   {
+      dSequential = (double)appl_sBatchStats.lSequentialCmds * 1000000.0 /
+                    (double)appl_sBatchStats.llSequentialUs;
+   }
+   if( appl_sBatchStats.llPipelinedUs > 0 )
+   {
+      dPipelined = (double)appl_sBatchStats.lPipelinedCmds * 1000000.0 /
+                   (double)appl_sBatchStats.llPipelinedUs;
+   }
+
+   printf( "Command batches:\n" );
+   printf( " - Batches/commands/errors:      %lu/%lu/%lu\n",
+           (unsigned long)appl_sBatchStats.lNumBatches,
+           (unsigned long)appl_sBatchStats.lNumCommands,
+           (unsigned long)appl_sBatchStats.lNumErrors );
+   printf( " - Aborted batches:              %lu\n", (unsigned long)appl_sBatchStats.lNumAborted );
+   printf( " - In flight now/high water:     %u/%u\n", appl_iInFlight, appl_sBatchStats.iInFlightHighWater );
+   printf( " - Unmatched/queue full:         %lu/%lu\n",
+           (unsigned long)appl_sBatchStats.lNumUnmatched,
+           (unsigned long)appl_sBatchStats.lNumQueueFull );
+   printf( " - Sequential cmd/s:             %.0f (%lu commands)\n",
+           dSequential, (unsigned long)appl_sBatchStats.lSequentialCmds );
+   printf( " - Pipelined cmd/s:              %.0f (%lu commands)",
+           dPipelined, (unsigned long)appl_sBatchStats.lPipelinedCmds );
+   if( dSequential > 0.0 )
+   {
+      printf( ", %.1fx sequential", dPipelined / dSequential );
+   }
+   printf( "\n" );
+}
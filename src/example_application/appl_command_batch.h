@@ -0,0 +1,204 @@
+/*******************************************************************************
+** Copyright 2025-present HMS Industrial Networks AB.
+** Licensed under the MIT License.
+********************************************************************************
+** File Description:
+** Batches of application originated commands with one completion callback.
+**
+** Reading a set of attributes one request at a time costs one round trip per
+** attribute. A batch instead keeps up to its window of commands in flight.
+** Each command gets its own source ID, and responses are matched to their
+** entry by that ID, in whatever order they arrive. When the last response of
+** a batch is in, its callback is called once for the whole batch.
+**
+** Batch commands are sent through the command queue in appl_command_queue.h,
+** which hands them to the driver as its command buffers free up. A batch that
+** finds the queue full sends the rest of its window from APPL_CMD_BATCH_Run().
+**
+** Batches run with a window of 1 are sequential issue. Their throughput is
+** kept apart from that of pipelined batches so the two can be compared.
+**
+** The driver drops the commands in flight when it restarts. Call
+** APPL_CMDQ_Flush() and then APPL_CMD_BATCH_Abort(), so that queued commands
+** are not sent after the restart, the batches complete and the source IDs of
+** the lost commands are forgotten.
+********************************************************************************
+*/
+
+#ifndef APPL_COMMAND_BATCH_H_
+#define APPL_COMMAND_BATCH_H_
+
+#include "abcc.h"
+
+/*------------------------------------------------------------------------------
+** Most batch commands that can be in flight at once, counting those still in
+** the command queue.
+**------------------------------------------------------------------------------
+*/
+#define APPL_CMD_BATCH_MAX_IN_FLIGHT   ( ABCC_CFG_MAX_NUM_APPL_CMDS + APPL_CFG_CMD_QUEUE_DEPTH )
+
+/*------------------------------------------------------------------------------
+** One command of a batch.
+**
+** Set by the caller:
+** bObject         - Destination object.
+** iInstance       - Destination instance.
+** bCmd            - Command, e.g. ABP_CMD_GET_ATTR.
+** bCmdExt0        - Command extension, the attribute for attribute commands.
+** pxData          - Request data. May be NULL if iDataSize is 0.
+** iDataSize       - Size of the request data.
+** pxResponse      - Buffer for the response data. May be NULL.
+** iResponseBufSize - Size of pxResponse.
+**
+** Set by the batch:
+** iResponseSize   - Number of response bytes copied to pxResponse.
+** fError          - TRUE if the response was an error response or the command
+**                   could not be sent. For an error response the error code
+**                   is the first byte in pxResponse.
+**------------------------------------------------------------------------------
+*/
+typedef struct APPL_CMD_BATCH_EntryType
+{
+   UINT8       bObject;
+   UINT16      iInstance;
+   UINT8       bCmd;
+   UINT8       bCmdExt0;
+   const void* pxData;
+   UINT16      iDataSize;
+   void*       pxResponse;
+   UINT16      iResponseBufSize;
+   UINT16      iResponseSize;
+   BOOL8       fError;
+}
+APPL_CMD_BATCH_EntryType;
+
+struct APPL_CMD_BATCH_Type;
+
+/*------------------------------------------------------------------------------
+** Called once when all commands of a batch have been answered.
+**------------------------------------------------------------------------------
+*/
+typedef void (*APPL_CMD_BATCH_DoneFuncType)( struct APPL_CMD_BATCH_Type* psBatch );
+
+/*------------------------------------------------------------------------------
+** A batch. The caller owns it and its entries until the callback is called.
+** The members are set by APPL_CMD_BATCH_Start(). After completion iNumErrors,
+** lTimeUs and fAborted, TRUE if APPL_CMD_BATCH_Abort() ended the batch, may
+** be read.
+**------------------------------------------------------------------------------
+*/
+typedef struct APPL_CMD_BATCH_Type
+{
+   APPL_CMD_BATCH_EntryType*    pasEntries;
+   UINT16                       iNumEntries;
+   UINT16                       iWindow;
+   APPL_CMD_BATCH_DoneFuncType  pnDone;
+   void*                        pxContext;
+   UINT16                       iNextToSend;
+   UINT16                       iInFlight;
+   UINT16                       iNumDone;
+   UINT16                       iNumErrors;
+   UINT64                       llStartUs;
+   UINT32                       lTimeUs;
+   BOOL8                        fAborted;
+   struct APPL_CMD_BATCH_Type*  psNext;
+}
+APPL_CMD_BATCH_Type;
+
+/*------------------------------------------------------------------------------
+** Batch statistics.
+**
+** lNumBatches        - Number of completed batches.
+** lNumAborted        - Number of batches ended by APPL_CMD_BATCH_Abort().
+**                      They are not in the throughput figures.
+** lNumCommands       - Number of commands sent.
+** lNumErrors         - Number of error responses and send errors.
+** lNumUnmatched      - Number of responses without a matching command.
+** lNumQueueFull      - Number of times a batch had room in its window but
+**                      the command queue had no free buffer.
+** iInFlight          - Batch commands queued or sent and not answered yet.
+** iInFlightHighWater - Highest number of batch commands in flight at once.
+** lSequentialCmds    - Commands of completed batches with a window of 1...
+** llSequentialUs     - ...and the time from their start to their callback.
+** lPipelinedCmds     - Commands of completed batches with a larger window...
+** llPipelinedUs      - ...and the time from their start to their callback.
+**------------------------------------------------------------------------------
+*/
+typedef struct APPL_CMD_BATCH_StatsType
+{
+   UINT32 lNumBatches;
+   UINT32 lNumAborted;
+   UINT32 lNumCommands;
+   UINT32 lNumErrors;
+   UINT32 lNumUnmatched;
+   UINT32 lNumQueueFull;
+   UINT16 iInFlight;
+   UINT16 iInFlightHighWater;
+   UINT32 lSequentialCmds;
+   UINT64 llSequentialUs;
+   UINT32 lPipelinedCmds;
+   UINT64 llPipelinedUs;
+}
+APPL_CMD_BATCH_StatsType;
+
+/*------------------------------------------------------------------------------
+** APPL_CMD_BATCH_Init()
+** Forgets all batches and resets the statistics.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void APPL_CMD_BATCH_Init( void );
+
+/*------------------------------------------------------------------------------
+** APPL_CMD_BATCH_Start()
+** Starts a batch and sends the first window of its commands.
+**------------------------------------------------------------------------------
+** Inputs:
+**    psBatch     - Batch to start. Must not already be running.
+**    pasEntries  - Commands, answered in place.
+**    iNumEntries - Number of commands.
+**    iWindow     - Maximum number of commands in flight. 0 or more than
+**                  APPL_CMD_BATCH_MAX_IN_FLIGHT means
+**                  APPL_CMD_BATCH_MAX_IN_FLIGHT, 1 is sequential issue.
+**    pnDone      - Completion callback.
+**    pxContext   - Stored in the batch for the callback.
+**
+** Outputs:
+**    Returns:    - FALSE if the batch is empty or already running.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC BOOL APPL_CMD_BATCH_Start( APPL_CMD_BATCH_Type* psBatch,
+                                   APPL_CMD_BATCH_EntryType* pasEntries,
+                                   UINT16 iNumEntries,
+                                   UINT16 iWindow,
+                                   APPL_CMD_BATCH_DoneFuncType pnDone,
+                                   void* pxContext );
+
+/*------------------------------------------------------------------------------
+** APPL_CMD_BATCH_Run()
+** Refills the windows of the running batches. Call once per main loop
+** iteration, next to APPL_CMDQ_Run().
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void APPL_CMD_BATCH_Run( void );
+
+/*------------------------------------------------------------------------------
+** APPL_CMD_BATCH_Abort()
+** Ends every running batch. Entries without a response get fError set and
+** no response data, and each callback is called with fAborted set. Call when
+** the driver restarts, as the commands in flight are then lost. A callback
+** may start a new batch.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void APPL_CMD_BATCH_Abort( void );
+
+/*------------------------------------------------------------------------------
+** APPL_CMD_BATCH_GetStats()
+** APPL_CMD_BATCH_PrintStats()
+** Reads or prints the batch statistics, including the sequential and
+** pipelined throughput.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void APPL_CMD_BATCH_GetStats( APPL_CMD_BATCH_StatsType* psStats );
+EXTFUNC void APPL_CMD_BATCH_PrintStats( void );
+
+#endif  /* inclusion lock */
@@ -0,0 +1,188 @@
+/*******************************************************************************
+** Copyright 2025-present HMS Industrial Networks AB.
+** Licensed under the MIT License.
+********************************************************************************
+** File Description:
+** Host side queue for application originated command messages.
+********************************************************************************
+*/
+
+#include "abcc.h"
+#include "abcc_api.h"
+#include "abcc_log.h"
+#include "appl_command_queue.h"
+
+/*------------------------------------------------------------------------------
+** A queued command is its message buffer plus the handlers to use once it is
+** handed over to the driver. Queued entries are linked in FIFO order through
+** psNext.
+**------------------------------------------------------------------------------
+*/
+typedef struct appl_CmdEntryType
+{
+   ABP_MsgType                 sMsg;
+   ABCC_MsgHandlerFuncType     pnMsgHandler;
+   APPL_CMDQ_SendErrorFuncType pnSendError;
+   struct appl_CmdEntryType*   psNext;
+}
+appl_CmdEntryType;
+
+static appl_CmdEntryType   appl_asCmdEntries[ APPL_CFG_CMD_QUEUE_DEPTH ];
+static UINT16              appl_aiCmdLinks[ APPL_CFG_CMD_QUEUE_DEPTH ];
+static HOST_MSG_POOL_Type  appl_sCmdPool;
+
+static appl_CmdEntryType*  appl_psQueueHead;
+static appl_CmdEntryType*  appl_psQueueTail;
+static APPL_CMDQ_StatsType appl_sCmdqStats;
+
+void APPL_CMDQ_Init( void )
+{
+   HOST_MSG_POOL_Init( &appl_sCmdPool,
+                       appl_asCmdEntries,
+                       appl_aiCmdLinks,
+                       (UINT16)sizeof( appl_CmdEntryType ),
+                       APPL_CFG_CMD_QUEUE_DEPTH );
+
+   appl_psQueueHead = NULL;
+   appl_psQueueTail = NULL;
+   memset( &appl_sCmdqStats, 0, sizeof( appl_sCmdqStats ) );
+}
+
+ABP_MsgType* APPL_CMDQ_GetCmdMsgBuffer( void )
+{
+   appl_CmdEntryType* psEntry;
+
+   psEntry = (appl_CmdEntryType*)HOST_MSG_POOL_Alloc( &appl_sCmdPool );
+   if( psEntry == NULL )
+   {
+      return( NULL );
+   }
+
+   psEntry->pnMsgHandler = NULL;
+   psEntry->pnSendError = NULL;
+   psEntry->psNext = NULL;
+   return( &psEntry->sMsg );
+}
+
+void APPL_CMDQ_SendCmdMsg( ABP_MsgType* psCmdMsg,
+                           ABCC_MsgHandlerFuncType pnMsgHandler,
+                           APPL_CMDQ_SendErrorFuncType pnSendError )
+{
+   /*
+   ** sMsg is the first member, so the message pointer is the entry pointer.
+   */
+   appl_CmdEntryType* psEntry = (appl_CmdEntryType*)psCmdMsg;
+
+   psEntry->pnMsgHandler = pnMsgHandler;
+   psEntry->pnSendError = pnSendError;
+   psEntry->psNext = NULL;
+
+   if( appl_psQueueTail == NULL )
+   {
+      appl_psQueueHead = psEntry;
+   }
+   else
+   {
+      appl_psQueueTail->psNext = psEntry;
+   }
+   appl_psQueueTail = psEntry;
+
+   appl_sCmdqStats.iQueued++;
+   if( appl_sCmdqStats.iQueued > appl_sCmdqStats.iQueuedHighWater )
+   {
+      appl_sCmdqStats.iQueuedHighWater = appl_sCmdqStats.iQueued;
+   }
+
+   /*
+   ** Try to pass it on right away so an idle driver does not add a cycle of
+   ** latency.
+   */
+   APPL_CMDQ_Run();
+}
+
+void APPL_CMDQ_Run( void )
+{
+   appl_CmdEntryType* psEntry;
+   ABP_MsgType*       psDrvMsg;
+   UINT16             iMsgSize;
+
+   while( appl_psQueueHead != NULL )
+   {
+      psDrvMsg = ABCC_GetCmdMsgBuffer();
+      if( psDrvMsg == NULL )
+      {
+         appl_sCmdqStats.lNumDriverFull++;
+         return;
+      }
+
+      psEntry = appl_psQueueHead;
+      appl_psQueueHead = psEntry->psNext;
+      if( appl_psQueueHead == NULL )
+      {
+         appl_psQueueTail = NULL;
+      }
+      appl_sCmdqStats.iQueued--;
+
+      /*
+      ** Only copy the part of the buffer that is in use.
+      */
+      iMsgSize = (UINT16)( sizeof( psEntry->sMsg.sHeader ) +
+                           ABCC_GetMsgDataSize( &psEntry->sMsg ) );
+      memcpy( psDrvMsg, &psEntry->sMsg, iMsgSize );
+
+      if( ABCC_SendCmdMsg( psDrvMsg, psEntry->pnMsgHandler ) == ABCC_EC_NO_ERROR )
+      {
+         appl_sCmdqStats.lNumSent++;
+      }
+      else
+      {
+         appl_sCmdqStats.lNumSendErrors++;
+         ABCC_LOG_WARNING( ABCC_EC_NO_RESOURCES,
+            (UINT32)ABCC_GetMsgSourceId( &psEntry->sMsg ),
+            "Queued command could not be sent\n" );
+         if( psEntry->pnSendError != NULL )
+         {
+            psEntry->pnSendError( &psEntry->sMsg );
+         }
+      }
+
+      HOST_MSG_POOL_Free( &appl_sCmdPool, psEntry );
+   }
+}
+
+void APPL_CMDQ_Flush( void )
+{
+   appl_CmdEntryType* psEntry;
+
+   while( appl_psQueueHead != NULL )
+   {
+      psEntry = appl_psQueueHead;
+      appl_psQueueHead = psEntry->psNext;
+      HOST_MSG_POOL_Free( &appl_sCmdPool, psEntry );
+      appl_sCmdqStats.lNumFlushed++;
+   }
+   appl_psQueueTail = NULL;
+   appl_sCmdqStats.iQueued = 0;
+}
+
+void APPL_CMDQ_GetStats( APPL_CMDQ_StatsType* psStats )
+{
+   *psStats = appl_sCmdqStats;
+   HOST_MSG_POOL_GetStats( &appl_sCmdPool, &psStats->sPool );
+}
+
+void APPL_CMDQ_PrintStats( void )
+{
+   APPL_CMDQ_StatsType sStats;
+
+   APPL_CMDQ_GetStats( &sStats );
+   printf( "Command queue:\n" );
+   printf( " - Pool in use/high water/depth: %u/%u/%u\n",
+           sStats.sPool.iInUse, sStats.sPool.iHighWaterMark, sStats.sPool.iDepth );
+   printf( " - Pool exhausted (rejected):    %lu\n", (unsigned long)sStats.sPool.lNumExhausted );
+   printf( " - Queued now/high water:        %u/%u\n", sStats.iQueued, sStats.iQueuedHighWater );
+   printf( " - Sent/send errors:             %lu/%lu\n",
+           (unsigned long)sStats.lNumSent, (unsigned long)sStats.lNumSendErrors );
+   printf( " - Driver queue full:            %lu\n", (unsigned long)sStats.lNumDriverFull );
+   printf( " - Flushed on restart:           %lu\n", (unsigned long)sStats.lNumFlushed );
+}
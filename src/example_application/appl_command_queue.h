@@ -0,0 +1,121 @@
+/*******************************************************************************
+** Copyright 2025-present HMS Industrial Networks AB.
+** Licensed under the MIT License.
+********************************************************************************
+** File Description:
+** Host side queue for application originated command messages. Commands are
+** built in pooled buffers and handed to the driver as soon as it has a free
+** command buffer, so bursts larger than ABCC_CFG_MAX_NUM_APPL_CMDS do not have
+** to be throttled by the application itself. The command batches in
+** appl_command_batch.h send through this queue.
+**
+** Queued commands have not reached the driver, so they survive a driver
+** restart unless APPL_CMDQ_Flush() is called. ABCC_API_CbfUserInit() does,
+** before the batches waiting for them are aborted.
+********************************************************************************
+*/
+
+#ifndef APPL_COMMAND_QUEUE_H_
+#define APPL_COMMAND_QUEUE_H_
+
+#include "abcc.h"
+#include "host_msg_pool.h"
+
+/*------------------------------------------------------------------------------
+** Queue statistics.
+**
+** sPool             - Statistics of the underlying buffer pool. Its
+**                     lNumExhausted counter is the number of commands the
+**                     application could not queue at all.
+** iQueued           - Number of commands waiting for a driver buffer.
+** iQueuedHighWater  - Highest value iQueued has reached.
+** lNumSent          - Number of commands handed over to the driver.
+** lNumSendErrors    - Number of commands rejected by ABCC_SendCmdMsg().
+** lNumDriverFull    - Number of times queued commands had to stay in the
+**                     queue because the driver had no free command buffer.
+** lNumFlushed       - Number of queued commands dropped by APPL_CMDQ_Flush().
+**------------------------------------------------------------------------------
+*/
+typedef struct APPL_CMDQ_StatsType
+{
+   HOST_MSG_POOL_StatsType sPool;
+   UINT16                  iQueued;
+   UINT16                  iQueuedHighWater;
+   UINT32                  lNumSent;
+   UINT32                  lNumSendErrors;
+   UINT32                  lNumDriverFull;
+   UINT32                  lNumFlushed;
+}
+APPL_CMDQ_StatsType;
+
+/*------------------------------------------------------------------------------
+** Called with a queued command that the driver rejected when it was handed
+** over. The response handler is not called for it. The message is freed when
+** the function returns.
+**------------------------------------------------------------------------------
+*/
+typedef void (*APPL_CMDQ_SendErrorFuncType)( const ABP_MsgType* psCmdMsg );
+
+/*------------------------------------------------------------------------------
+** APPL_CMDQ_Init()
+** Empties the queue and resets the statistics.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void APPL_CMDQ_Init( void );
+
+/*------------------------------------------------------------------------------
+** APPL_CMDQ_GetCmdMsgBuffer()
+** Takes a message buffer from the host pool. Counterpart of
+** ABCC_GetCmdMsgBuffer().
+**------------------------------------------------------------------------------
+** Outputs:
+**    Returns:    - Pointer to a message buffer, or NULL if all pooled buffers
+**                  are in use (backpressure, try again on a later cycle).
+**------------------------------------------------------------------------------
+*/
+EXTFUNC ABP_MsgType* APPL_CMDQ_GetCmdMsgBuffer( void );
+
+/*------------------------------------------------------------------------------
+** APPL_CMDQ_SendCmdMsg()
+** Queues a command built in a buffer from APPL_CMDQ_GetCmdMsgBuffer(). The
+** buffer is owned by the queue after this call. The header, including the
+** source ID, must be set up by the caller as for ABCC_SendCmdMsg().
+**------------------------------------------------------------------------------
+** Inputs:
+**    psCmdMsg     - Command message.
+**    pnMsgHandler - Response handler, forwarded to ABCC_SendCmdMsg().
+**    pnSendError  - Called if ABCC_SendCmdMsg() rejects the command. May be
+**                   NULL.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void APPL_CMDQ_SendCmdMsg( ABP_MsgType* psCmdMsg,
+                                   ABCC_MsgHandlerFuncType pnMsgHandler,
+                                   APPL_CMDQ_SendErrorFuncType pnSendError );
+
+/*------------------------------------------------------------------------------
+** APPL_CMDQ_Run()
+** Moves queued commands to the driver while it has free command buffers.
+** Called once per main loop iteration.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void APPL_CMDQ_Run( void );
+
+/*------------------------------------------------------------------------------
+** APPL_CMDQ_Flush()
+** Drops all queued commands without sending them and without calling their
+** handlers. Call when the driver restarts, the caller ends the commands it is
+** waiting for. The statistics are kept.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void APPL_CMDQ_Flush( void );
+
+/*------------------------------------------------------------------------------
+** APPL_CMDQ_GetStats()
+** APPL_CMDQ_PrintStats()
+** Reads or prints the queue statistics.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void APPL_CMDQ_GetStats( APPL_CMDQ_StatsType* psStats );
+EXTFUNC void APPL_CMDQ_PrintStats( void );
+
+#endif  /* inclusion lock */
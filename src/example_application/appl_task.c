@@ -0,0 +1,161 @@
+/*******************************************************************************
+** Copyright 2025-present HMS Industrial Networks AB.
+** Licensed under the MIT License.
+********************************************************************************
+** File Description:
+** Stackless tasks that wait for command responses.
+********************************************************************************
+*/
+
+#include "abcc.h"
+#include "host_msg_pool.h"
+#include "appl_task.h"
+
+static APPL_TASK_Type      appl_asTasks[ APPL_CFG_TASK_POOL_SIZE ];
+static UINT16              appl_aiTaskLinks[ APPL_CFG_TASK_POOL_SIZE ];
+static HOST_MSG_POOL_Type  appl_sTaskPool;
+static APPL_TASK_StatsType appl_sTaskStats;
+
+/*------------------------------------------------------------------------------
+** Completion callback of the one entry batch a task waits for.
+**------------------------------------------------------------------------------
+*/
+static void CmdDone( APPL_CMD_BATCH_Type* psBatch )
+{
+   ( (APPL_TASK_Type*)psBatch->pxContext )->fWaiting = FALSE;
+}
+
+void APPL_TASK_Init( void )
+{
+   HOST_MSG_POOL_Init( &appl_sTaskPool,
+                       appl_asTasks,
+                       appl_aiTaskLinks,
+                       (UINT16)sizeof( APPL_TASK_Type ),
+                       APPL_CFG_TASK_POOL_SIZE );
+
+   memset( appl_asTasks, 0, sizeof( appl_asTasks ) );
+   memset( &appl_sTaskStats, 0, sizeof( appl_sTaskStats ) );
+}
+
+BOOL APPL_TASK_Spawn( APPL_TASK_FuncType pnFunc, void* pxContext )
+{
+   APPL_TASK_Type*         psTask;
+   HOST_MSG_POOL_StatsType sPoolStats;
+
+   psTask = (APPL_TASK_Type*)HOST_MSG_POOL_Alloc( &appl_sTaskPool );
+   if( psTask == NULL )
+   {
+      appl_sTaskStats.lNumRejected++;
+      return( FALSE );
+   }
+
+   memset( psTask, 0, sizeof( *psTask ) );
+   psTask->pnFunc = pnFunc;
+   psTask->pxContext = pxContext;
+   psTask->fActive = TRUE;
+
+   appl_sTaskStats.lNumSpawned++;
+   HOST_MSG_POOL_GetStats( &appl_sTaskPool, &sPoolStats );
+   appl_sTaskStats.iHighWater = sPoolStats.iHighWaterMark;
+
+   return( TRUE );
+}
+
+void APPL_TASK_SendCmd( APPL_TASK_Type* psTask,
+                        UINT8 bObject,
+                        UINT16 iInstance,
+                        UINT8 bCmd,
+                        UINT8 bCmdExt0,
+                        const void* pxData,
+                        UINT16 iDataSize )
+{
+   APPL_CMD_BATCH_EntryType* psCmd = &psTask->sCmd;
+
+   appl_sTaskStats.lNumAwaits++;
+   memset( psCmd, 0, sizeof( *psCmd ) );
+   if( iDataSize > sizeof( psTask->abData ) )
+   {
+      psCmd->fError = TRUE;
+      return;
+   }
+
+   /*
+   ** The batch copies the request data when it sends the command, which may
+   ** be on a later cycle, after the task function has returned.
+   */
+   if( iDataSize > 0 )
+   {
+      memcpy( psTask->abData, pxData, iDataSize );
+   }
+   psCmd->bObject = bObject;
+   psCmd->iInstance = iInstance;
+   psCmd->bCmd = bCmd;
+   psCmd->bCmdExt0 = bCmdExt0;
+   psCmd->pxData = psTask->abData;
+   psCmd->iDataSize = iDataSize;
+   psCmd->pxResponse = psTask->abData;
+   psCmd->iResponseBufSize = (UINT16)sizeof( psTask->abData );
+
+   psTask->fWaiting = TRUE;
+   if( !APPL_CMD_BATCH_Start( &psTask->sBatch, psCmd, 1, 1, CmdDone, psTask ) )
+   {
+      psTask->fWaiting = FALSE;
+      psCmd->fError = TRUE;
+   }
+}
+
+void APPL_TASK_Run( void )
+{
+   APPL_TASK_Type* psTask;
+   UINT16          i;
+
+   for( i = 0; i < APPL_CFG_TASK_POOL_SIZE; i++ )
+   {
+      psTask = &appl_asTasks[ i ];
+      if( !psTask->fActive || psTask->fWaiting )
+      {
+         continue;
+      }
+
+      if( !psTask->pnFunc( psTask ) )
+      {
+         psTask->fActive = FALSE;
+         HOST_MSG_POOL_Free( &appl_sTaskPool, psTask );
+         appl_sTaskStats.lNumCompleted++;
+      }
+   }
+}
+
+void APPL_TASK_Reset( void )
+{
+   UINT16 i;
+
+   for( i = 0; i < APPL_CFG_TASK_POOL_SIZE; i++ )
+   {
+      if( appl_asTasks[ i ].fActive )
+      {
+         appl_asTasks[ i ].fActive = FALSE;
+         appl_asTasks[ i ].fWaiting = FALSE;
+         HOST_MSG_POOL_Free( &appl_sTaskPool, &appl_asTasks[ i ] );
+         appl_sTaskStats.lNumReset++;
+      }
+   }
+}
+
+void APPL_TASK_GetStats( APPL_TASK_StatsType* psStats )
+{
+   *psStats = appl_sTaskStats;
+}
+
+void APPL_TASK_PrintStats( void )
+{
+   printf( "Application tasks:\n" );
+   printf( " - Spawned/completed/rejected:   %lu/%lu/%lu\n",
+           (unsigned long)appl_sTaskStats.lNumSpawned,
+           (unsigned long)appl_sTaskStats.lNumCompleted,
+           (unsigned long)appl_sTaskStats.lNumRejected );
+   printf( " - Ended by a reset:             %lu\n", (unsigned long)appl_sTaskStats.lNumReset );
+   printf( " - Frames high water/pool:       %u/%u\n",
+           appl_sTaskStats.iHighWater, (UINT16)APPL_CFG_TASK_POOL_SIZE );
+   printf( " - Commands awaited:             %lu\n", (unsigned long)appl_sTaskStats.lNumAwaits );
+}
@@ -0,0 +1,223 @@
+/*******************************************************************************
+** Copyright 2025-present HMS Industrial Networks AB.
+** Licensed under the MIT License.
+********************************************************************************
+** File Description:
+** Stackless tasks that wait for command responses, for sequential
+** configuration logic without callback chains.
+**
+** A task is a function that is resumed where it left off. It waits for a
+** response with one statement, and the next statement runs once the
+** response is in:
+**
+**    static BOOL8 ReadPdSize( APPL_TASK_Type* psTask )
+**    {
+**       APPL_TASK_BEGIN( psTask );
+**       APPL_TASK_AWAIT_GET_ATTR( psTask, ABP_OBJ_NUM_NW, 1, ABP_NW_IA_READ_PD_SIZE );
+**       if( !APPL_TASK_CMD_FAILED( psTask ) )
+**       {
+**          ...use APPL_TASK_RESPONSE( psTask )...
+**       }
+**       APPL_TASK_END( psTask );
+**    }
+**
+** The tasks are driven from the main loop by APPL_TASK_Run(). There is no
+** thread per task and nothing is allocated per message: a task runs in a
+** frame from a fixed pool of APPL_CFG_TASK_POOL_SIZE, and each command is a
+** one entry batch of appl_command_batch.h. Tasks waiting at the same time
+** have their commands in flight at the same time.
+**
+** Rules, as the task function returns at every wait:
+**    - Local variables do not keep their values across a wait. Keep state
+**      in the context, see APPL_TASK_Spawn().
+**    - The task body must not contain a switch statement. Move it into a
+**      function.
+**    - The response of a wait is valid until the next wait.
+**
+** A driver restart loses the commands the tasks wait for. APPL_TASK_Reset()
+** then ends all tasks.
+********************************************************************************
+*/
+
+#ifndef APPL_TASK_H_
+#define APPL_TASK_H_
+
+#include "abcc.h"
+#include "appl_command_batch.h"
+
+struct APPL_TASK_Type;
+
+/*------------------------------------------------------------------------------
+** Task function. Returns TRUE while the task runs, FALSE when it is done.
+** APPL_TASK_BEGIN() and APPL_TASK_END() take care of the return values.
+**------------------------------------------------------------------------------
+*/
+typedef BOOL8 (*APPL_TASK_FuncType)( struct APPL_TASK_Type* psTask );
+
+/*------------------------------------------------------------------------------
+** Task frame. pxContext is for the task, the rest is used by the macros.
+** abData holds the request data until the command is sent, then the
+** response data.
+**------------------------------------------------------------------------------
+*/
+typedef struct APPL_TASK_Type
+{
+   APPL_TASK_FuncType       pnFunc;
+   void*                    pxContext;
+   UINT16                   iResumePoint;
+   BOOL8                    fActive;
+   BOOL8                    fWaiting;
+   APPL_CMD_BATCH_Type      sBatch;
+   APPL_CMD_BATCH_EntryType sCmd;
+   UINT8                    abData[ APPL_CFG_TASK_RESPONSE_SIZE ];
+}
+APPL_TASK_Type;
+
+/*------------------------------------------------------------------------------
+** Task statistics.
+**
+** lNumSpawned    - Number of tasks started.
+** lNumCompleted  - Number of tasks that have ended.
+** lNumRejected   - Number of tasks not started because all frames were in
+**                  use.
+** lNumReset      - Number of tasks ended by APPL_TASK_Reset().
+** lNumAwaits     - Number of commands waited for.
+** iHighWater     - Highest number of frames in use at once.
+**------------------------------------------------------------------------------
+*/
+typedef struct APPL_TASK_StatsType
+{
+   UINT32 lNumSpawned;
+   UINT32 lNumCompleted;
+   UINT32 lNumRejected;
+   UINT32 lNumReset;
+   UINT32 lNumAwaits;
+   UINT16 iHighWater;
+}
+APPL_TASK_StatsType;
+
+/*------------------------------------------------------------------------------
+** APPL_TASK_BEGIN()
+** APPL_TASK_END()
+** First and last statement of a task function.
+**------------------------------------------------------------------------------
+*/
+#define APPL_TASK_BEGIN( psTask )                                               \
+   switch( (psTask)->iResumePoint )                                             \
+   {                                                                            \
+   case 0:
+
+#define APPL_TASK_END( psTask )                                                 \
+   }                                                                            \
+   (psTask)->iResumePoint = 0;                                                  \
+   return( FALSE )
+
+/*------------------------------------------------------------------------------
+** APPL_TASK_AWAIT_CMD()
+** APPL_TASK_AWAIT_GET_ATTR()
+** Sends a command and resumes the task with the next statement once the
+** response is in. The request data is copied into the frame, so it may be
+** a local variable. Requests larger than APPL_CFG_TASK_RESPONSE_SIZE fail.
+**------------------------------------------------------------------------------
+*/
+#define APPL_TASK_AWAIT_CMD( psTask, bObject, iInstance, bCmd, bCmdExt0, pxData, iDataSize ) \
+   do                                                                           \
+   {                                                                            \
+      APPL_TASK_SendCmd( psTask, bObject, iInstance, bCmd, bCmdExt0, pxData, iDataSize ); \
+      (psTask)->iResumePoint = __LINE__;                                        \
+      return( TRUE );                                                           \
+   case __LINE__:;                                                              \
+   }                                                                            \
+   while( 0 )
+
+#define APPL_TASK_AWAIT_GET_ATTR( psTask, bObject, iInstance, bAttribute )      \
+   APPL_TASK_AWAIT_CMD( psTask, bObject, iInstance, ABP_CMD_GET_ATTR, bAttribute, NULL, 0 )
+
+/*------------------------------------------------------------------------------
+** APPL_TASK_YIELD()
+** Lets the other tasks and the main loop run, and resumes the task on the
+** next APPL_TASK_Run().
+**------------------------------------------------------------------------------
+*/
+#define APPL_TASK_YIELD( psTask )                                               \
+   do                                                                           \
+   {                                                                            \
+      (psTask)->iResumePoint = __LINE__;                                        \
+      return( TRUE );                                                           \
+   case __LINE__:;                                                              \
+   }                                                                            \
+   while( 0 )
+
+/*------------------------------------------------------------------------------
+** Result of the last wait: TRUE on an error response or if the command could
+** not be sent, the response data, and its size. For an error response the
+** error code is the first response byte.
+**------------------------------------------------------------------------------
+*/
+#define APPL_TASK_CMD_FAILED( psTask )             ( (psTask)->sCmd.fError )
+#define APPL_TASK_RESPONSE( psTask )               ( (psTask)->abData )
+#define APPL_TASK_RESPONSE_SIZE( psTask )          ( (psTask)->sCmd.iResponseSize )
+
+/*------------------------------------------------------------------------------
+** APPL_TASK_Init()
+** Ends all tasks without running them further and resets the statistics.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void APPL_TASK_Init( void );
+
+/*------------------------------------------------------------------------------
+** APPL_TASK_Spawn()
+** Starts a task. It first runs on the next APPL_TASK_Run().
+**------------------------------------------------------------------------------
+** Inputs:
+**    pnFunc      - Task function.
+**    pxContext   - Task state, available as psTask->pxContext. It must stay
+**                  valid until the task ends.
+**
+** Outputs:
+**    Returns:    - FALSE if all frames are in use (backpressure, try again on
+**                  a later cycle).
+**------------------------------------------------------------------------------
+*/
+EXTFUNC BOOL APPL_TASK_Spawn( APPL_TASK_FuncType pnFunc, void* pxContext );
+
+/*------------------------------------------------------------------------------
+** APPL_TASK_SendCmd()
+** Used by APPL_TASK_AWAIT_CMD(), not to be called directly.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void APPL_TASK_SendCmd( APPL_TASK_Type* psTask,
+                                UINT8 bObject,
+                                UINT16 iInstance,
+                                UINT8 bCmd,
+                                UINT8 bCmdExt0,
+                                const void* pxData,
+                                UINT16 iDataSize );
+
+/*------------------------------------------------------------------------------
+** APPL_TASK_Run()
+** Resumes every task that is not waiting for a response. Call once per main
+** loop iteration, after APPL_CMD_BATCH_Run().
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void APPL_TASK_Run( void );
+
+/*------------------------------------------------------------------------------
+** APPL_TASK_Reset()
+** Ends all tasks without running them further and frees their frames. Call
+** when the driver restarts, after APPL_CMD_BATCH_Abort() has ended the
+** batches of the waiting tasks.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void APPL_TASK_Reset( void );
+
+/*------------------------------------------------------------------------------
+** APPL_TASK_GetStats()
+** APPL_TASK_PrintStats()
+** Reads or prints the task statistics.
+**------------------------------------------------------------------------------
+*/
+EXTFUNC void APPL_TASK_GetStats( APPL_TASK_StatsType* psStats );
+EXTFUNC void APPL_TASK_PrintStats( void );
+
+#endif  /* inclusion lock */
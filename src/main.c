@@ -15,6 +15,8 @@
 
 #include "windows.h"
 #include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
 #include "conio.h"
 
 #include "abcc.h"
@@ -22,26 +24,333 @@
 #include "abcc_hardware_abstraction.h"
 #include "abcc_types.h"
 #include "abcc_api.h"
+#include "host_time.h"
+#include "appl_command_queue.h"
+#include "appl_command_batch.h"
+#include "appl_task.h"
+#include "abcc_network_data_parameters.h"
+#include "appl_adi_table.h"
+#include "host_scheduler.h"
+#include "host_control.h"
+#include "host_jitter.h"
+#include "host_pd_capture.h"
+#include "host_image.h"
+#include "host_wait.h"
+#include "host_fault.h"
+#include "host_serial_rx.h"
+#include "host_timer.h"
+#include "host_trace.h"
+#include "host_boot.h"
+#include "host_pd_buffer.h"
+#include "host_memory.h"
+#include "host_budget.h"
 
 extern void TP_Shutdown( void );
 extern void TP_vSetPathId( UINT32 lValue );
+extern void TP_vSetParallelVerifyMode( UINT8 bMode );
+extern void TP_PrintParallelReadStats( void );
+extern void TP_PrintLockStats( void );
+extern void TP_GetTransferCounts( UINT32* plTransfers, UINT32* plErrors );
+
+/*------------------------------------------------------------------------------
+** Interval between consecutive ABCC_API_Run() calls.
+**------------------------------------------------------------------------------
+*/
+static HOST_JITTER_Type main_sRunJitter;
+
+/*------------------------------------------------------------------------------
+** Time base of the driver and application timers.
+**------------------------------------------------------------------------------
+*/
+static UINT64           main_llTimerBaseUs;
+static UINT32           main_lTimerRemainderUs;
+
+/*------------------------------------------------------------------------------
+** TRUE once the network object has been read after the last driver start.
+** Cleared on every start, see ABCC_API_CbfUserInit().
+**------------------------------------------------------------------------------
+*/
+static BOOL8            main_fNetworkUp = FALSE;
+
+/*------------------------------------------------------------------------------
+** File the trace is dumped to on request and at exit, NULL if not tracing.
+**------------------------------------------------------------------------------
+*/
+static const char*      main_pacTraceFile = NULL;
+
+/*------------------------------------------------------------------------------
+** PrintStatistics()
+** Prints the statistics collected by the host side modules.
+**------------------------------------------------------------------------------
+*/
+void PrintStatistics( void )
+{
+   printf( "\n-------------------------------------------------\n" );
+   APPL_CMDQ_PrintStats();
+   APPL_CMD_BATCH_PrintStats();
+   APPL_TASK_PrintStats();
+   HOST_SCHED_PrintStats();
+   HOST_TIMER_PrintStats();
+   HOST_WAIT_PrintStats();
+   TP_PrintParallelReadStats();
+   TP_PrintLockStats();
+   HOST_SERIAL_RX_PrintStats();
+   HOST_FAULT_PrintStats();
+   HOST_TRACE_PrintStats();
+   HOST_BOOT_PrintStats();
+   HOST_MEMORY_PrintStats();
+   HOST_BUDGET_PrintStats();
+   HOST_JITTER_PrintHeader();
+   HOST_JITTER_PrintStats( &main_sRunJitter );
+   APPL_ControlLoopPrintJitter();
+   printf( "-------------------------------------------------\n\n" );
+}
+
+#if( APPL_CFG_HOST_PERF_ADIS_ENABLED )
+/*------------------------------------------------------------------------------
+** UpdateHostPerf()
+** Timer callback that refreshes the host performance ADIs.
+**------------------------------------------------------------------------------
+*/
+static HOST_TIMER_Type main_sHostPerfTimer;
+
+static void UpdateHostPerf( void* pxContext )
+{
+   static UINT32            lLastLoops = 0;
+   static UINT32            lLastTransfers = 0;
+   APPL_CMD_BATCH_StatsType sBatchStats;
+   UINT32                   lTransfers;
+   UINT32                   lErrors;
+
+   (void)pxContext;
+
+   if( HOST_BUDGET_IsShedding() )
+   {
+      return;
+   }
+
+   TP_GetTransferCounts( &lTransfers, &lErrors );
+   APPL_CMD_BATCH_GetStats( &sBatchStats );
+
+   APPL_sHostPerf.lLoopCount = main_sRunJitter.lCount;
+   APPL_sHostPerf.lCycleP99Us = HOST_JITTER_Percentile( &main_sRunJitter, 990 );
+   APPL_sHostPerf.lCycleMaxUs = main_sRunJitter.lMaxUs;
+   APPL_sHostPerf.lHalErrors = lErrors;
+   APPL_sHostPerf.iCmdQueueDepth = sBatchStats.iInFlight;
+   if( main_sRunJitter.lCount != lLastLoops )
+   {
+      APPL_sHostPerf.rTransfersPerCycle = (FLOAT32)( lTransfers - lLastTransfers ) /
+                                          (FLOAT32)( main_sRunJitter.lCount - lLastLoops );
+   }
+
+   lLastLoops = main_sRunJitter.lCount;
+   lLastTransfers = lTransfers;
+}
+#endif
+
+/*------------------------------------------------------------------------------
+** SampleMemoryFaults()
+** Timer callback that counts the page faults taken in PROCESS_ACTIVE.
+**------------------------------------------------------------------------------
+*/
+static HOST_TIMER_Type main_sMemoryTimer;
+
+static void SampleMemoryFaults( void* pxContext )
+{
+   (void)pxContext;
+
+   if( HOST_BUDGET_IsShedding() )
+   {
+      return;
+   }
+   HOST_MEMORY_SampleFaults( ABCC_API_AnbState() == ABP_ANB_STATE_PROCESS_ACTIVE );
+}
+
+/*------------------------------------------------------------------------------
+** Batch comparison, --cmd-batch. The network object attributes are read over
+** and over, first one command at a time and then pipelined, and the two
+** results are printed.
+**------------------------------------------------------------------------------
+*/
+#define MAIN_BATCH_MAX_COMMANDS                    ( 256 )
+#define MAIN_BATCH_RESPONSE_SIZE                   ( 64 )
+
+static const UINT8 main_abBatchAttributes[] =
+{
+   ABP_NW_IA_NW_TYPE,
+   ABP_NW_IA_NW_TYPE_STR,
+   ABP_NW_IA_DATA_FORMAT,
+   ABP_NW_IA_PARAM_SUPPORT,
+   ABP_NW_IA_WRITE_PD_SIZE,
+   ABP_NW_IA_READ_PD_SIZE
+};
+
+static APPL_CMD_BATCH_EntryType main_asBatchEntries[ MAIN_BATCH_MAX_COMMANDS ];
+static UINT8                    main_aabBatchResponses[ MAIN_BATCH_MAX_COMMANDS ][ MAIN_BATCH_RESPONSE_SIZE ];
+static APPL_CMD_BATCH_Type      main_sBatch;
+
+static void BatchComparisonDone( APPL_CMD_BATCH_Type* psBatch )
+{
+   printf( "%s batch: %u commands in %luus, %u errors%s\n",
+           psBatch->iWindow == 1 ? "Sequential" : "Pipelined",
+           psBatch->iNumEntries,
+           (unsigned long)psBatch->lTimeUs,
+           psBatch->iNumErrors,
+           psBatch->fAborted ? ", aborted" : "" );
+
+   /*
+   ** An aborted comparison runs again when the network is up after the
+   ** restart.
+   */
+   if( psBatch->fAborted )
+   {
+      return;
+   }
+
+   if( psBatch->iWindow == 1 )
+   {
+      APPL_CMD_BATCH_Start( psBatch,
+                            psBatch->pasEntries,
+                            psBatch->iNumEntries,
+                            0,
+                            BatchComparisonDone,
+                            NULL );
+   }
+   else
+   {
+      APPL_CMD_BATCH_PrintStats();
+   }
+}
+
+static void StartBatchComparison( UINT16 iNumCommands )
+{
+   APPL_CMD_BATCH_EntryType* psEntry;
+   UINT16                    i;
+
+   for( i = 0; i < iNumCommands; i++ )
+   {
+      psEntry = &main_asBatchEntries[ i ];
+      memset( psEntry, 0, sizeof( *psEntry ) );
+      psEntry->bObject = ABP_OBJ_NUM_NW;
+      psEntry->iInstance = 1;
+      psEntry->bCmd = ABP_CMD_GET_ATTR;
+      psEntry->bCmdExt0 = main_abBatchAttributes[ i % sizeof( main_abBatchAttributes ) ];
+      psEntry->pxResponse = main_aabBatchResponses[ i ];
+      psEntry->iResponseBufSize = MAIN_BATCH_RESPONSE_SIZE;
+   }
+
+   APPL_CMD_BATCH_Start( &main_sBatch, main_asBatchEntries, iNumCommands, 1, BatchComparisonDone, NULL );
+}
+
+/*------------------------------------------------------------------------------
+** NetworkInfoTask()
+** Reads and prints the network type and the process data sizes the network
+** has set up, one attribute after the other. See appl_task.h.
+**------------------------------------------------------------------------------
+*/
+typedef struct main_NetworkInfoType
+{
+   UINT16 iNwType;
+   UINT16 iReadPdSize;
+   UINT16 iWritePdSize;
+}
+main_NetworkInfoType;
+
+static main_NetworkInfoType main_sNetworkInfo;
+
+/*
+** The attributes are little endian UINT16, as is the host. 0 if the read
+** failed.
+*/
+static UINT16 TaskResponseUint16( APPL_TASK_Type* psTask )
+{
+   UINT16 iValue = 0;
+
+   if( !APPL_TASK_CMD_FAILED( psTask ) && ( APPL_TASK_RESPONSE_SIZE( psTask ) == sizeof( iValue ) ) )
+   {
+      memcpy( &iValue, APPL_TASK_RESPONSE( psTask ), sizeof( iValue ) );
+   }
+   return( iValue );
+}
+
+static BOOL8 NetworkInfoTask( APPL_TASK_Type* psTask )
+{
+   main_NetworkInfoType* psInfo = (main_NetworkInfoType*)psTask->pxContext;
+
+   APPL_TASK_BEGIN( psTask );
+
+   APPL_TASK_AWAIT_GET_ATTR( psTask, ABP_OBJ_NUM_NW, 1, ABP_NW_IA_NW_TYPE );
+   psInfo->iNwType = TaskResponseUint16( psTask );
+
+   APPL_TASK_AWAIT_GET_ATTR( psTask, ABP_OBJ_NUM_NW, 1, ABP_NW_IA_READ_PD_SIZE );
+   psInfo->iReadPdSize = TaskResponseUint16( psTask );
+
+   APPL_TASK_AWAIT_GET_ATTR( psTask, ABP_OBJ_NUM_NW, 1, ABP_NW_IA_WRITE_PD_SIZE );
+   psInfo->iWritePdSize = TaskResponseUint16( psTask );
+
+   printf( "Network type 0x%X, read process data %u bytes, write process data %u bytes\n",
+           psInfo->iNwType, psInfo->iReadPdSize, psInfo->iWritePdSize );
+
+   APPL_TASK_END( psTask );
+}
+
+/*------------------------------------------------------------------------------
+** RunTimers()
+** Gives the time since the previous call to the driver timers and the
+** application timer wheel.
+**------------------------------------------------------------------------------
+*/
+static void RunTimers( void )
+{
+   UINT64 llNowUs;
+   UINT64 llDeltaUs;
+   UINT64 llDeltaMs;
+
+   llNowUs = HOST_TIME_GetUs();
+   llDeltaUs = llNowUs - main_llTimerBaseUs;
+   main_llTimerBaseUs = llNowUs;
+
+   /*
+   ** The driver counts whole milliseconds. Carry the rest over to the next
+   ** call so that its timers do not drift. Intervals are truncated to 65535ms
+   ** because 'ABCC_API_RunTimerSystem()' takes a UINT16.
+   */
+   llDeltaMs = ( llDeltaUs + main_lTimerRemainderUs ) / 1000;
+   main_lTimerRemainderUs = (UINT32)( ( llDeltaUs + main_lTimerRemainderUs ) % 1000 );
+   if( llDeltaMs > (UINT16)0xFFFF )
+   {
+      llDeltaMs = (UINT16)0xFFFF;
+   }
+   if( llDeltaMs > 0 )
+   {
+      /*
+      ** Provide the abcc-api with a time base. Required for timers to function.
+      */
+      ABCC_API_RunTimerSystem( (UINT16)llDeltaMs );
+   }
+
+   HOST_TIMER_Advance( llDeltaUs > 0xFFFFFFFFUL ? 0xFFFFFFFFUL : (UINT32)llDeltaUs );
+}
 
 /*------------------------------------------------------------------------------
 ** RunUi()
-** This function handles the user interface.
-** Returns TRUE is the user have pressed the Q key.
+** This function handles the user interface. A key press is turned into the
+** same request as from the control pipe, so that the main loop handles both
+** alike.
 **------------------------------------------------------------------------------
 ** Inputs:
 **    -
 **
 ** Outputs:
-**    Returns:    - TRUE if user have pressed the "Q" key.
+**    Returns:    - HOST_CONTROL_REQ_QUIT for the "Q" key,
+**                  HOST_CONTROL_REQ_STATS for "S", HOST_CONTROL_REQ_TRACE
+**                  for "T", otherwise 0.
 **
 ** Usage:
-**    fQuit = RunUi();
+**    lRequests |= RunUi();
 **------------------------------------------------------------------------------
 */
-BOOL8 RunUi( void )
+UINT32 RunUi( void )
 {
    static char   abUserInput;
    BOOL8         fKbInput = FALSE;
@@ -57,10 +366,22 @@ BOOL8 RunUi( void )
          /*
          ** Q is for quit.
          */
-         return( TRUE );
+         return( HOST_CONTROL_REQ_QUIT );
+      }
+
+      if( ( abUserInput == 's' ) ||
+          ( abUserInput == 'S' ) )
+      {
+         return( HOST_CONTROL_REQ_STATS );
+      }
+
+      if( ( abUserInput == 't' ) ||
+          ( abUserInput == 'T' ) )
+      {
+         return( HOST_CONTROL_REQ_TRACE );
       }
    }
-   return( FALSE );
+   return( 0 );
 } /* End of RunUi() */
 
 /*------------------------------------------------------------------------------
@@ -74,6 +395,18 @@ void ABCC_API_CbfUserInit( ABCC_API_NetworkType iNetworkType, ABCC_API_FwVersion
    printf( "\nABCC_API_CbfUserInit() entered.\n" );
    printf( " - Network type:     0x%X\n", iNetworkType );
    printf( " - Firmware version: %u.%u.%u\n", iFirmwareVersion.bMajor, iFirmwareVersion.bMinor, iFirmwareVersion.bBuild );
+   HOST_BOOT_Mark( HOST_BOOT_USER_INIT );
+
+   /*
+   ** Every start and restart of the driver passes here. Commands sent before
+   ** a restart are lost with it, so drop the ones still queued, end the
+   ** batches and tasks waiting for them and read the network object again
+   ** once the ABCC is back up.
+   */
+   APPL_CMDQ_Flush();
+   APPL_CMD_BATCH_Abort();
+   APPL_TASK_Reset();
+   main_fNetworkUp = FALSE;
    printf( "Now calling ABCC_API_UserInitComplete() to progress from SETUP state to NW_INIT.\n\n" );
    ABCC_API_UserInitComplete();
    return;
@@ -96,12 +429,184 @@ void printReadableTime( DWORD ms ) {
     printf("%02uh %02um %02u.%03us", hours, minutes, seconds, milliseconds);
 }
 
+/*------------------------------------------------------------------------------
+** Command line options.
+**------------------------------------------------------------------------------
+*/
+typedef struct main_OptionsType
+{
+   BOOL8                          fHeadless;
+   const char*                    pacJitterCsvFile;
+   const char*                    pacPdCaptureFile;
+   UINT32                         lPeriodUs;
+   UINT32                         lSpinUs;
+   const HOST_FAULT_ScenarioType* psFaultScenario;
+   UINT32                         lFaultRepetitions;
+   const char*                    pacTraceFile;
+   const char*                    pacBootReportFile;
+   UINT32                         lBudgetUs;
+   UINT16                         iBatchCommands;
+}
+main_OptionsType;
+
+/*------------------------------------------------------------------------------
+** ParseArguments()
+** Handles the command line.
+**    --headless   Run without console interaction. Use Ctrl+C, a console close
+**                 or the control pipe to stop the application.
+**    --path <id>  Transport Provider Path ID to use instead of asking the
+**                 user. Needed in headless mode.
+**    --jitter-csv <file>
+**                 Stream every measured cycle interval to a CSV file.
+**    --pd-capture <file>
+**                 Record every process data image to a ring file.
+**    --period <us>
+**                 Main loop period, HOST_CFG_CYCLE_PERIOD_US by default.
+**    --spin <us>  Time before each cycle deadline spent spinning instead of
+**                 sleeping, HOST_CFG_CYCLE_SPIN_US by default. Trades CPU
+**                 time for tighter cycle timing, see host_wait.h.
+**    --verify-reads off|selective|all
+**                 Which parallel reads are verified, see
+**                 HOST_CFG_PAR_VERIFY_MODE.
+**    --fault <scenario>[:<count>]
+**                 Inject a fault <count> times (default 1) and report how
+**                 long the driver takes to get back to PROCESS_ACTIVE.
+**    --trace <file>
+**                 Record a timeline of the driver, HAL and application
+**                 activity. It is written to <file> on the 'T' key, the
+**                 "trace" control command and at exit.
+**    --budget <us>
+**                 Time budget for ABCC_API_Run() per cycle, by default
+**                 HOST_CFG_BUDGET_PERCENT of the period. Cycles over it
+**                 defer non-critical work, see host_budget.h.
+**    --boot-report <file>
+**                 Append the timing of every boot, up to PROCESS_ACTIVE, to
+**                 <file> as one JSON line per boot.
+**    --cmd-batch <count>
+**                 Once the ABCC is up, read <count> network object attributes
+**                 one at a time and then pipelined, and print both
+**                 throughputs. At most MAIN_BATCH_MAX_COMMANDS.
+**------------------------------------------------------------------------------
+** Outputs:
+**    psOptions   - Selected options.
+**    Returns:    - FALSE if the command line was invalid.
+**------------------------------------------------------------------------------
+*/
+static BOOL8 ParseArguments( int argc, char* argv[], main_OptionsType* psOptions )
+{
+   int   i;
+   char* pcCount;
+
+   memset( psOptions, 0, sizeof( *psOptions ) );
+   psOptions->lPeriodUs = HOST_CFG_CYCLE_PERIOD_US;
+   psOptions->lSpinUs = HOST_CFG_CYCLE_SPIN_US;
+   for( i = 1; i < argc; i++ )
+   {
+      if( strcmp( argv[ i ], "--headless" ) == 0 )
+      {
+         psOptions->fHeadless = TRUE;
+      }
+      else if( ( strcmp( argv[ i ], "--path" ) == 0 ) && ( i + 1 < argc ) )
+      {
+         TP_vSetPathId( (UINT32)strtoul( argv[ ++i ], NULL, 0 ) );
+      }
+      else if( ( strcmp( argv[ i ], "--jitter-csv" ) == 0 ) && ( i + 1 < argc ) )
+      {
+         psOptions->pacJitterCsvFile = argv[ ++i ];
+      }
+      else if( ( strcmp( argv[ i ], "--pd-capture" ) == 0 ) && ( i + 1 < argc ) )
+      {
+         psOptions->pacPdCaptureFile = argv[ ++i ];
+      }
+      else if( ( strcmp( argv[ i ], "--period" ) == 0 ) && ( i + 1 < argc ) )
+      {
+         psOptions->lPeriodUs = (UINT32)strtoul( argv[ ++i ], NULL, 0 );
+      }
+      else if( ( strcmp( argv[ i ], "--spin" ) == 0 ) && ( i + 1 < argc ) )
+      {
+         psOptions->lSpinUs = (UINT32)strtoul( argv[ ++i ], NULL, 0 );
+      }
+      else if( ( strcmp( argv[ i ], "--verify-reads" ) == 0 ) && ( i + 1 < argc ) )
+      {
+         i++;
+         if( strcmp( argv[ i ], "off" ) == 0 )
+         {
+            TP_vSetParallelVerifyMode( HOST_CFG_PAR_VERIFY_OFF );
+         }
+         else if( strcmp( argv[ i ], "selective" ) == 0 )
+         {
+            TP_vSetParallelVerifyMode( HOST_CFG_PAR_VERIFY_SELECTIVE );
+         }
+         else if( strcmp( argv[ i ], "all" ) == 0 )
+         {
+            TP_vSetParallelVerifyMode( HOST_CFG_PAR_VERIFY_ALL );
+         }
+         else
+         {
+            return( FALSE );
+         }
+      }
+      else if( ( strcmp( argv[ i ], "--fault" ) == 0 ) && ( i + 1 < argc ) )
+      {
+         pcCount = strchr( argv[ ++i ], ':' );
+         psOptions->lFaultRepetitions = 1;
+         if( pcCount != NULL )
+         {
+            *pcCount++ = '\0';
+            psOptions->lFaultRepetitions = (UINT32)strtoul( pcCount, NULL, 0 );
+         }
+         psOptions->psFaultScenario = HOST_FAULT_FindScenario( argv[ i ] );
+         if( ( psOptions->psFaultScenario == NULL ) ||
+             ( psOptions->lFaultRepetitions == 0 ) ||
+             ( psOptions->lFaultRepetitions > HOST_CFG_FAULT_MAX_REPETITIONS ) )
+         {
+            HOST_FAULT_PrintScenarios();
+            return( FALSE );
+         }
+      }
+#if( HOST_CFG_TRACE_ENABLED )
+      else if( ( strcmp( argv[ i ], "--trace" ) == 0 ) && ( i + 1 < argc ) )
+      {
+         psOptions->pacTraceFile = argv[ ++i ];
+      }
+#endif
+      else if( ( strcmp( argv[ i ], "--budget" ) == 0 ) && ( i + 1 < argc ) )
+      {
+         psOptions->lBudgetUs = (UINT32)strtoul( argv[ ++i ], NULL, 0 );
+      }
+      else if( ( strcmp( argv[ i ], "--boot-report" ) == 0 ) && ( i + 1 < argc ) )
+      {
+         psOptions->pacBootReportFile = argv[ ++i ];
+      }
+      else if( ( strcmp( argv[ i ], "--cmd-batch" ) == 0 ) && ( i + 1 < argc ) )
+      {
+         psOptions->iBatchCommands = (UINT16)strtoul( argv[ ++i ], NULL, 0 );
+         if( ( psOptions->iBatchCommands == 0 ) ||
+             ( psOptions->iBatchCommands > MAIN_BATCH_MAX_COMMANDS ) )
+         {
+            return( FALSE );
+         }
+      }
+      else
+      {
+         return( FALSE );
+      }
+   }
+
+   if( psOptions->lBudgetUs == 0 )
+   {
+      psOptions->lBudgetUs = (UINT32)( (UINT64)psOptions->lPeriodUs * HOST_CFG_BUDGET_PERCENT / 100 );
+   }
+
+   return( psOptions->lPeriodUs > 0 );
+}
+
 /*------------------------------------------------------------------------------
 ** main()
 ** Initializes the driver and runs the main loop.
 **------------------------------------------------------------------------------
 */
-int main( void )
+int main( int argc, char* argv[] )
 {
    /*
    ** Note: Make sure the ABCC reset signal is kept low by the platform specific
@@ -110,9 +615,19 @@ int main( void )
    */
 
    BOOL8          fQuit = FALSE;
+   main_OptionsType sOptions;
+   UINT32         lRequests = 0;
    ABCC_ErrorCodeType eErrorCode = ABCC_EC_NO_ERROR;
-   const UINT16   iSleepTimeMS = 10;
-   DWORD          lThen, lNow, lDiff;
+   ABP_AnbStateType eAnbState;
+   ABP_AnbStateType eLastAnbState = (ABP_AnbStateType)0xFF;
+   UINT64         llNowUs;
+   UINT64         llTraceNs;
+   UINT64         llRunStartUs;
+   BOOL8          fShedding;
+#if( HOST_CFG_TRACE_OVERRUN_FACTOR > 0 )
+   UINT64         llLastRunUs = 0;
+   BOOL8          fOverrunTraced = FALSE;
+#endif
 
 #if( _DEBUG )
    /*
@@ -127,6 +642,14 @@ int main( void )
    TP_vSetPathId( 0 );
 #endif
 
+   if( !ParseArguments( argc, argv, &sOptions ) )
+   {
+      printf( "Usage: %s [--headless] [--path <id>] [--jitter-csv <file>] [--pd-capture <file>] [--period <us>]\n"
+              "       [--spin <us>] [--verify-reads off|selective|all] [--fault <scenario>[:<count>]]\n"
+              "       [--trace <file>] [--budget <us>] [--boot-report <file>] [--cmd-batch <count>]\n",
+              argv[ 0 ] );
+      return( 1 );
+   }
 
    printf( "-------------------------------------------------\n" );
    printf( "Program started at: " );
@@ -136,7 +659,106 @@ int main( void )
    printf( "HMS Networks\n" );
    printf( "Anybus CompactCom Starter Kit\n" );
    printf( "Windows example port\n\n" );
-   printf( "Press 'Q' to quit.\n\n" );
+   if( sOptions.fHeadless )
+   {
+      printf( "Headless mode, control pipe: %s\n\n", HOST_CFG_CONTROL_PIPE_NAME );
+   }
+   else
+   {
+      printf( "Press 'Q' to quit.\n" );
+      printf( "Press 'S' to print statistics.\n" );
+      if( sOptions.pacTraceFile != NULL )
+      {
+         printf( "Press 'T' to write the trace.\n" );
+      }
+      printf( "\n" );
+   }
+
+   /*
+   ** The console control handler is installed in both modes so that Ctrl+C
+   ** shuts the driver down cleanly. The control pipe is only needed when there
+   ** is no keyboard.
+   */
+   if( !HOST_CONTROL_Start( sOptions.fHeadless ? HOST_CFG_CONTROL_PIPE_NAME : NULL ) )
+   {
+      return( 1 );
+   }
+
+   HOST_TIME_Init();
+   HOST_TRACE_NameThread( "main" );
+   if( sOptions.pacTraceFile != NULL )
+   {
+      main_pacTraceFile = sOptions.pacTraceFile;
+      HOST_TRACE_Start();
+   }
+   HOST_JITTER_Init( &main_sRunJitter, "api run", sOptions.lPeriodUs );
+   if( ( sOptions.pacJitterCsvFile != NULL ) && !HOST_JITTER_OpenCsv( sOptions.pacJitterCsvFile ) )
+   {
+      printf( "Could not create %s\n", sOptions.pacJitterCsvFile );
+      HOST_CONTROL_Stop();
+      return( 1 );
+   }
+
+   /*
+   ** The process data buffers are sized from the default map, generated at
+   ** build time with the ADI tables.
+   */
+   if( !HOST_PD_BUFFER_Init( APPL_ADI_iReadPdSize, APPL_ADI_iWritePdSize ) )
+   {
+      HOST_JITTER_CloseCsv();
+      HOST_CONTROL_Stop();
+      return( 1 );
+   }
+
+   /*
+   ** A capture slot holds the larger of the two process data buffers. The
+   ** HAL rejects transfers longer than their buffer, so no image is cut, and
+   ** each record keeps the length of its own transfer.
+   */
+   if( ( sOptions.pacPdCaptureFile != NULL ) &&
+       !HOST_PD_CAPTURE_Open( sOptions.pacPdCaptureFile,
+                              HOST_CFG_PD_CAPTURE_NUM_RECORDS,
+                              HOST_PD_BUFFER_ReadSize() > HOST_PD_BUFFER_WriteSize() ?
+                              HOST_PD_BUFFER_ReadSize() : HOST_PD_BUFFER_WriteSize() ) )
+   {
+      HOST_PD_BUFFER_Close();
+      HOST_JITTER_CloseCsv();
+      HOST_CONTROL_Stop();
+      return( 1 );
+   }
+   APPL_CMDQ_Init();
+   APPL_CMD_BATCH_Init();
+   APPL_TASK_Init();
+   APPL_ControlLoopInit( sOptions.lPeriodUs );
+
+   /*
+   ** The process image is optional, run without it if it cannot be created.
+   */
+   HOST_IMAGE_Open( HOST_CFG_IMAGE_NAME );
+
+   /*
+   ** Everything the cyclic path touches is allocated by now. Lock it into
+   ** the working set before the driver is started.
+   */
+   HOST_MEMORY_LockImage();
+   HOST_MEMORY_Lock( "process data buffers",
+                     HOST_PD_BUFFER_Read(),
+                     HOST_PD_BUFFER_Span() );
+   HOST_MEMORY_LockStack( "main stack" );
+
+   /*
+   ** The first boot is timed from here, the Transport Provider is started by
+   ** the driver.
+   */
+   if( !HOST_BOOT_Init( sOptions.pacBootReportFile ) )
+   {
+      HOST_IMAGE_Close();
+      HOST_PD_CAPTURE_Close();
+      HOST_PD_BUFFER_Close();
+      HOST_JITTER_CloseCsv();
+      HOST_CONTROL_Stop();
+      return( 1 );
+   }
 
    /*
    ** Function to initialize CompactCom-related systems.
@@ -145,54 +767,184 @@ int main( void )
    */
    if( ABCC_API_Init() != ABCC_EC_NO_ERROR )
    {
+      HOST_BOOT_Close();
+      HOST_IMAGE_Close();
+      HOST_PD_CAPTURE_Close();
+      HOST_PD_BUFFER_Close();
+      HOST_JITTER_CloseCsv();
+      HOST_CONTROL_Stop();
       return( 0 );
    }
 
-   lThen = timeGetTime();
+   if( sOptions.psFaultScenario != NULL )
+   {
+      HOST_FAULT_RunnerStart( sOptions.psFaultScenario, sOptions.lFaultRepetitions );
+   }
+
+   /*
+   ** The wheel and the base the main loop advances it from start at the same
+   ** time, so that the wheel does not lag behind by the time the driver took
+   ** to start.
+   */
+   main_llTimerBaseUs = HOST_TIME_GetUs();
+   HOST_TIMER_Init( main_llTimerBaseUs );
+#if( APPL_CFG_HOST_PERF_ADIS_ENABLED )
+   HOST_TIMER_Start( &main_sHostPerfTimer,
+                     APPL_CFG_HOST_PERF_PERIOD_US,
+                     APPL_CFG_HOST_PERF_PERIOD_US,
+                     UpdateHostPerf,
+                     NULL );
+#endif
+   HOST_TIMER_Start( &main_sMemoryTimer,
+                     HOST_CFG_MEMORY_FAULT_SAMPLE_US,
+                     HOST_CFG_MEMORY_FAULT_SAMPLE_US,
+                     SampleMemoryFaults,
+                     NULL );
+
+   HOST_WAIT_Init( sOptions.lPeriodUs, sOptions.lSpinUs );
+   HOST_BUDGET_Init( sOptions.lBudgetUs );
 
    while( !fQuit  )
    {
+      llNowUs = HOST_TIME_GetUs();
+      HOST_JITTER_Mark( &main_sRunJitter, llNowUs );
+
+#if( HOST_CFG_TRACE_OVERRUN_FACTOR > 0 )
+      /*
+      ** Keep the timeline leading up to the first overrun. The buffer holds
+      ** the most recent events, so it has to be written out now.
+      */
+      if( ( main_pacTraceFile != NULL ) && !fOverrunTraced && ( llLastRunUs != 0 ) &&
+          ( llNowUs - llLastRunUs > (UINT64)sOptions.lPeriodUs * HOST_CFG_TRACE_OVERRUN_FACTOR ) )
+      {
+         printf( "Main loop interval of %lluus, ", (unsigned long long)( llNowUs - llLastRunUs ) );
+         HOST_TRACE_Dump( HOST_CFG_TRACE_OVERRUN_FILE );
+         fOverrunTraced = TRUE;
+         llNowUs = HOST_TIME_GetUs();
+      }
+      llLastRunUs = llNowUs;
+#endif
+
       /*
       ** Primary function start and drive the abcc-api.
       */
+      llTraceNs = HOST_TRACE_Begin();
+      llRunStartUs = HOST_TIME_GetUs();
       eErrorCode = ABCC_API_Run();
+      HOST_TRACE_End( HOST_TRACE_CAT_API, "ABCC_API_Run", llTraceNs, (UINT32)eErrorCode );
+
+      /*
+      ** Recording is paused while the host sheds load.
+      */
+      if( HOST_BUDGET_EndCycle( (UINT32)( HOST_TIME_GetUs() - llRunStartUs ) ) )
+      {
+         fShedding = HOST_BUDGET_IsShedding();
+         HOST_JITTER_PauseCsv( fShedding );
+         HOST_PD_CAPTURE_Pause( fShedding );
+      }
+
+      eAnbState = ABCC_API_AnbState();
+      if( eAnbState != eLastAnbState )
+      {
+         HOST_TRACE_Instant( HOST_TRACE_CAT_STATE, "ANB state", (UINT32)eAnbState );
+         HOST_BOOT_AnbState( eAnbState );
+         eLastAnbState = eAnbState;
+
+         /*
+         ** The network object can be read once the ABCC is past NW_INIT.
+         */
+         if( !main_fNetworkUp &&
+             ( ( eAnbState == ABP_ANB_STATE_WAIT_PROCESS ) ||
+               ( eAnbState == ABP_ANB_STATE_IDLE ) ||
+               ( eAnbState == ABP_ANB_STATE_PROCESS_ACTIVE ) ) )
+         {
+            APPL_TASK_Spawn( NetworkInfoTask, &main_sNetworkInfo );
+            if( sOptions.iBatchCommands > 0 )
+            {
+               StartBatchComparison( sOptions.iBatchCommands );
+            }
+            main_fNetworkUp = TRUE;
+         }
+      }
       /*
       ** Handle potential error codes returned from the abcc-api here.
       */
       if( eErrorCode != ABCC_EC_NO_ERROR )
       {
          printf( "ABCC_API_Run() returned status code: %d\n", eErrorCode );
-         fQuit = TRUE;
+
+         /*
+         ** While a fault scenario runs, errors are expected and the driver is
+         ** restarted so that the recovery can be measured.
+         */
+         if( HOST_FAULT_RunnerHandleError() )
+         {
+            eErrorCode = ABCC_EC_NO_ERROR;
+         }
+         else
+         {
+            fQuit = TRUE;
+         }
       }
       else
       {
-         fQuit = RunUi();
-      }
+         /*
+         ** Hand queued application commands over to the driver, refill the
+         ** windows of running command batches and resume the tasks whose
+         ** responses are in.
+         */
+         APPL_CMDQ_Run();
+         APPL_CMD_BATCH_Run();
+         APPL_TASK_Run();
 
-      lNow = timeGetTime();
-      lDiff = lNow - lThen;
-      if( lDiff > 0 )
-      {
          /*
-         ** Truncate intervals to 65535ms because 'ABCC_API_RunTimerSystem()'
-         ** takes a UINT16.
+         ** Requests from the console control handler, the control pipe and
+         ** the keyboard. This is a plain memory read unless something is
+         ** pending. Statistics and trace requests wait while the host sheds
+         ** load. Quit is handled at once.
          */
-         if( lDiff > (UINT16)0xFFFF )
+         lRequests |= HOST_CONTROL_TakeRequests();
+         if( !sOptions.fHeadless )
+         {
+            lRequests |= RunUi();
+         }
+         fQuit = ( lRequests & HOST_CONTROL_REQ_QUIT ) != 0;
+         if( !HOST_BUDGET_IsShedding() )
          {
-            lDiff = (UINT16)0xFFFF;
+            if( lRequests & HOST_CONTROL_REQ_STATS )
+            {
+               PrintStatistics();
+            }
+            if( ( lRequests & HOST_CONTROL_REQ_TRACE ) && ( main_pacTraceFile != NULL ) )
+            {
+               HOST_TRACE_Dump( main_pacTraceFile );
+            }
+            lRequests = 0;
          }
 
          /*
-         ** Provide the abcc-api with a time base. Required for timers to function.
+         ** A headless fault run ends when all injections are done.
          */
-         ABCC_API_RunTimerSystem( (UINT16)lDiff );
-         lThen = lNow;
+         if( ( sOptions.psFaultScenario != NULL ) &&
+             !HOST_FAULT_RunnerRun( HOST_TIME_GetUs() ) &&
+             sOptions.fHeadless )
+         {
+            fQuit = TRUE;
+         }
       }
 
-      if( iSleepTimeMS > 0 )
+      RunTimers();
+
+      /*
+      ** Wait for the next cycle. Application timers that fall due before it
+      ** are run as they expire.
+      */
+      llTraceNs = HOST_TRACE_Begin();
+      while( !HOST_WAIT_Until( HOST_TIMER_GetNextExpiryUs() ) )
       {
-         Sleep( iSleepTimeMS );
+         RunTimers();
       }
+      HOST_TRACE_End( HOST_TRACE_CAT_HOST, "wait", llTraceNs, 0 );
    }
 
    /*
@@ -202,7 +954,20 @@ int main( void )
 
    TP_Shutdown();
 
-   if( eErrorCode != ABCC_EC_NO_ERROR )
+   if( main_pacTraceFile != NULL )
+   {
+      HOST_TRACE_Dump( main_pacTraceFile );
+   }
+
+   HOST_BOOT_Close();
+   HOST_WAIT_Close();
+   HOST_IMAGE_Close();
+   HOST_PD_CAPTURE_Close();
+   HOST_PD_BUFFER_Close();
+   HOST_JITTER_CloseCsv();
+   HOST_CONTROL_Stop();
+
+   if( ( eErrorCode != ABCC_EC_NO_ERROR ) && !sOptions.fHeadless )
    {
       printf( "Press any key to quit.\n" );
       while( !_kbhit() )